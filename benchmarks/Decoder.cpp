@@ -0,0 +1,141 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "internal/Decoder.hpp"
+
+#include "LegacyDecoders.hpp"
+
+namespace ModbusTechnologyAdapterBenchmarks::DecoderBenchmarks {
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+using namespace Technology_Adapter::Modbus::Config;
+using namespace ModbusTechnologyAdapterTests;
+
+// Compares decoders with the functions they replaced
+TEST(DecoderBenchmarks, againstLegacyDecoders) {
+  using Legacy = double (*)(LegacyDecoders::Registers const&);
+
+  constexpr size_t num_values = 1024;
+  constexpr size_t num_rounds = 1000;
+  std::vector<LegacyDecoders::Registers> values;
+  values.reserve(num_values);
+  for (size_t i = 0; i < num_values; ++i) {
+    values.push_back({(uint16_t)(int16_t)((int)(i % 13) - 6),
+        (uint16_t)(i * 7919), (uint16_t)i});
+  }
+
+  auto measure = [&](char const* name, Legacy legacy, Decoder const& decoder) {
+    // The sums keep the compiler from dropping the decoding
+    double legacy_sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < num_rounds; ++round) {
+      for (auto const& registers : values) {
+        legacy_sum += legacy(registers);
+      }
+    }
+    auto legacy_time = std::chrono::steady_clock::now() - start;
+
+    double sum = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < num_rounds; ++round) {
+      for (auto const& registers : values) {
+        sum += decoder.decodeDouble(registers.data(), registers.size());
+      }
+    }
+    auto time = std::chrono::steady_clock::now() - start;
+
+    using ns = std::chrono::nanoseconds;
+    auto num_decodes = (double)(num_values * num_rounds);
+    std::cout << name << ": "
+              << std::chrono::duration_cast<ns>(legacy_time).count() /
+            num_decodes
+              << " ns before, "
+              << std::chrono::duration_cast<ns>(time).count() / num_decodes
+              << " ns now per decode (sums " << legacy_sum << " and " << sum
+              << ")" << std::endl;
+  };
+
+  measure("linear", LegacyDecoders::linear, Decoder::linear(false, 0.1, 3));
+  measure("mantissa/exponent", LegacyDecoders::mantissaExponent,
+      Decoder::mantissaExponent(false, 10));
+
+  for (size_t i = 0; i < num_values; ++i) {
+    values[i] = {(uint16_t)(i * 7919), 0x4228};
+  }
+  measure("float", LegacyDecoders::ieee754, Decoder::ieee754());
+
+  for (size_t i = 0; i < num_values; ++i) {
+    values[i] = {0x2842, (uint16_t)(i * 7919)};
+  }
+  measure("swapped float", LegacyDecoders::swappedIeee754,
+      Decoder::ieee754(
+          Decoder::ByteOrder::LittleEndian, Decoder::WordOrder::BigEndian));
+}
+
+// Compares a batch over many devices with decoding them one by one
+TEST(DecoderBenchmarks, batchAgainstSingleDecodes) {
+  constexpr size_t num_lanes = 512;
+  constexpr size_t num_rounds = 2000;
+
+  auto measure = [&](char const* name, Decoder const& decoder,
+                     size_t num_registers, uint16_t high_word) {
+    std::vector<uint16_t> per_device(num_lanes * num_registers);
+    std::vector<uint16_t> block(num_lanes * num_registers);
+    for (size_t lane = 0; lane < num_lanes; ++lane) {
+      for (size_t i = 0; i < num_registers; ++i) {
+        auto value = (i + 1 == num_registers)
+            ? high_word
+            : (uint16_t)(lane % 13 + i); // moderate exponents
+        per_device[lane * num_registers + i] = value;
+        block[i * num_lanes + lane] = value;
+      }
+    }
+
+    // The sums keep the compiler from dropping the decoding
+    double single_sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < num_rounds; ++round) {
+      for (size_t lane = 0; lane < num_lanes; ++lane) {
+        single_sum += decoder.decodeDouble(
+            &per_device[lane * num_registers], num_registers);
+      }
+    }
+    auto single_time = std::chrono::steady_clock::now() - start;
+
+    double batch_sum = 0;
+    std::vector<double> values(num_lanes);
+    start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < num_rounds; ++round) {
+      decoder.decodeBatch(
+          {block.data(), num_lanes, num_registers}, values.data());
+      for (auto value : values) {
+        batch_sum += value;
+      }
+    }
+    auto batch_time = std::chrono::steady_clock::now() - start;
+
+    using ns = std::chrono::nanoseconds;
+    auto num_decodes = (double)(num_lanes * num_rounds);
+    std::cout << name << ": "
+              << std::chrono::duration_cast<ns>(single_time).count() /
+            num_decodes
+              << " ns one by one, "
+              << std::chrono::duration_cast<ns>(batch_time).count() /
+            num_decodes
+              << " ns batched per decode (sums " << single_sum << " and "
+              << batch_sum << ")" << std::endl;
+  };
+
+  measure("linear", Decoder::linear(true, 0.1, 3), 2, 7);
+  measure("float", Decoder::ieee754(), 2, 0x4228);
+  measure("double", Decoder::ieee754(), 4, 0x4045);
+  measure("mantissa/exponent", Decoder::mantissaExponent(false, 10), 3, 2);
+}
+
+// NOLINTEND(readability-magic-numbers)
+
+} // namespace ModbusTechnologyAdapterBenchmarks::DecoderBenchmarks
@@ -0,0 +1,141 @@
+#include "../sources/Adapter/MetricTable.hpp"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#if __GLIBC_PREREQ(2, 33)
+#define MODBUS_BENCHMARKS_MALLINFO2
+#endif
+#endif
+
+namespace ModbusTechnologyAdapterBenchmarks::MetricTableBenchmarks {
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+using namespace Technology_Adapter::Modbus;
+
+#ifdef MODBUS_BENCHMARKS_MALLINFO2
+
+/*
+  Compares the memory per metric of the table with the objects that were kept
+  per metric before it. Heap usage is taken from `mallinfo2`, hence glibc 2.33
+  or later is needed.
+*/
+TEST(MetricTableBenchmarks, memory) {
+  constexpr size_t num_devices = 20;
+  constexpr size_t num_readables = 10000; // per device
+
+  std::vector<Config::Device::NonemptyPtr> devices;
+  for (size_t d = 0; d < num_devices; ++d) {
+    std::vector<Config::Readable> readables;
+    readables.reserve(num_readables);
+    for (size_t r = 0; r < num_readables; ++r) {
+      readables.push_back(Config::Readable{
+          ConstString::ConstString("Readable " + std::to_string(r)),
+          ConstString::ConstString(""), Information_Model::DataType::Double,
+          {(int)(2 * r), (int)(2 * r + 1)},
+          Config::Decoder::linear(false, 0.1, 0)});
+    }
+    devices.push_back(Config::Device::NonemptyPtr::make(
+        ConstString::ConstString("Device " + std::to_string(d)),
+        ConstString::ConstString(""), ConstString::ConstString(""),
+        std::move(readables),
+        std::vector<Config::Group>{}, (int)d + 1, 16, 0, 0,
+        std::vector<RegisterRange>{{0, (int)(2 * num_readables - 1)}},
+        std::vector<RegisterRange>{}, std::nullopt));
+  }
+  auto bus = Config::Bus::NonemptyPtr::make(std::vector<Config::Portname>{},
+      9600, LibModbus::Parity::None, 8, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+      std::move(devices));
+  auto bus_handle = std::make_shared<int>(); // in place of the `Bus`
+
+  auto metric_id = [](Config::Device const& device, size_t r) {
+    return std::string((std::string_view)device.id) + ":Readable " +
+        std::to_string(r);
+  };
+  auto in_use = []() { return mallinfo2().uordblks; };
+  using Callback = std::function<Information_Model::DataVariant()>;
+
+  // As before: a callback with a copy of the readable, its own plan, memo,
+  // and id, and the bus' map of memos and caches
+  struct Legacy {
+    std::shared_ptr<int> bus;
+    Config::Device::NonemptyPtr device;
+    std::shared_ptr<std::string> metric_id;
+    Config::Readable readable;
+    std::shared_ptr<BurstPlan> plan;
+    std::shared_ptr<DecodeMemo> memo;
+
+    Information_Model::DataVariant operator()() const { return 0.0; }
+  };
+  struct LegacyMetric {
+    std::shared_ptr<DecodeMemo> memo;
+    std::shared_ptr<ReadCache> cache;
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  size_t before = in_use();
+  {
+    std::vector<Callback> callbacks;
+    std::map<std::string, LegacyMetric> metrics;
+    for (auto const& device : bus->devices) {
+      for (size_t r = 0; r < device->readables.size(); ++r) {
+        auto const& readable = device->readables[r];
+        auto memo = std::make_shared<DecodeMemo>(readable.registers.size());
+        auto id = std::make_shared<std::string>(metric_id(*device, r));
+        callbacks.emplace_back(Legacy{bus_handle, device, id, readable,
+            std::make_shared<BurstPlan>(readable.registers,
+                device->holding_registers, device->input_registers,
+                device->burst_size),
+            memo});
+        metrics.insert_or_assign(*id, LegacyMetric{memo, nullptr});
+      }
+    }
+    size_t legacy_bytes = in_use() - before;
+    auto legacy_time = std::chrono::steady_clock::now() - start;
+
+    callbacks.clear();
+    callbacks.shrink_to_fit();
+    metrics.clear();
+    start = std::chrono::steady_clock::now();
+    before = in_use();
+    MetricTable table(*bus);
+    for (MetricTable::Handle handle = 0; handle < table.size(); ++handle) {
+      callbacks.emplace_back(
+          [bus_handle, handle]() -> Information_Model::DataVariant {
+            return (double)handle;
+          });
+    }
+    size_t handle = 0;
+    for (auto const& device : bus->devices) {
+      for (size_t r = 0; r < device->readables.size(); ++r) {
+        table.identify(handle++, metric_id(*device, r));
+      }
+    }
+    size_t table_bytes = in_use() - before;
+    auto table_time = std::chrono::steady_clock::now() - start;
+
+    auto num_metrics = (double)table.size();
+    using ms = std::chrono::milliseconds;
+    std::cout << table.size() << " metrics: " << legacy_bytes / num_metrics
+              << " bytes per metric in "
+              << std::chrono::duration_cast<ms>(legacy_time).count()
+              << " ms before, " << table_bytes / num_metrics
+              << " bytes per metric in "
+              << std::chrono::duration_cast<ms>(table_time).count()
+              << " ms now" << std::endl;
+  }
+}
+
+#endif // MODBUS_BENCHMARKS_MALLINFO2
+
+// NOLINTEND(readability-magic-numbers)
+
+} // namespace ModbusTechnologyAdapterBenchmarks::MetricTableBenchmarks
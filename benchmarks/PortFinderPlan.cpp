@@ -0,0 +1,37 @@
+#include "gtest/gtest.h"
+
+#include "internal/PortFinderPlan.hpp"
+
+#include "Specs.hpp"
+
+#include <chrono>
+#include <iostream>
+
+namespace ModbusTechnologyAdapterBenchmarks::PortFinderPlanBenchmarks {
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+using namespace Technology_Adapter::Modbus;
+using namespace ModbusTechnologyAdapterTests;
+
+// Many buses with overlapping slave ids spread over many ports
+TEST(PortFinderPlanBenchmarks, addBuses) {
+  constexpr size_t num_buses = 5000;
+  constexpr size_t num_ports = 200;
+
+  auto buses = SpecsForTests::manyBuses(num_buses, num_ports);
+  auto plan = PortFinderPlan::make();
+
+  auto start = std::chrono::steady_clock::now();
+  auto candidates = plan->addBuses(buses);
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  std::cout << "Adding " << num_buses << " buses over " << num_ports
+            << " ports took " << elapsed.count() << " ms and yielded "
+            << candidates.size() << " candidates" << std::endl;
+}
+
+// NOLINTEND(readability-magic-numbers)
+
+} // namespace ModbusTechnologyAdapterBenchmarks::PortFinderPlanBenchmarks
@@ -45,4 +45,17 @@ void error(
   log(logger, HaSLL::SeverityLevel::Error, std::forward<Args>(args)...);
 }
 
+inline Stopwatch::Stopwatch() noexcept
+    : start_(std::chrono::steady_clock::now()) {}
+
+inline double Stopwatch::elapsedMs() const noexcept {
+  return std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start_)
+      .count();
+}
+
+inline void Stopwatch::restart() noexcept {
+  start_ = std::chrono::steady_clock::now();
+}
+
 } // namespace Technology_Adapter::Modbus::Logging
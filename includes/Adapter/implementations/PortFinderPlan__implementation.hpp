@@ -1,7 +1,7 @@
 
+#include <map>
 #include <optional>
 
-#include "Index/MemoizedFunction.hpp"
 #include "Index/Set.hpp"
 
 namespace Technology_Adapter::Modbus {
@@ -10,9 +10,6 @@ namespace Internal_ {
 
 class GlobalBusIndexingTag {};
 
-using GlobalBusIndexingParameters =
-    std::tuple<Config::Bus::NonemptyPtr, Internal_::GlobalBusIndexingTag>;
-
 using GlobalBusIndexing =
     Index::Indexing<Config::Bus::NonemptyPtr, GlobalBusIndexingTag>;
 
@@ -20,6 +17,22 @@ template <class T>
 using GlobalBusMap =
     Index::Map<Config::Bus::NonemptyPtr, T, GlobalBusIndexingTag>;
 
+/*
+  The devices of a `Bus`, grouped by slave id and sorted by it.
+
+  This, together with the devices' registers and identifications, is what
+  decides whether buses ambiguate each other. Comparing two signatures is a
+  single merge over the slave ids instead of comparing all pairs of devices.
+*/
+struct BusSignature {
+  using Devices = std::vector<Config::Device::NonemptyPtr>;
+
+  std::vector<std::pair<int, Devices>> devices_by_slave_id;
+
+  BusSignature() = default;
+  BusSignature(Config::Bus const&);
+};
+
 } // namespace Internal_
 
 // The data that `PortFinderPlan` stores per port
@@ -45,6 +58,22 @@ struct PortFinderPlan::Port {
   // maps local buses to other local buses which they ambiguate
   PortBusMap<std::vector<PortFinderPlan::PortBusIndexing::Index>> ambiguated;
 
+  /*
+    Local buses by the slave ids of their devices.
+
+    A bus can only ambiguate buses whose slave ids are all among its own.
+    These indices let `addBus` look only at such buses rather than at all
+    buses of the port:
+    - `buses_by_slave_id` lists each bus under each of its slave ids
+    - `buses_by_least_slave_id` lists each bus under its least slave id only
+    - `buses_without_devices` lists the buses which have no slave id at all
+  */
+  std::map<int, std::vector<PortFinderPlan::PortBusIndexing::Index>>
+      buses_by_slave_id;
+  std::map<int, std::vector<PortFinderPlan::PortBusIndexing::Index>>
+      buses_by_least_slave_id;
+  std::vector<PortFinderPlan::PortBusIndexing::Index> buses_without_devices;
+
   // The bus (if any) that is currently assigned to the port
   std::optional<PortFinderPlan::PortBusIndexing::Index> assigned;
 
@@ -64,6 +93,22 @@ struct PortFinderPlan::Port {
   */
   PortBusMap<size_t> num_ambiguators; // counts only available ones
 
+  /*
+    Per `Bus`, the published value of `feasible`, shared with its `Candidate`s.
+
+    Changes of `assigned`, `available`, or `num_ambiguators` are published
+    only once the respective operation of `PortFinderPlan` is complete. This
+    way, readers never observe intermediate states.
+  */
+  PortBusMap<PortFinderPlan::FeasibilityPtr> feasibility;
+  bool feasibility_outdated = false; // see `PortFinderPlan::markOutdated`
+
+  /*
+    Per `Bus`, memoized result of `PortFinderPlan::probes`.
+    Depends on all buses of the port, hence is cleared by `addBus`.
+  */
+  PortBusMap<std::optional<PortFinderPlan::Probes>> probes;
+
   Port(GlobalDataPtr const&);
 
   Internal_::GlobalBusIndexing::Index globalBusIndex(
@@ -72,27 +117,55 @@ struct PortFinderPlan::Port {
   // Returns the local index of the new bus
   PortFinderPlan::PortBusIndexing::Index addBus(
       Internal_::GlobalBusIndexing::Index);
+
+  /*
+    It is feasible to search for `bus` on this port, if
+    - No bus is currently assigned to this port,
+    - `bus` is currently assigned to no port, and
+    - `bus` is not ambiguous on this port
+  */
+  bool feasible(PortFinderPlan::PortBusIndexing::Index bus) const;
+
+  // Stores `feasible` into `feasibility` for all buses
+  void publishFeasibility();
+
+private:
+  // Records that `ambiguator` ambiguates `bus`, if it does
+  void checkAmbiguation(PortFinderPlan::PortBusIndexing::Index ambiguator,
+      PortFinderPlan::PortBusIndexing::Index bus);
 };
 
 // The data that `PortFinderPlan` stores just once
 struct PortFinderPlan::GlobalData {
   using BusIndexing =
       Nonempty::Pointer<std::shared_ptr<Internal_::GlobalBusIndexing>>;
-  using BinaryBusPredicate = Index::MemoizedFunction<bool, //
-      Internal_::GlobalBusIndexingParameters,
-      Internal_::GlobalBusIndexingParameters>;
   using Incidence = std::pair< // describes a potential assignment port->bus
       PortFinderPlan::PortIndexing::Index,
       PortFinderPlan::PortBusIndexing::Index>;
 
   BusIndexing bus_indexing;
   PortIndexing port_indexing;
-  BinaryBusPredicate const ambiguates;
+
+  // computed once per `Bus` by `addBus`
+  Internal_::GlobalBusMap<Internal_::BusSignature> signatures;
 
   // maps `Bus`es (global index) to `Incidence`s (local index) of that `Bus`
   Internal_::GlobalBusMap<std::vector<Incidence>> possible_ports;
 
   GlobalData();
+
+  Internal_::GlobalBusIndexing::Index addBus(Config::Bus::NonemptyPtr const&);
+
+  /*
+    Whether a search for `bus` might have `ambiguator` as a false positive.
+    In that case, we need to search for `ambiguator` first.
+  */
+  bool ambiguates(Internal_::GlobalBusIndexing::Index ambiguator,
+      Internal_::GlobalBusIndexing::Index bus) const;
+
+  // Like `ambiguates`, but disregarding the devices' identifications
+  bool ambiguatesByRegisters(Internal_::GlobalBusIndexing::Index ambiguator,
+      Internal_::GlobalBusIndexing::Index bus) const;
 };
 
 } // namespace Technology_Adapter::Modbus
@@ -1,13 +1,20 @@
 #ifndef _MODBUS_TECHNOLOGY_ADAPTER_BUS_HPP
 #define _MODBUS_TECHNOLOGY_ADAPTER_BUS_HPP
 
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
 #include "Nonempty/Pointer.hpp"
 #include "Technology_Adapter_Interface/TechnologyAdapterInterface.hpp"
+#include "Threadsafe_Containers/PrivateResource.hpp"
 #include "Threadsafe_Containers/QueuedMutex.hpp"
 #include "Threadsafe_Containers/SharedPtr.hpp"
 
 #include "Config.hpp"
 #include "Modbus.hpp"
+#include "ReadCache.hpp"
 #include "ModbusTechnologyAdapterInterface.hpp"
 
 namespace Technology_Adapter {
@@ -16,6 +23,8 @@ class ModbusTechnologyAdapter;
 
 namespace Technology_Adapter::Modbus {
 
+class MetricTable;
+
 /**
  * @brief A Modbus bus
  *
@@ -29,30 +38,88 @@ class Bus : public Threadsafe::EnableSharedFromThis<Bus> {
 public:
   using NonemptyPtr = Nonempty::Pointer<Threadsafe::SharedPtr<Bus>>;
 
+  /// A `DeviceBuilderInterface` may only build one device at a time
+  using DeviceBuilderResource =
+      Threadsafe::PrivateResource<Information_Model::DeviceBuilderInterfacePtr>;
+
+  /**
+   * @brief Identifies a readable of the configured devices
+   *
+   * Readables are numbered from `0`, device by device, and within each group
+   * first its readables, then its subgroups.
+   */
+  using MetricHandle = uint32_t;
+
   /**
    * During the lifetime of `this`, `owner->cancelBus` is called at most once
    * from this `Bus`; namely following a change of `connected` from `true` to
    * `false` except from `stop`.
    *
+   * @param connection If not `nullptr`, an open context for the port. It is
+   *   reconfigured for normal operation and used instead of a new context
+   *   from the factory, which saves reopening the port.
    * @throws `std::bad_alloc`.
    * @throws `ModbusError`.
+   * @throws `std::runtime_error` if the registers of some readable cannot be
+   *   read in bursts from its device
    * @pre The lifetime of `*this` is included in the lifetime of `owner`
    * @post `!connected`
    */
   Bus(ModbusTechnologyAdapterInterface& owner, Config::Bus::NonemptyPtr const&,
       ModbusContext::Factory const&, Config::Portname const&,
-      Technology_Adapter::NonemptyDeviceRegistryPtr const&);
+      Technology_Adapter::NonemptyDeviceRegistryPtr const&,
+      ModbusContext::Ptr const& connection);
 
   ~Bus() noexcept;
 
   /**
    * @brief Establishes a connection and registers all devices
    *
+   * Constants are read while their devices are registered. Unless
+   * `verification` is `None`, the bus is verified before the first of them.
+   * With `Eager`, it is verified at the end if there was no constant.
+   *
+   * @pre `!connected`
+   * @post `connected`
+   * @throws `std::runtime_error`, also if verification fails
+   */
+  void start(Information_Model::NonemptyDeviceBuilderInterfacePtr const&,
+      Verification verification = Verification::None);
+
+  /**
+   * @brief Like the above, but suitable for concurrent `start`s
+   *
+   * The builder is locked only while a single device is built. Connecting and
+   * registering happen without the lock. Hence several `Bus`es may share the
+   * same `device_builder`.
+   *
+   * @pre The value of `device_builder` is non-empty
    * @pre `!connected`
    * @post `connected`
    * @throws `std::runtime_error`
    */
-  void start(Information_Model::NonemptyDeviceBuilderInterfacePtr const&);
+  void start(DeviceBuilderResource& device_builder,
+      Verification verification = Verification::None);
+
+  /**
+   * @brief Confirms that the configured devices are present
+   *
+   * Reads each configured register once, with retries as configured per
+   * device. If that fails, the bus is aborted, i.e., all devices are
+   * deregistered and `owner->cancelBus` is called.
+   * Does nothing if `!connected`, e.g., after a concurrent `stop`.
+   *
+   * @throws `std::runtime_error` if verification fails
+   */
+  void verify();
+
+  /**
+   * @brief Like `verify`, but deferred until the first read of a metric
+   *
+   * That read fails if verification fails.
+   * Does nothing if `!connected`.
+   */
+  void verifyOnFirstRead();
 
   /**
    * @brief Closes the connection and deregisters all devices
@@ -62,15 +129,61 @@ public:
    */
   void stop();
 
+  /**
+   * @brief How often the raw registers of a metric have changed
+   *
+   * Counts the reads through the registered callback that saw other register
+   * values than the read before, including the first read. A consumer may
+   * skip publishing a metric whose count has not changed. Unlike
+   * `getMetricValue`, this does not access the bus.
+   *
+   * @returns `0` if `metric_id` is not registered by `this`
+   */
+  uint64_t changeCount(std::string const& metric_id);
+
+  /**
+   * @brief How often a metric was served from its cache, and how often not
+   *
+   * @returns zeros if `metric_id` is not registered by `this` or its
+   *   `CachePolicy` is `None`
+   */
+  ReadCache::Counters cacheCounters(std::string const& metric_id);
+
+  /**
+   * @brief The callback through which `start` registers the readable `handle`
+   *
+   * Each call reads the registers of the readable from the bus and decodes
+   * them only if they have changed since the previous call. Calls are served
+   * from the cache as far as the readable's `CachePolicy` permits. The
+   * callback carries nothing but `this` and `handle`.
+   *
+   * Each call reads into a `BurstBuffer` of its own and decodes after
+   * releasing the bus. Hence concurrent calls share nothing but the bus and
+   * the decoding memo. Once the bus is verified and the callback has run on
+   * the calling thread, a call allocates memory only in order to throw.
+   *
+   * Only for internal use, yet public for testing purposes.
+   *
+   * @pre `handle` identifies a readable of the configured devices
+   */
+  std::function<Information_Model::DataVariant()> readCallback(
+      MetricHandle handle);
+
 private:
   struct Connection {
     ModbusContext::Ptr context;
     bool connected = false;
+    bool verified = true; // see `start` and `verifyOnFirstRead`
+
+    // `context` has been handed over already connected, `start` need not
+    // connect it. Invariant: `false` if `connected`
+    bool handed_over;
 
     // Invariant: empty unless `connected`
     std::vector<ConstString::ConstString> devices_to_deregister;
 
-    Connection(ModbusContext::Ptr&& context_) : context(std::move(context_)) {}
+    Connection(ModbusContext::Ptr&& context_, bool handed_over_)
+        : context(std::move(context_)), handed_over(handed_over_) {}
   };
 
   using ConnectionResource =
@@ -80,20 +193,24 @@ private:
   // This method is local to `start`
   // @pre `connected`
   // @throws `std::runtime_error`
-  void buildModel(Information_Model::NonemptyDeviceBuilderInterfacePtr const&);
+  void buildModel(DeviceBuilderResource&);
+
+  using ReadCallback = std::function<Information_Model::DataVariant()>;
 
   // This recursive method is local to `buildModel`.
+  // `next_handle` is the handle of the first readable of `group` and is
+  // advanced past all readables of `group`, including subgroups.
+  // Adds the callbacks of readables with `CachePolicy::Constant` to
+  // `constant_reads`, to be called once before the device is registered.
   // @throws `std::bad_alloc`
   // @throws `std::runtime_error`
   // @pre lifetime of `group` is contained in lifetime of `this`
   void buildGroup( //
       Information_Model::NonemptyDeviceBuilderInterfacePtr const&,
       std::string const& group_id, // for `DeviceBuilderInterface`, "" for root
-      NonemptyPtr const& shared_this,
-      Config::Device::NonemptyPtr const&, //
-      RegisterSet const& holding_registers, //
-      RegisterSet const& input_registers, //
-      Config::Group const&);
+      Config::Group const&, //
+      MetricHandle& next_handle, //
+      std::vector<ReadCallback>& constant_reads);
 
   /*
     - Closes the connection
@@ -101,6 +218,10 @@ private:
   */
   void stop(ConnectionResource::ScopedAccessor&);
 
+  // @pre `connected`
+  // @throws `std::runtime_error` if verification fails
+  void verify(ConnectionResource::ScopedAccessor&);
+
   /*
     Called upon communication failure.
     - Closes the connection
@@ -119,6 +240,8 @@ private:
   Technology_Adapter::NonemptyDeviceRegistryPtr const model_registry_;
   ConnectionResource connection_;
 
+  std::unique_ptr<MetricTable> const metrics_;
+
   friend struct Readcallback;
 };
 
@@ -5,13 +5,16 @@
  * This module defines the data types for configuration of the Modbus TA.
  */
 
-#include <functional>
+#include <optional>
+#include <string>
+#include <tuple>
 
 #include <Const_String/ConstString.hpp>
 #include <Information_Model/DataVariant.hpp>
 #include <Nonempty/Pointer.hpp>
 #include <Threadsafe_Containers/SharedPtr.hpp>
 
+#include "Decoder.hpp"
 #include "LibmodbusAbstraction.hpp"
 #include "RegisterSet.hpp"
 
@@ -19,6 +22,20 @@ namespace Technology_Adapter::Modbus::Config {
 
 using Portname = ConstString::ConstString;
 
+/**
+ * @brief When a `Readable` may be served without reading the bus
+ */
+struct CachePolicy {
+  enum class Kind : uint8_t {
+    None, /// every read accesses the bus
+    Ttl, /// values are reused for `ttl_ms` after they were read
+    Constant, /// the value is read once, at registration
+  };
+
+  Kind kind = Kind::None;
+  size_t ttl_ms = 0; /// only for `Ttl`
+};
+
 /**
  * @brief Represents a readable Modbus metric
  *
@@ -34,14 +51,15 @@ struct Readable {
   std::vector<int> const registers;
 
   /**
-   * @pre The `vector` has the same length as `registers`
+   * @pre Called with as many register values as `registers` has entries
    * @post The `DataVariant` conforms to `type`
    */
-  using Decoder = std::function<Information_Model::DataVariant(
-      std::vector<uint16_t> const&)>;
+  using Decoder = Config::Decoder;
 
   Decoder const decode;
 
+  CachePolicy const cache = {};
+
   Readable() = delete;
 };
 
@@ -57,6 +75,26 @@ struct Group {
   Group() = delete;
 };
 
+/**
+ * @brief What a device is expected to report about itself
+ *
+ * Empty strings match anything.
+ */
+struct Identification {
+  ConstString::ConstString const vendor;
+  ConstString::ConstString const product;
+  ConstString::ConstString const revision;
+
+  /**
+   * @brief Whether `reported` is as expected
+   *
+   * For Read Device Identification, the reported strings must equal the
+   * expected ones. For Report Server ID, which has no fixed format, each
+   * expected string must occur in the reported server ID.
+   */
+  bool matches(LibModbus::DeviceIdentification const& reported) const;
+};
+
 /**
  * @brief Represents a Modbus slave as an `Information_Model::Device`
  */
@@ -95,13 +133,25 @@ struct Device : public Group {
    */
   RegisterSet const input_registers;
 
+  /**
+   * @brief How port detection may recognize the device by a single request
+   *
+   * If set, port detection asks the device to identify itself rather than
+   * reading its registers. Only devices which support neither Read Device
+   * Identification nor Report Server ID have their registers read. Where
+   * registers cannot tell the bus from another one, see
+   * `PortFinderPlan::Probes::identification_required`.
+   */
+  std::optional<Identification> const identification;
+
   Device() = delete;
   Device(ConstString::ConstString id, ConstString::ConstString name,
       ConstString::ConstString description, //
       std::vector<Readable> readables, std::vector<Group> subgroups,
       int slave_id, size_t burst_size, size_t max_retries, size_t retry_delay,
       std::vector<RegisterRange> const& holding_registers,
-      std::vector<RegisterRange> const& input_registers);
+      std::vector<RegisterRange> const& input_registers,
+      std::optional<Identification> identification);
 };
 
 /**
@@ -161,6 +211,33 @@ struct Bus {
    */
   size_t inter_device_delay_when_running;
 
+  /**
+   * @brief Response timeout during bus detection
+   *
+   * The max time (in µs) to wait for a response. During bus detection, most
+   * requests go to the wrong port or use the wrong settings and hence cost a
+   * full timeout. A timeout shorter than in normal operation thus speeds the
+   * search up. `0` keeps the libmodbus default.
+   *
+   * In case a device is too slow for it, the timeout doubles with each round
+   * of the search up to `max_response_timeout_when_searching`.
+   */
+  size_t response_timeout_when_searching;
+
+  /**
+   * @brief Upper bound (in µs) of the response timeout during bus detection
+   *
+   * Values up to `response_timeout_when_searching` disable the doubling.
+   */
+  size_t max_response_timeout_when_searching;
+
+  /**
+   * @brief Timeout between two bytes of a response during bus detection
+   *
+   * In µs. `0` keeps the libmodbus default.
+   */
+  size_t byte_timeout_when_searching;
+
   std::vector<Device::NonemptyPtr> const devices;
 
   /// @brief Composite of `devices`' IDs for the purpose of, e.g., logging
@@ -173,11 +250,92 @@ struct Bus {
       size_t inter_use_delay_when_running,
       size_t inter_device_delay_when_searching,
       size_t inter_device_delay_when_running,
+      size_t response_timeout_when_searching,
+      size_t max_response_timeout_when_searching,
+      size_t byte_timeout_when_searching,
       std::vector<Device::NonemptyPtr> devices);
 };
 
 using Buses = std::vector<Bus::NonemptyPtr>;
 
+/**
+ * @brief The settings of a `Bus` which are fixed when opening a serial port
+ *
+ * Namely baud, parity, data bits, stop bits, and RTS delay
+ */
+using SerialSettings = std::tuple<int, LibModbus::Parity, int, int, int>;
+
+SerialSettings serialSettings(Bus const&);
+
+/**
+ * @brief Settings for port auto detection which apply to all `Bus`es
+ */
+struct PortDetection {
+  /// @brief Max number of ports that are probed at the same time
+  size_t max_concurrent_probes = 4;
+
+  /**
+   * @brief File in which bus-to-port assignments are kept across restarts
+   *
+   * Assignments found there are tried before any search. Empty means that
+   * assignments are not kept.
+   */
+  std::string state_file;
+
+  /**
+   * @brief Whether uncontested buses skip the search
+   *
+   * A bus is uncontested if it has just one possible port and no other bus
+   * lists that port. If set, such a bus is registered right away and verified
+   * upon the first read of any of its metrics.
+   */
+  bool direct_connect = false;
+
+  /**
+   * @brief Whether directories of device nodes are watched for hot-plugging
+   *
+   * If set, searching on a port pauses while its device node is missing.
+   * Otherwise, and for directories which cannot be watched, missing nodes are
+   * polled for. Glob patterns in `possible_serial_ports` match nodes that
+   * appear later only if their directory is watched.
+   */
+  bool watch_hotplug = true;
+
+  /**
+   * @brief Back-off (in ms) of a candidate after an unsuccessful attempt
+   *
+   * The back-off doubles with each further unsuccessful attempt of the same
+   * candidate, up to `backoff_max`. It is reset when a device node appears.
+   */
+  size_t backoff_initial = 100;
+
+  /// @brief Upper bound (in ms) of back-offs
+  size_t backoff_max = 10000;
+
+  /**
+   * @brief Relative random shortening of back-offs
+   *
+   * Each back-off is chosen uniformly between `1 - backoff_jitter` times and
+   * `1` times its nominal value. Must be between `0` and `1`.
+   */
+  double backoff_jitter = 0.25;
+
+  /**
+   * @brief Min time (in ms) between starts of two attempts on the same port
+   *
+   * `0` means that attempts may follow each other back to back.
+   */
+  size_t min_attempt_interval = 0;
+};
+
+/**
+ * @brief The complete configuration of a Modbus TA
+ */
+struct Adapter {
+  Buses buses;
+  PortDetection port_detection;
+};
+
 } // namespace Technology_Adapter::Modbus::Config
 
 #endif // _MODBUS_TECHNOLOGY_ADAPTER_CONFIG_HPP
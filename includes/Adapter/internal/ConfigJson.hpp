@@ -3,8 +3,16 @@
 
 /**
  * This module provides parsing of `Config::` types from JSON
+ *
+ * All parts of what a single call parses share equal strings and equal
+ * decoders, and vectors of children are allocated at their exact size. Hence
+ * large configurations take few allocations.
  */
 
+#include <map>
+#include <optional>
+#include <string>
+
 #include <nlohmann/json.hpp>
 
 #include "Config.hpp"
@@ -13,6 +21,14 @@ namespace Technology_Adapter::Modbus::Config {
 
 using json = nlohmann::json;
 
+/**
+ * @brief The non-derived readables of a device, by name
+ *
+ * Derived readables refer to these. A name that several readables share
+ * maps to `std::nullopt`, as it is ambiguous.
+ */
+using ReadablesByName = std::map<std::string, std::optional<Readable>>;
+
 /**
  * @brief Parse a `Parity` from JSON
  *
@@ -47,17 +63,24 @@ struct TypedDecoder {
  * `"type"` has value `"linear"` and there are further fields:
  * - optionally `"signed"` of JSON type `boolean` with default `false`
  * - optionally `"factor"` of JSON type `number` with default `1`
- * - optionally `"offset"` of JSON type `number` with default `0`.
- * The decoder converts the given registers to a signd or unsigned integer in a
- * little endian way and then applies the given linear transformation.
+ * - optionally `"offset"` of JSON type `number` with default `0`
+ * - optionally `"byte_order"` and `"word_order"` as below.
+ * The decoder converts the given registers to a signd or unsigned integer in
+ * the given order and then applies the given linear transformation.
  *
  * `"type"` has value `"float"` and there are exactly two registers.
- * The decoder treats the registers as an IEEE 754 Single, given in little
- * endian.
+ * The decoder treats the registers as an IEEE 754 Single, given in the order
+ * given by the optional fields `"byte_order"` and `"word_order"` as below.
  *
  * `"type"` has value `"float"` and there are exactly four registers.
- * The decoder treats the registers as an IEEE 754 Double, given in little
- * endian.
+ * The decoder treats the registers as an IEEE 754 Double, given in the order
+ * given by the optional fields `"byte_order"` and `"word_order"` as below.
+ *
+ * `"byte_order"` is the order of the bytes within each register. It has value
+ * `"big_endian"` (the default, as specified by Modbus) or `"little_endian"`.
+ * `"word_order"` is the order of the registers. It has value `"little_endian"`
+ * (the default, the first register is least significant) or `"big_endian"`.
+ * Both are resolved when the decoder is parsed, not when it decodes.
  *
  * `"type"` has value `"mantissa/exponent"`, there is at least one register, and
  * there are further fields:
@@ -73,20 +96,39 @@ struct TypedDecoder {
  */
 TypedDecoder DecoderOfJson(json const& json);
 
+/**
+ * @brief Parse a `CachePolicy` from JSON
+ *
+ * `json` is expected to be `"none"`, `"constant"`, or a JSON object with a
+ * field `"ttl_ms"` of JSON type `number`.
+ *
+ * @throws `std::runtime_error
+ * @throws whatever `nlohmann/json` throws
+ */
+CachePolicy CachePolicyOfJson(json const& json);
+
 /**
  * @brief Parse a `Readable` from JSON
  *
  * `json` is expected to be a JSON object with fields
  * - `"name"` and `"description"` of JSON type `string`
- * - `"registers"` of JSON type `array` with entries of JSON type `number`
- * - `"decoder"` as expected by `DecoderOfJson`
+ * - either
+ *   - `"registers"` of JSON type `array` with entries of JSON type `number`
+ *     and `"decoder"` as expected by `DecoderOfJson`, or
+ *   - `"expression"` of JSON type `string` as expected by
+ *     `Expression::compile`. Names in the expression refer to
+ *     `device_readables`. This makes a derived readable of type `Double`
+ *     whose registers are all registers the expression depends on.
+ * - optionally `"cache"` as expected by `CachePolicyOfJson` with default
+ *   `"none"`
  *
  * The `Readable::type` is implicit from the decoder.
  *
  * @throws `std::runtime_error
  * @throws whatever `nlohmann/json` throws
  */
-Readable ReadableOfJson(json const& json);
+Readable ReadableOfJson(
+    json const& json, ReadablesByName const& device_readables = {});
 
 /**
  * @brief Parse a `Group` from JSON
@@ -101,10 +143,25 @@ Readable ReadableOfJson(json const& json);
  *   - The field has value `group` and the object is as expected by this
  *     function
  *
+ * Derived readables refer to `device_readables`.
+ *
  * @throws `std::runtime_error
  * @throws whatever `nlohmann/json` throws
  */
-Group GroupOfJson(json const& json);
+Group GroupOfJson(
+    json const& json, ReadablesByName const& device_readables = {});
+
+/**
+ * @brief Parse an `Identification` from JSON
+ *
+ * `json` is expected to be a JSON object with fields
+ * - optionally `"vendor"`, `"product"`, and `"revision"` of JSON type
+ *   `string`, each with default `""`. At least one of them must be nonempty.
+ *
+ * @throws `std::runtime_error
+ * @throws whatever `nlohmann/json` throws
+ */
+Identification IdentificationOfJson(json const& json);
 
 /**
  * @brief Parse a `Device` from JSON
@@ -114,6 +171,7 @@ Group GroupOfJson(json const& json);
  * - `"slave_id"` and `"burst_size"` of JSON type `number`
  * - optionally `max_retries` of JSON type `number` with default `3`
  * - optionally `retry_delay` of JSON type `number` with default `0`
+ * - optionally `"identification"` as expected by `IdentificationOfJson`
  * - `"holding_registers"` and `"input_registers"` of JSON type `array` with
  *    entries as expected by `RegisterRangeOfJson`
  * - `elements` of JSON type `array`.
@@ -124,6 +182,9 @@ Group GroupOfJson(json const& json);
  *   - The field has value `group` and the object is as expected by
  *     `GroupOfJson`
  *
+ * Derived readables may refer to all non-derived readables of the device, in
+ * any group.
+ *
  * @throws `std::runtime_error
  * @throws whatever `nlohmann/json` throws
  */
@@ -134,11 +195,13 @@ Device::NonemptyPtr DeviceOfJson(json const& json);
  *
  * `json` is expected to be a JSON object with fields
  * - `"possible_serial_ports"` of JSON type `array` with entries of JSON type
- *   `string`
+ *   `string`. Entries may be glob patterns like `/dev/ttyUSB*`.
  * - `"baud"`, `"data_bits"`, `"stop_bits"` of JSON type `number`
  * - optionally `"rts_delay"`, `"inter_use_delay_when_searching"`,
- *   `"inter_use_delay_when_running"`, `"inter_device_delay_when_searching"` and
- *   `"inter_device_delay_when_running"` of JSON type `number`.
+ *   `"inter_use_delay_when_running"`, `"inter_device_delay_when_searching"`,
+ *   `"inter_device_delay_when_running"`, `"response_timeout_when_searching"`,
+ *   `"max_response_timeout_when_searching"` and
+ *   `"byte_timeout_when_searching"` of JSON type `number`.
  *   Each default is `0`.
  * - `"parity"` as expected by `ParityOfJson`
  * - `"devices"` of JSON type `array` with entries as expected by `DeviceOfJson`
@@ -159,12 +222,46 @@ Bus::NonemptyPtr BusOfJson(json const& json);
 Buses BusesOfJson(json const& json);
 
 /**
- * @brief Applies `BusesOfJson` to the contents of the file at `file_path`
+ * @brief Parse a `PortDetection` from JSON
+ *
+ * `json` is expected to be a JSON object with fields
+ * - optionally `"max_concurrent_probes"` of JSON type `number` with default
+ *   `4`. It must be positive.
+ * - optionally `"state_file"` of JSON type `string` with default `""`
+ * - optionally `"direct_connect"` of JSON type `boolean` with default `false`
+ * - optionally `"watch_hotplug"` of JSON type `boolean` with default `true`
+ * - optionally `"backoff_initial"` of JSON type `number` with default `100`
+ * - optionally `"backoff_max"` of JSON type `number` with default `10000`
+ * - optionally `"backoff_jitter"` of JSON type `number` with default `0.25`
+ * - optionally `"min_attempt_interval"` of JSON type `number` with default `0`
+ *
+ * @throws `std::runtime_error
+ * @throws whatever `nlohmann/json` throws
+ */
+PortDetection PortDetectionOfJson(json const& json);
+
+/**
+ * @brief Parse an `Adapter` from JSON
+ *
+ * `json` is expected to be one of
+ * - a JSON array as expected by `BusesOfJson`. The `PortDetection` settings
+ *   then have their defaults.
+ * - a JSON object with fields
+ *   - `"buses"` as expected by `BusesOfJson`
+ *   - optionally `"port_detection"` as expected by `PortDetectionOfJson`
+ *
+ * @throws `std::runtime_error
+ * @throws whatever `nlohmann/json` throws
+ */
+Adapter AdapterOfJson(json const& json);
+
+/**
+ * @brief Applies `AdapterOfJson` to the contents of the file at `file_path`
  *
  * @throws `std::runtime_error
  * @throws whatever `nlohmann/json` throws
  */
-Buses loadConfig(ConstString::ConstString const& file_path);
+Adapter loadConfig(ConstString::ConstString const& file_path);
 
 } // namespace Technology_Adapter::Modbus::Config
 
@@ -0,0 +1,69 @@
+#ifndef _MODBUS_TECHNOLOGY_ADAPTER_DECODE_MEMO_HPP
+#define _MODBUS_TECHNOLOGY_ADAPTER_DECODE_MEMO_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <Information_Model/DataVariant.hpp>
+
+#include "Decoder.hpp"
+
+namespace Technology_Adapter::Modbus {
+
+/**
+ * @brief Remembers the last raw register values of a readable and their
+ * decoded value
+ *
+ * Decoding is skipped if the raw values are bit-identical to those of the
+ * previous `decode`. As a by-product, the memo tells whether and how often the
+ * raw values have changed. Consumers may use this to skip unchanged values.
+ *
+ * Thread-safe. Concurrent `decode`s compare and remember raw values under a
+ * lock, but decode outside of it, so that they do not wait for each other's
+ * decoding. If they both see the same new raw values, they both decode, yet
+ * the change is counted once.
+ */
+class DecodeMemo {
+public:
+  /// @brief For a readable of `num_registers` registers
+  explicit DecodeMemo(size_t num_registers);
+
+  /**
+   * @brief The decoded value of the registers at `indices` of `registers`
+   *
+   * Like `decoder(registers, indices, num_registers)` with `num_registers`
+   * as passed to the constructor. Allocates memory only in order to throw.
+   *
+   * @pre `decoder` is the same for all calls
+   * @throws whatever `decoder` throws
+   */
+  Information_Model::DataVariant decode(Config::Decoder const& decoder,
+      uint16_t const* registers, size_t const* indices);
+
+  /// @brief Whether the last `decode` saw other raw values than the one before
+  bool changed() const;
+
+  /// @brief The number of `decode`s that saw new raw values, including the
+  /// first
+  uint64_t changeCount() const;
+
+private:
+  // Whether `raw_` equals the registers at `indices` of `registers`
+  bool same(uint16_t const* registers, size_t const* indices) const;
+
+  std::mutex mutex_;
+
+  // Guarded by `mutex_`
+  std::vector<uint16_t> raw_;
+  Information_Model::DataVariant value_;
+  bool valid_ = false; // whether `raw_` and `value_` are from the last decode
+
+  std::atomic<bool> changed_ = false;
+  std::atomic<uint64_t> change_count_ = 0;
+};
+
+} // namespace Technology_Adapter::Modbus
+
+#endif // _MODBUS_TECHNOLOGY_ADAPTER_DECODE_MEMO_HPP
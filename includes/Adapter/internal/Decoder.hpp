@@ -0,0 +1,199 @@
+#ifndef _MODBUS_TECHNOLOGY_ADAPTER_DECODER_HPP
+#define _MODBUS_TECHNOLOGY_ADAPTER_DECODER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <Information_Model/DataVariant.hpp>
+
+namespace Technology_Adapter::Modbus::Config {
+
+class Expression;
+
+/**
+ * @brief Converts the values of Modbus registers into a metric value
+ *
+ * A decoder is a small descriptor rather than arbitrary code. Anything that
+ * does not depend on the register values is resolved once, when the decoder
+ * is made: The kind, signedness, and byte and word order select a kernel
+ * which is specialized for them, and powers of the `base` of a
+ * mantissa/exponent decoder are tabulated. Hence decoding makes a single
+ * call through a function pointer and does not branch on the kind or order.
+ * Only the width, which is given per call, is still checked at run time.
+ *
+ * Register values are passed as a pointer and a size, so that callers may
+ * decode from whatever buffer they have read into. Decoding allocates memory
+ * only in order to throw.
+ */
+class Decoder {
+public:
+  enum class Kind : uint8_t {
+    Linear, /// `factor * integer + offset`
+    Float, /// IEEE 754 Single or Double
+    MantissaExponent, /// `mantissa * base ^ exponent`
+    Expression, /// an `Expression` over the registers
+  };
+
+  /// @brief Order of the two bytes within each register
+  enum class ByteOrder : uint8_t {
+    BigEndian, /// as specified by Modbus, i.e., the register value as is
+    LittleEndian, /// the bytes of each register are swapped
+  };
+
+  /// @brief Order of the registers of a value that spans several
+  enum class WordOrder : uint8_t {
+    LittleEndian, /// the first register is least significant
+    BigEndian, /// the first register is most significant
+  };
+
+  /**
+   * @brief Register values of several devices, one lane per device
+   *
+   * This is a structure of arrays: The `r`th register of lane `lane` is
+   * `registers[r * num_lanes + lane]`.
+   */
+  struct Block {
+    uint16_t const* registers;
+    size_t num_lanes;
+    size_t num_registers; /// per lane
+  };
+
+  Decoder() = delete;
+
+  /**
+   * @brief The registers as an integer, then linearly transformed
+   *
+   * By default, the integer is little endian, i.e., the first register is
+   * least significant.
+   */
+  static Decoder linear(bool is_signed, double factor, double offset,
+      ByteOrder = ByteOrder::BigEndian, WordOrder = WordOrder::LittleEndian);
+
+  /**
+   * @brief Two registers as an IEEE 754 Single or four as a Double
+   *
+   * By default, both are little endian, i.e., the first register is least
+   * significant.
+   */
+  static Decoder ieee754(
+      ByteOrder = ByteOrder::BigEndian, WordOrder = WordOrder::LittleEndian);
+
+  /**
+   * @brief The first register as a signed exponent and the remaining ones as
+   * a little endian mantissa
+   */
+  static Decoder mantissaExponent(bool is_signed, double base);
+
+  /**
+   * @brief The value of `expression`, given the values of its `registers()`
+   *
+   * @pre `expression` is not empty
+   */
+  static Decoder expression(std::shared_ptr<Expression const> expression);
+
+  Kind kind() const;
+
+  /**
+   * @brief The decoded value as a `double`
+   *
+   * @throws `std::runtime_error` if `num_registers` does not suit the kind
+   */
+  double decodeDouble(uint16_t const* registers, size_t num_registers) const;
+
+  /**
+   * @brief Like the above, but the `i`th register value is
+   * `registers[indices[i]]`
+   *
+   * This decodes straight from a buffer of bursts, which may contain further
+   * registers in between.
+   */
+  double decodeDouble(uint16_t const* registers, size_t const* indices,
+      size_t num_registers) const;
+
+  /**
+   * @brief Decodes each lane of `block` into `values[lane]`
+   *
+   * This is for callers which hold the registers of many devices of the same
+   * model at once. `Bus` reads each metric on its own and does not call it.
+   *
+   * The results are those of `decodeDouble` per lane. Where the target has
+   * SSE2 or AVX, four lanes are decoded at once for linear decoders of up to
+   * three registers, floats, and mantissa/exponent decoders of up to four
+   * registers. Other decoders and remaining lanes are decoded one by one.
+   *
+   * @pre `values` has room for `block.num_lanes` entries
+   * @throws `std::runtime_error` if `block.num_registers` does not suit the
+   *   kind
+   */
+  void decodeBatch(Block const& block, double* values) const;
+
+  /// @pre There are as many `registers` as in the respective `Readable`
+  Information_Model::DataVariant operator()(
+      uint16_t const* registers, size_t num_registers) const;
+
+  /// @pre There are as many `registers` as in the respective `Readable`
+  Information_Model::DataVariant operator()(
+      std::vector<uint16_t> const& registers) const;
+
+  /// @pre There are as many `indices` as in the respective `Readable`
+  Information_Model::DataVariant operator()(uint16_t const* registers,
+      size_t const* indices, size_t num_registers) const;
+
+private:
+  // Exponents whose power of `base_` is tabulated range from `-MAX` to `MAX`
+  static constexpr int MAX_TABULATED_EXPONENT = 64;
+
+  /*
+    Byte and word order together. Each value selects its own instantiation of
+    the kernel, so that reordering is resolved at compile time.
+  */
+  enum class Order : uint8_t {
+    Standard, // `ByteOrder::BigEndian`, `WordOrder::LittleEndian`
+    SwappedBytes, // `ByteOrder::LittleEndian`, `WordOrder::LittleEndian`
+    SwappedWords, // `ByteOrder::BigEndian`, `WordOrder::BigEndian`
+    Swapped, // `ByteOrder::LittleEndian`, `WordOrder::BigEndian`
+  };
+
+  // Register values scattered over a buffer, as for `decodeDouble`
+  struct Gathered;
+
+  // The register values of one lane of a `Block`
+  struct Strided;
+
+  // The kernels, and their selection
+  struct Kernels;
+
+  /*
+    A kernel for one kind, signedness and `Order`. `Registers` provides
+    `uint16_t operator[](size_t)` for indices below `num_registers`.
+  */
+  template <class Registers>
+  using Kernel = double (*)(
+      Decoder const&, Registers const&, size_t num_registers);
+
+  // A kernel of `decodeBatch` for one kind, signedness and `Order`
+  using BatchKernel = void (*)(Decoder const&, Block const&, double* values);
+
+  Decoder(Kind, bool is_signed, double factor, double offset, double base,
+      ByteOrder, WordOrder);
+
+  double power(int exponent) const; // of `base_`
+
+  Kind kind_;
+  Kernel<uint16_t const*> kernel_; // selected by the constructor
+  Kernel<Gathered> gathered_kernel_; // selected by the constructor
+  BatchKernel batch_kernel_; // selected by the constructor
+  double factor_; // only for `Linear`
+  double offset_; // only for `Linear`
+  double base_; // only for `MantissaExponent`
+
+  // only for `MantissaExponent`, shared between copies
+  std::shared_ptr<std::vector<double> const> powers_;
+
+  std::shared_ptr<Expression const> expression_; // only for `Expression`
+};
+
+} // namespace Technology_Adapter::Modbus::Config
+
+#endif // _MODBUS_TECHNOLOGY_ADAPTER_DECODER_HPP
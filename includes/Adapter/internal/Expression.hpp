@@ -0,0 +1,105 @@
+#ifndef _MODBUS_TECHNOLOGY_ADAPTER_EXPRESSION_HPP
+#define _MODBUS_TECHNOLOGY_ADAPTER_EXPRESSION_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Config.hpp"
+
+namespace Technology_Adapter::Modbus::Config {
+
+/**
+ * @brief A value derived from registers and readables of the same device
+ *
+ * The source language is arithmetic over `double`s:
+ * - numbers such as `10` or `0.5`
+ * - `#n`, the value of register `n` as an unsigned integer
+ * - names of readables, such as `Value`, or `'Supply voltage'` for names
+ *   that are not identifiers. Their registers are decoded as for the readable
+ * - binary `+`, `-`, `*`, `/`, and `^` (power, right associative), unary `-`,
+ *   and parentheses
+ * - `bit(x, n)`, which is bit `n` of the integer part of `x`, counting from
+ *   the least significant bit `0`
+ *
+ * An expression is compiled once into a program for a stack machine. All
+ * registers it depends on are collected in `registers`, so that a single
+ * burst yields all operands.
+ */
+class Expression {
+public:
+  /// Maximal number of registers an expression may depend on
+  static constexpr size_t MAX_REGISTERS = 64;
+
+  /**
+   * @brief Finds the readable that a name refers to
+   *
+   * @throws `std::runtime_error` if there is no such readable
+   */
+  using Lookup = std::function<Readable const&(std::string const& name)>;
+
+  /**
+   * @brief Compiles `source`
+   *
+   * @throws `std::runtime_error` if `source` is malformed, refers to unknown
+   *   readables or to registers beyond 65535, is too deeply nested, or
+   *   exceeds `MAX_REGISTERS`
+   */
+  static Expression compile(std::string const& source, Lookup const&);
+
+  /// @brief Registers whose values `evaluate` expects, in that order
+  std::vector<int> const& registers() const;
+
+  /**
+   * @brief The value of the expression
+   *
+   * Allocates memory only in order to throw.
+   *
+   * @pre `registers` has as many entries as `registers()`
+   * @throws `std::runtime_error` if `bit` is asked for a bit other than `0`
+   *   to `63`, or for a bit of a value outside of the range of `int64_t`
+   */
+  double evaluate(uint16_t const* registers) const;
+
+  // Only for internal use, yet public for technical reasons
+  struct Instruction {
+    enum class Code : uint8_t {
+      Constant, // pushes `constant`
+      Register, // pushes the value at index `operand`
+      Readable, // pushes the value of `operands_[operand]`
+      Add,
+      Subtract,
+      Multiply,
+      Divide,
+      Power,
+      Negate,
+      Bit,
+    };
+
+    Code code;
+    double constant;
+    size_t operand;
+  };
+
+  // Only for internal use, yet public for technical reasons
+  struct Operand {
+    Decoder decoder;
+    std::vector<size_t> indices; // into the `registers` of `evaluate`
+  };
+
+private:
+  // Maximal depth of the stack of `evaluate`
+  static constexpr size_t MAX_DEPTH = 32;
+
+  Expression(std::vector<int> registers, std::vector<Instruction> program,
+      std::vector<Operand> operands);
+
+  std::vector<int> registers_;
+  std::vector<Instruction> program_; // in postfix order
+  std::vector<Operand> operands_;
+};
+
+} // namespace Technology_Adapter::Modbus::Config
+
+#endif // _MODBUS_TECHNOLOGY_ADAPTER_EXPRESSION_HPP
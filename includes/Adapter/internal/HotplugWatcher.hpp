@@ -0,0 +1,95 @@
+#ifndef _MODBUS_TECHNOLOGY_ADAPTER_HOTPLUG_WATCHER_HPP
+#define _MODBUS_TECHNOLOGY_ADAPTER_HOTPLUG_WATCHER_HPP
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <HaSLL/Logger.hpp>
+#include <Nonempty/Pointer.hpp>
+
+namespace Technology_Adapter::Modbus {
+
+/**
+ * @brief Reports device nodes that appear in or disappear from directories
+ *
+ * This is based on inotify and runs a thread of its own, which sleeps until
+ * something happens. If inotify is unavailable (e.g., if the user's limit of
+ * watches is exhausted), some directories cannot be watched, and users have
+ * to fall back to polling for them.
+ *
+ * Also provides the handling of glob patterns in port names.
+ */
+class HotplugWatcher {
+public:
+  /**
+   * @brief Called with the full path of a node and whether it is present now
+   *
+   * "Present" includes changes of attributes, as udev typically adjusts
+   * permissions only after creating a node.
+   * Nodes may be reported as present again although they have not changed,
+   * e.g. after inotify has dropped events.
+   * Called on the watcher's own thread. Must not call `~HotplugWatcher`.
+   */
+  using Callback = std::function<void(std::string const& path, bool present)>;
+
+  HotplugWatcher() = delete;
+
+  /// @param enabled If `false`, no directory is ever watched
+  HotplugWatcher(Callback, bool enabled);
+
+  /// Terminates the thread. No callbacks happen afterwards.
+  ~HotplugWatcher() noexcept;
+
+  /**
+   * @brief Starts watching the directory which contains `path`
+   *
+   * Idempotent. Only absolute paths can be watched. Other port names (e.g.,
+   * of virtual ports in tests) do not refer to device nodes.
+   *
+   * return value is whether the directory is watched
+   */
+  bool watchDirectoryOf(std::string const& path);
+
+  /// @brief Whether `path` contains glob wildcards, e.g. `/dev/ttyUSB*`
+  static bool isPattern(std::string const& path);
+
+  /// @brief Existing paths that match `pattern`, in lexicographic order
+  static std::vector<std::string> expand(std::string const& pattern);
+
+  static bool matches(std::string const& pattern, std::string const& path);
+
+private:
+  void run() noexcept; // the body of `thread_`
+
+  using Changes = std::vector<std::pair<std::string, bool>>; // as in Callback
+
+  /*
+    Translates raw inotify events.
+    If the kernel's queue has overflowed, events have been lost. Then every
+    node in the watched directories is reported as present, so that patterns
+    are matched again and waiting ports retry.
+  */
+  Changes parseEvents(char const* buffer, size_t size);
+
+  // Every node in `directories_`, as present. @pre `mutex_` is held
+  Changes scanDirectories();
+
+  Callback const callback_;
+  Nonempty::Pointer<HaSLL::LoggerPtr> const logger_;
+
+  int inotify_fd_ = -1; // `-1` if unavailable
+  int termination_fds_[2] = {-1, -1}; // a pipe which interrupts `run`
+
+  std::mutex mutex_; // protects `directories_`
+  std::map<int, std::string> directories_; // by watch descriptor
+
+  std::thread thread_;
+};
+
+} // namespace Technology_Adapter::Modbus
+
+#endif // _MODBUS_TECHNOLOGY_ADAPTER_HOTPLUG_WATCHER_HPP
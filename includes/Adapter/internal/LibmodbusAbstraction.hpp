@@ -1,6 +1,11 @@
 #ifndef _LIBMODBUS_ABSTRACTION_HPP
 #define _LIBMODBUS_ABSTRACTION_HPP
 
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include <Const_String/ConstString.hpp>
 
 #include "ThreadsafeStrerror.hpp"
@@ -51,6 +56,14 @@ struct ModbusError : public std::exception {
    */
   bool retryFeasible() const;
 
+  /**
+   * @brief Whether the device rejected the request as not applicable
+   *
+   * This is the case for the exception codes `XILFUN`, `XILADD`, and
+   * `XILVAL`. Devices use either of them for unsupported functions.
+   */
+  bool unsupportedRequest() const;
+
   /// Now follow error codes defined by libmodbus
   static int const XILFUN;
   static int const XILADD;
@@ -73,13 +86,60 @@ private:
   ConstString::ConstString const what_;
 };
 
+/**
+ * @brief Allows other threads to interrupt waiting for a response
+ *
+ * Based on an `eventfd`. Once `cancel` has been called, reads of contexts
+ * that use the cancellation fail with `ECANCELED`, whether they are waiting
+ * already or start later. This lasts until `reset`.
+ *
+ * Thread-safe.
+ */
+class Cancellation {
+public:
+  using Ptr = std::shared_ptr<Cancellation>;
+
+  Cancellation(); /// @throws `ModbusError` if no `eventfd` is available
+  Cancellation(Cancellation const&) = delete;
+  Cancellation& operator=(Cancellation const&) = delete;
+  ~Cancellation();
+
+  void cancel() noexcept;
+  void reset() noexcept;
+  bool cancelled() const noexcept;
+
+  /// Sleeps for `duration` unless cancelled. Returns `cancelled()`.
+  bool waitFor(std::chrono::microseconds duration) const noexcept;
+
+  /// Becomes readable when cancelled. For use with `poll`.
+  int fd() const noexcept;
+
+private:
+  int fd_;
+};
+
+/**
+ * @brief What a device reports about itself
+ *
+ * Either from Read Device Identification (function code `0x2B`, MEI type
+ * `0x0E`), which fills `vendor`, `product`, and `revision`, or from Report
+ * Server ID (function code `0x11`), which fills `server_id` with the
+ * device-specific data of the response.
+ */
+struct DeviceIdentification {
+  std::string vendor;
+  std::string product;
+  std::string revision;
+  std::string server_id;
+};
+
 /// @brief A class for communication with a Modbus, based on `libmodbus`
 struct Context {
   using Ptr = std::shared_ptr<Context>;
 
-  virtual ~Context();
+  virtual ~Context(); /// Closes the connection, if any
   void connect(); /// @throws `ModbusError`
-  void close() noexcept;
+  void close() noexcept; /// Does nothing unless connected
 
   /**
    * Reads up to `nb` registers starting at address `addr` and stores their
@@ -91,10 +151,71 @@ struct Context {
    */
   int readRegisters(int addr, ReadableRegisterType, int nb, uint16_t* dest);
 
+  /**
+   * @brief Reads the basic device identification objects
+   *
+   * These are VendorName, ProductCode, and MajorMinorRevision.
+   *
+   * @throws `ModbusError`, with `unsupportedRequest()` if the device does not
+   *   support it
+   * @pre connected
+   */
+  DeviceIdentification readDeviceIdentification();
+
+  /**
+   * @brief Asks the device to report its server ID
+   *
+   * @throws `ModbusError`, with `unsupportedRequest()` if the device does not
+   *   support it
+   * @pre connected
+   */
+  DeviceIdentification reportServerId();
+
+  /// Max time to wait for a response. @throws `ModbusError`
+  void setResponseTimeout(std::chrono::microseconds);
+  std::chrono::microseconds responseTimeout() const; /// @throws `ModbusError`
+
+  /// Max time to wait between bytes of a response. @throws `ModbusError`
+  void setByteTimeout(std::chrono::microseconds);
+  std::chrono::microseconds byteTimeout() const; /// @throws `ModbusError`
+
+  /**
+   * @brief Lets `cancellation` interrupt `readRegisters`
+   *
+   * Requests are then sent and their responses awaited by the present class
+   * rather than by libmodbus, so that waiting can be cancelled. `nullptr`
+   * reverts to plain libmodbus reads.
+   */
+  void setCancellation(Cancellation::Ptr) noexcept;
+
 protected:
   _modbus* internal_;
+  bool connected_ = false;
+  Cancellation::Ptr cancellation_; // may be `nullptr`
 
   Context(_modbus* internal); // @throws `ModbusError`
+
+private:
+  // Like `readRegisters`, but can be cancelled. @pre `cancellation_` is set
+  int readRegistersCancellably(
+      int addr, ReadableRegisterType, int nb, uint16_t* dest);
+
+  /*
+    Sends `request` (without CRC) and receives the response, which is checked
+    to belong to `request`. Waiting can be cancelled if `cancellation_` is set.
+
+    return value is the PDU of the response, without function code
+    @throws `ModbusError`, e.g., if the response is an exception
+  */
+  std::vector<uint8_t> exchange(std::vector<uint8_t> const& request);
+
+  /*
+    Appends to `response` from the socket until it has `length` bytes. The
+    first byte of a response may take the response timeout, later ones the
+    byte timeout.
+    @throws `ModbusError`, e.g., with `ETIMEDOUT` or `ECANCELED`
+  */
+  void receiveBytes(std::vector<uint8_t>& response, size_t length);
 };
 
 /// @brief A specialization of `Context` for Modbus RTU
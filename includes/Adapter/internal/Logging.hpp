@@ -1,6 +1,8 @@
 #ifndef _MODBUS_TECHNOLOGY_ADAPTER_LOGGING_HPP
 #define _MODBUS_TECHNOLOGY_ADAPTER_LOGGING_HPP
 
+#include <chrono>
+
 #include <HaSLL/Logger.hpp>
 #include <Nonempty/Pointer.hpp>
 
@@ -23,6 +25,22 @@ void debug(Nonempty::Pointer<HaSLL::LoggerPtr> logger, Args&&... args) noexcept;
 template <class... Args>
 void error(Nonempty::Pointer<HaSLL::LoggerPtr> logger, Args&&... args) noexcept;
 
+/**
+ * @brief Measures durations of phases for the purpose of logging them
+ */
+class Stopwatch {
+public:
+  Stopwatch() noexcept;
+
+  /// @brief Milliseconds since construction or since the last `restart`
+  double elapsedMs() const noexcept;
+
+  void restart() noexcept;
+
+private:
+  std::chrono::steady_clock::time_point start_;
+};
+
 } // namespace Technology_Adapter::Modbus::Logging
 
 #include "../implementations/Logging__implementation.hpp"
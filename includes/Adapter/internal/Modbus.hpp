@@ -41,6 +41,48 @@ struct ModbusContext {
    */
   virtual int readRegisters(
       int addr, LibModbus::ReadableRegisterType, int nb, uint16_t* dest) = 0;
+
+  /**
+   * @brief Asks the selected device to identify itself
+   *
+   * Tries Read Device Identification first and falls back to Report Server
+   * ID if the device does not support the former.
+   *
+   * @throws `ModbusError`, with `unsupportedRequest()` if the device supports
+   *   neither
+   * @pre connected
+   */
+  virtual LibModbus::DeviceIdentification identify() = 0;
+
+  /**
+   * @brief Adjusts timeouts to the given round of bus detection
+   *
+   * Rounds count from `0`. Later rounds may use longer timeouts. Has no
+   * effect unless the purpose is `PortAutoDetection`.
+   *
+   * @throws `ModbusError`
+   */
+  virtual void setDetectionRound(size_t round) = 0;
+
+  /**
+   * @brief Switches to the delays and timeouts of `bus` for `purpose`
+   *
+   * This allows to reuse an open context for another bus or to hand it over
+   * from port detection to normal operation. The serial settings are fixed
+   * when creating the context, though.
+   *
+   * @pre `Config::serialSettings(bus)` equals that of the creating bus
+   * @throws `ModbusError`
+   */
+  virtual void configure(Config::Bus const& bus, Purpose) = 0;
+
+  /**
+   * @brief Lets `cancellation` interrupt reads, including delays before them
+   *
+   * Cancelled reads throw a `ModbusError` with `ECANCELED`. `nullptr` makes
+   * reads uninterruptible again.
+   */
+  virtual void setCancellation(LibModbus::Cancellation::Ptr) noexcept = 0;
 };
 
 class ModbusRTUContext : public ModbusContext {
@@ -55,19 +97,46 @@ public:
       Config::Device const&) override; /// @throws `ModbusError`
   virtual int readRegisters(int addr, LibModbus::ReadableRegisterType, int nb,
       uint16_t* dest) override; /// @throws `ModbusError`
+  virtual LibModbus::DeviceIdentification
+  identify() override; /// @throws `ModbusError`
+  virtual void setDetectionRound(
+      size_t round) override; /// @throws `ModbusError`
+  virtual void configure(
+      Config::Bus const&, Purpose) override; /// @throws `ModbusError`
+  virtual void setCancellation(
+      LibModbus::Cancellation::Ptr) noexcept override;
 
   /// @brief A `Factory`
   /// @throws `ModbusError`
   static Ptr make(
       ConstString::ConstString const& port, Config::Bus const&, Purpose);
 
+  /**
+   * @brief The response timeout in the given round of bus detection
+   *
+   * @param initial As in `Config::Bus::response_timeout_when_searching`
+   * @param max As in `Config::Bus::max_response_timeout_when_searching`
+   */
+  static std::chrono::microseconds escalatedTimeout(
+      std::chrono::microseconds initial, std::chrono::microseconds max,
+      size_t round);
+
 private:
+  // Waits for the delay which the bus requires before using it again
+  void awaitDelay();
+
   LibModbus::ContextRTU libmodbus_context_;
+  std::chrono::microseconds const default_response_timeout_;
+  std::chrono::microseconds const default_byte_timeout_;
+  Purpose purpose_;
+  std::chrono::microseconds response_timeout_;
+  std::chrono::microseconds max_response_timeout_;
   std::chrono::microseconds inter_use_delay_;
   std::chrono::microseconds inter_device_delay_;
   std::chrono::time_point<std::chrono::steady_clock> end_of_last_use_;
   int last_use_slave_id_ = -1;
   int current_slave_id_;
+  LibModbus::Cancellation::Ptr cancellation_; // may be `nullptr`
 };
 
 } // namespace Technology_Adapter::Modbus
@@ -1,6 +1,9 @@
 #ifndef _MODBUS_TECHNOLOGY_ADAPTER_IMPLEMENTATION_HPP
 #define _MODBUS_TECHNOLOGY_ADAPTER_IMPLEMENTATION_HPP
 
+#include <condition_variable>
+#include <mutex>
+
 #include <nlohmann/json.hpp>
 
 #include "Technology_Adapter_Interface/TechnologyAdapterInterface.hpp"
@@ -8,6 +11,7 @@
 #include "Bus.hpp"
 #include "ModbusTechnologyAdapterInterface.hpp"
 #include "PortFinder.hpp"
+#include "WorkerPool.hpp"
 
 namespace Technology_Adapter::Modbus {
 
@@ -20,6 +24,8 @@ class ModbusTechnologyAdapterImplementation
     : public ModbusTechnologyAdapterInterface {
 public:
   ModbusTechnologyAdapterImplementation(ModbusContext::Factory, Config::Buses);
+  ModbusTechnologyAdapterImplementation(
+      ModbusContext::Factory, Config::Adapter);
   ModbusTechnologyAdapterImplementation(
       ModbusContext::Factory, nlohmann::json const& config);
   ModbusTechnologyAdapterImplementation(
@@ -32,16 +38,38 @@ public:
       NonemptyDeviceRegistryPtr const& registry);
 
   void start() override;
+
+  /// Stops all `Bus`es concurrently on `workers_`
   void stop() override;
+
+  /**
+   * @brief Creates the `Bus` and queues its start on `workers_`
+   *
+   * Connecting, model building, and verification thus happen concurrently for
+   * several buses and do not block the caller. If starting fails, the bus
+   * cancels itself if it has connected already. Otherwise, the port is handed
+   * back to `port_finder_` directly. A `connection`, if given, is reused by
+   * the `Bus` rather than opening the port anew.
+   */
   void addBus(Config::Bus::NonemptyPtr const&,
-      Config::Portname const& actual_port) override;
+      Config::Portname const& actual_port, Verification,
+      ModbusContext::Ptr const& connection) override;
   void cancelBus(Config::Portname const&) override;
 
 private:
+  // Upper bound for the size of `workers_`
+  static constexpr size_t MAX_BUS_WORKERS = 8;
+
+  // The part of `addBus` that runs on `workers_`
+  void startBus(Bus::NonemptyPtr const&, Config::Bus const&,
+      Config::Portname const& actual_port, Verification);
+
+  // Marks the end of a start which has been accounted for in `pending_starts_`
+  void finishStart();
+
   HaSLL::LoggerPtr const logger_;
   Config::Buses const bus_configs_; // used during `start`
-  Threadsafe::PrivateResource<Information_Model::DeviceBuilderInterfacePtr>
-      device_builder_;
+  Bus::DeviceBuilderResource device_builder_;
   DeviceRegistryPtr registry_;
   ModbusContext::Factory context_factory_;
   PortFinder port_finder_;
@@ -58,8 +86,22 @@ private:
     In fact, `addBus` is no-op while `stop` runs. Once `stop` is finished,
     `port_finder_` is stopped, so there is noone to call `addBus` any more
     before the next `start`.
+
+    Starts that have been queued by `addBus` are counted in `pending_starts_`.
+    `stop` waits for them to finish before it stops any `Bus`, so that, when
+    it cleans stuff, it does not miss anything they have done.
+  */
+  std::mutex stopping_mutex_; // protects `stopping_` and `pending_starts_`
+  std::condition_variable starts_finished_;
+  bool stopping_ = false;
+  size_t pending_starts_ = 0;
+
+  /*
+    Runs bus starts and stops.
+    Declared last so that it is destroyed first: Queued tasks access the
+    other members.
   */
-  Threadsafe::PrivateResource<bool> stopping_{false};
+  WorkerPool workers_;
 };
 
 } // namespace Technology_Adapter::Modbus
@@ -2,9 +2,17 @@
 #define _MODBUS_TECHNOLOGY_ADAPTER_INTERFACE_HPP
 
 #include "Config.hpp"
+#include "Modbus.hpp"
 
 namespace Technology_Adapter::Modbus {
 
+/// @brief How a bus which has not been searched for is confirmed on its port
+enum struct Verification {
+  None, // the bus has been searched for
+  Eager, // read all registers right after the bus has started
+  Lazy, // read all registers upon the first read of a metric
+};
+
 /**
  * @brief An abstract API for `ModbusTechnologyAdapterImplementation`
  *
@@ -18,10 +26,20 @@ public:
   /**
    * @brief This is how `PortFinder` informs us of its successes
    *
-   * @throws `std::runtime_error`
+   * Starting the bus may happen asynchronously. Then a start that fails after
+   * `addBus` has returned is not reported to the caller. Instead, the bus is
+   * cancelled through `cancelBus`, or its port is handed back through
+   * `PortFinder::unassign`.
+   *
+   * @param verification How the bus is still to be confirmed on
+   *   `actual_port`. If confirmation fails, the bus is cancelled.
+   * @param connection An open context for `actual_port`, e.g., the one on
+   *   which the bus has been found, or `nullptr`
+   * @throws `std::runtime_error` if the bus cannot even be set up for starting
    */
-  virtual void addBus(
-      Config::Bus::NonemptyPtr const&, Config::Portname const& actual_port) = 0;
+  virtual void addBus(Config::Bus::NonemptyPtr const&,
+      Config::Portname const& actual_port, Verification verification,
+      ModbusContext::Ptr const& connection) = 0;
 
   /**
    * @brief Called when `Bus` communication fails
@@ -1,45 +1,94 @@
 #ifndef _MODBUS_TECHNOLOGY_ADAPTER_PORT_HPP
 #define _MODBUS_TECHNOLOGY_ADAPTER_PORT_HPP
 
+#include <chrono>
+#include <condition_variable>
 #include <functional>
+#include <mutex>
 #include <optional>
-#include <thread>
+#include <vector>
 
 #include <HaSLL/Logger.hpp>
 #include <Threadsafe_Containers/List.hpp>
-#include <Threadsafe_Containers/PrivateResource.hpp>
 
 #include "Modbus.hpp"
 #include "PortFinderPlan.hpp"
+#include "ProbeCache.hpp"
+#include "ProbeSchedule.hpp"
+#include "WorkerPool.hpp"
 
 /// @brief Port detection from the point of view of a single port
 
 namespace Technology_Adapter::Modbus {
 
+struct BurstPlan;
+
 /**
- * @brief Can run a search thread for buses on a given port
+ * @brief Can run a search for buses on a given port
+ *
+ * The search does not have a thread of its own. Instead, it runs as a sequence
+ * of steps on a `WorkerPool` which may be shared among many `Port`s. Each step
+ * tries one candidate. Candidates which were tried unsuccessfully back off
+ * according to a `ProbeSchedule`.
+ *
+ * Devices with a configured `Config::Identification` are first asked to
+ * identify themselves, which replaces reading their registers unless they
+ * lack support for it. Where only identification tells a candidate's bus
+ * apart from another one, lacking support rejects the candidate.
+ *
+ * The port is kept open across steps as long as the serial settings of the
+ * candidates allow. To this end, candidates are ordered by serial settings.
+ * The open context of a successful candidate is passed on to the
+ * `SuccessCallback`.
+ *
+ * Stopping the search does not wait for pending I/O. Reads of the current
+ * step are cancelled, and a delayed step runs right away.
  *
  * For analysis, we pretend there were a member `bool assigned`.
- * - The `!assigned` -> `assigned` transition happens internally and triggers
- *   the `SuccessCallback`.
+ * - The `!assigned` -> `assigned` transition happens either internally,
+ *   triggering the `SuccessCallback`, or through `assign`.
  * - The `assigned` -> `!assigned` transition happens through `reset`.
  */
 class Port {
 public:
-  using SuccessCallback = std::function<void(PortFinderPlan::Candidate const&)>;
+  /**
+   * @brief Receives the successful candidate
+   *
+   * `connection` is the open context on which the candidate was found, set up
+   * for `PortAutoDetection`. It may be `nullptr`.
+   */
+  using SuccessCallback = std::function<void(
+      PortFinderPlan::Candidate const&, ModbusContext::Ptr const& connection)>;
+  using Clock = std::chrono::steady_clock;
+
+  /// @brief The back-off state of a candidate
+  struct ScheduledCandidate {
+    Config::Bus::NonemptyPtr bus;
+    size_t failures; // consecutive unsuccessful attempts
+    Clock::time_point next_attempt; // earliest
+  };
 
   Port() = delete;
 
   /**
    * @brief constructor
    *
-   * Guarantee: The `SuccessCallback` is only called from the search thread.
+   * Guarantee: The `SuccessCallback` is only called as a task on `executor`.
    *
+   * @param watched Whether `nodeAppeared` and `nodeDisappeared` will be called
+   *   as the port's device node comes and goes. Otherwise, a missing node is
+   *   polled for.
+   * @pre The lifetime of `executor` includes that of `*this`
    * @post `!assigned`
    */
-  Port(ModbusContext::Factory, Config::Portname, SuccessCallback);
+  Port(ModbusContext::Factory, Config::Portname, SuccessCallback,
+      WorkerPool& executor, ProbeSchedule, bool watched);
 
-  /// Terminates the search thread, if any
+  /**
+   * @brief Terminates the search, if any, and waits for the `SuccessCallback`
+   *
+   * Closes the port unless it has been passed on to the `SuccessCallback`.
+   */
   ~Port() noexcept;
 
   /**
@@ -48,27 +97,125 @@ public:
    * May block.
    *
    * @pre `candidate.getPort() == port_`
-   * @pre No other call to `addCandidate` or `reset` is in process
+   * @pre No other call to `addCandidate`, `assign`, or `reset` is in process
    */
   void addCandidate(PortFinderPlan::Candidate const& candidate);
 
-  /// @pre 'assigned`
-  /// @pre No other call to `addCandidate` or `reset` is in process
-  /// @post `!assigned`
+  /**
+   * @brief Assigns the port without searching
+   *
+   * This is for assignments known from elsewhere, e.g., from an earlier run.
+   * A search in progress, if any, is terminated. If that search has already
+   * succeeded, the port stays assigned to its result instead.
+   *
+   * return value is whether the assignment took place
+   * @pre No other call to `addCandidate`, `assign`, or `reset` is in process
+   * @post `assigned`
+   */
+  bool assign();
+
+  /**
+   * @brief To be called when the port's device node appears or changes
+   *
+   * Resumes a search which waits for the node and resets the back-offs of all
+   * candidates. May block.
+   *
+   * @pre No other call to `addCandidate`, `assign`, `reset`, `nodeAppeared`,
+   *   or `nodeDisappeared` is in process
+   */
+  void nodeAppeared();
+
+  /**
+   * @brief To be called when the port's device node disappears
+   *
+   * A search, if any, pauses until `nodeAppeared`. Does nothing unless
+   * `watched`.
+   *
+   * @pre No other call to `addCandidate`, `assign`, `reset`, `nodeAppeared`,
+   *   or `nodeDisappeared` is in process
+   */
+  void nodeDisappeared();
+
+  /**
+   * @pre 'assigned`
+   * @pre No other call to `addCandidate`, `assign`, or `reset` is in process
+   * @post `!assigned`
+   *
+   * Does not wait for the `SuccessCallback`. Hence it may be called from there.
+   */
   void reset();
 
+  /**
+   * @brief The candidates of the current search and their back-offs
+   *
+   * Empty if there is no search.
+   */
+  std::vector<ScheduledCandidate> schedule();
+
 private:
   // The result of looking for a given bus on the port
   enum struct TryResult {
     NoPort, // the port does not exist
+    Unavailable, // the port exists, but cannot be opened
     NotFound, // the bus was not found
     Found,
   };
 
   struct Search;
 
-  void stopThread();
-  void search(); // to be run in its own thread
+  // A candidate together with its back-off state
+  struct Entry {
+    explicit Entry(PortFinderPlan::Candidate const&);
+
+    PortFinderPlan::Candidate const candidate;
+    size_t failures = 0; // consecutive unsuccessful attempts
+    Clock::time_point not_before; // earliest time of the next attempt
+  };
+
+  // Terminates the search and waits until no step is scheduled
+  void stopSearch();
+
+  /*
+    Makes the scheduled step, if any, finish quickly, and waits for it
+
+    @pre `state_` is neither `Searching` nor `WaitingForPort`
+  */
+  void awaitStep(std::unique_lock<std::mutex>& lock);
+
+  // @pre `mutex_` is locked
+  void resetBackoffs();
+
+  // @pre `state_ == State::Searching`
+  // @pre `mutex_` is locked
+  void scheduleStep(std::chrono::milliseconds delay);
+
+  void searchStep() noexcept; // to be run on `executor_`
+
+  // @pre `state_ == State::Found`
+  void succeed(PortFinderPlan::Candidate const&,
+      ModbusContext::Ptr connection) noexcept;
+
+  /*
+    Returns `open_context_`, reconfigured for `bus`, if it has the serial
+    settings of `bus`. Otherwise, replaces `open_context_` by a newly
+    connected context.
+
+    return value is `nullptr` if the port cannot be opened. Then
+    `port_missing` tells whether that is because the port does not exist.
+  */
+  ModbusContext::Ptr openContext(
+      Config::Bus const& bus, bool& port_missing) noexcept;
+
+  void closeContext() noexcept;
+
+  /*
+    Orders `candidates_` by serial settings, so that `open_context_` can be
+    reused as often as possible
+
+    @pre `mutex_` is locked
+    @pre No step runs, or the calling step is the only one
+  */
+  void sortCandidates();
 
   // @pre `candidate.getPort() == port_`
   TryResult tryCandidate(PortFinderPlan::Candidate const& candidate) noexcept;
@@ -79,11 +226,73 @@ private:
       PortFinderPlan::Candidate const&,
       ModbusContext::Ptr const& context) noexcept;
 
+  enum struct ReadOutcome {
+    Success,
+    Failure,
+    NoResponse, // the slave did not respond at all
+  };
+
+  enum struct IdentifyOutcome {
+    Match,
+    Mismatch,
+    Unsupported, // registers have to be read instead
+    NoResponse,
+  };
+
+  /*
+    Asks `device` to identify itself, unless `cached` knows the answer, and
+    compares the answer to `device.identification`
+
+    If `strict`, a Report Server ID reply counts as `Unsupported`, as its
+    substring match cannot tell identifications apart.
+
+    @pre `device.identification` is set
+    @pre `context` is connected
+    @throws `std::exception` only for unexpected failures (e.g. `bad_alloc`)
+  */
+  IdentifyOutcome identify(ModbusContext::Ptr const& context,
+      Config::Device const& device, ProbeCache::Results& cached, bool strict);
+
+  /*
+    Selects `device` and reads registers, recording the outcome in `cached`
+
+    @pre `context` is connected
+    @throws `std::exception` only for unexpected failures (e.g. `bad_alloc`)
+  */
+  ReadOutcome readRegisters(ModbusContext::Ptr const& context,
+      Config::Device const& device, LibModbus::ReadableRegisterType,
+      RegisterIndex start_register, int num_registers, uint16_t* buffer,
+      ProbeCache::Results& cached);
+
+  /*
+    Reads each of `probes`, stopping at the first failure. Reads are skipped
+    if their outcome is already in `cached`.
+
+    return value is success
+    @pre `context` is connected
+    @throws `std::exception` only for unexpected failures (e.g. `bad_alloc`)
+  */
+  bool readProbes(std::vector<PortFinderPlan::Probe> const& probes,
+      ModbusContext::Ptr const& context, ProbeCache::Results& cached);
+
+  /*
+    Reads all bursts of `plan`. If a burst fails, its registers are read
+    singly in order to locate the failure. Reads are skipped if their outcome
+    is already in `cached`.
+
+    return value is success
+    @pre `context` is connected
+    @throws `std::exception` only for unexpected failures (e.g. `bad_alloc`)
+  */
+  bool readBursts(BurstPlan const& plan, Config::Device const& device,
+      ModbusContext::Ptr const& context, ProbeCache::Results& cached);
+
   enum struct State {
     Idle, // we would be searching, but lack candidates
     Searching,
     Found, // we have affirmed a candidate
-    OutOfCandidates, // like `Idle`, but the old search thread may still run
+    OutOfCandidates, // like `Idle`, but the last step may still run
+    WaitingForPort, // like `OutOfCandidates`, but keeping the candidates
     Stopping, // `stop` has been called, no new search allowed
   };
 
@@ -91,24 +300,53 @@ private:
   Nonempty::Pointer<HaSLL::LoggerPtr> const logger_;
   Config::Portname const port_;
   SuccessCallback const success_callback_;
-  Threadsafe::PrivateResource<State> state_ = State::Idle;
-  std::optional<std::thread> search_thread_;
-  std::vector<std::thread> other_threads_;
+  WorkerPool& executor_;
+  ProbeSchedule const schedule_;
+  bool const watched_;
+
+  // protects the following six members and back-off states in `candidates_`
+  std::mutex mutex_;
+  std::condition_variable step_or_callback_finished_;
+  State state_ = State::Idle;
+  bool step_scheduled_ = false; // a step is queued on or run by `executor_`
+  bool callback_scheduled_ = false; // similarly for the `SuccessCallback`
+  bool node_appeared_ = false; // during the current round
+  WorkerPool::Ticket step_ticket_ = 0; // of the scheduled step
+
+  // Interrupts reads of the scheduled step. May be `nullptr`.
+  LibModbus::Cancellation::Ptr const cancellation_;
 
   // The search cycles through this list
   // Meaningful only in state `Searching`
-  Threadsafe::List<PortFinderPlan::Candidate> candidates_;
+  Threadsafe::List<Entry> candidates_;
+
+  // Progress of the search.
+  // Only accessed by steps and, while `!step_scheduled_`, by `addCandidate`
+  std::optional<Threadsafe::List<Entry>::iterator> next_candidate_;
+  bool some_port_existed_ = false; // during the current round
+  bool some_attempt_made_ = false; // during the current round
+  size_t round_ = 0; // rounds with attempts since the search (re)started
+  Clock::time_point last_attempt_; // start of the most recent attempt
+  ProbeCache probe_cache_; // for the current round
+  ModbusContext::Ptr open_context_; // may be `nullptr`
+  Config::SerialSettings open_settings_; // of `open_context_`
+  bool context_broken_ = false; // `open_context_` should be reopened
+
+  // New candidates have been added since the last `sortCandidates`.
+  // Protected by `mutex_`.
+  bool candidates_unsorted_ = false;
 
   /*
     Invariants:
-    - Only `search_thread_` may run `this->search`
-    - If `state_` is `Idle`, then `search_thread_` is empty
-    - If `state_` is `Searching` or `OutOfCandidates`, then `search_thread_` is
-      non-empty
+    - At most one step is scheduled at any time
+    - If `state_` is `Idle`, then `!step_scheduled_`
+    - If `state_` is `Searching`, then `step_scheduled_`
     - Only the following `state_` transitions are possible:
       - `Idle` -> `Searching` -> `Found`
       - `Searching` -> `OutOfCandidates` -> `Searching`
+      - `Searching` -> `WaitingForPort` -> `Searching`
       - any of the above -> `Stopping` -> `Idle`
+      - any of the above but `Found` -> `Stopping` -> `Found`
   */
 };
 
@@ -0,0 +1,58 @@
+#ifndef _MODBUS_TECHNOLOGY_ADAPTER_PORT_ASSIGNMENTS_HPP
+#define _MODBUS_TECHNOLOGY_ADAPTER_PORT_ASSIGNMENTS_HPP
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include <HaSLL/Logger.hpp>
+#include <Nonempty/Pointer.hpp>
+
+#include "Config.hpp"
+
+namespace Technology_Adapter::Modbus {
+
+/**
+ * @brief Bus-to-port assignments which persist across restarts
+ *
+ * The assignments are kept in a JSON file that maps bus IDs to port names.
+ * Buses are identified by `Config::Bus::id`, i.e., by the IDs of their
+ * devices. The file is rewritten whenever an assignment changes.
+ *
+ * A missing or malformed file counts as empty. Failures to write the file are
+ * logged and otherwise ignored, as the assignments are merely a hint.
+ *
+ * Thread-safe.
+ */
+class PortAssignments {
+public:
+  PortAssignments() = delete;
+
+  /**
+   * @brief Loads the assignments from `file_path`
+   *
+   * @param file_path An empty path disables persistence altogether
+   */
+  explicit PortAssignments(std::string file_path);
+
+  /// @brief The port which `bus` had been assigned to, if any
+  std::optional<Config::Portname> lookup(Config::Bus const& bus) const;
+
+  /// @brief Remembers that `bus` is on `port` and updates the file
+  void remember(Config::Bus const& bus, Config::Portname const& port) noexcept;
+
+private:
+  void load();
+  void save() const; // @pre `mutex_` is locked
+
+  std::string const file_path_;
+  Nonempty::Pointer<HaSLL::LoggerPtr> const logger_;
+
+  mutable std::mutex mutex_; // protects `assignments_`
+  std::map<std::string, std::string> assignments_; // bus ID -> port name
+};
+
+} // namespace Technology_Adapter::Modbus
+
+#endif // _MODBUS_TECHNOLOGY_ADAPTER_PORT_ASSIGNMENTS_HPP
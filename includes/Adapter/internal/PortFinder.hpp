@@ -5,9 +5,13 @@
 #include <Nonempty/Pointer.hpp>
 #include <Threadsafe_Containers/PrivateResource.hpp>
 
+#include "HotplugWatcher.hpp"
 #include "ModbusTechnologyAdapterInterface.hpp"
 #include "Port.hpp"
+#include "PortAssignments.hpp"
 #include "PortFinderPlan.hpp"
+#include "ProbeSchedule.hpp"
+#include "WorkerPool.hpp"
 
 namespace Technology_Adapter {
 
@@ -20,17 +24,36 @@ namespace Modbus {
  *
  * The actual searching is done by class `Port` per port.
  * The overall detection is coordinated by class `PortFinderPlan`.
+ * All `Port`s share one `WorkerPool`, so the number of threads does not grow
+ * with the number of ports.
+ *
+ * Device nodes are watched by a `HotplugWatcher`, so that the search on a
+ * port pauses while its node is missing. Glob patterns in
+ * `possible_serial_ports` are expanded to existing nodes, and to nodes as they
+ * appear.
  */
 class PortFinder {
 public:
   PortFinder() = delete;
 
-  /// @pre The lifetime of `*this` is included in the lifetime of `owner`
-  PortFinder(ModbusTechnologyAdapterInterface& owner, ModbusContext::Factory);
+  /**
+   * @pre The lifetime of `*this` is included in the lifetime of `owner`
+   * @pre `config.max_concurrent_probes > 0`
+   */
+  PortFinder(ModbusTechnologyAdapterInterface& owner, ModbusContext::Factory,
+      Config::PortDetection const& config);
 
   /**
    * @brief Adds new buses to the search
    *
+   * Buses which have been found on some port in an earlier run are assumed to
+   * be there still. They are handed to `owner` right away, which verifies them
+   * in the background. With `direct_connect`, the same holds for uncontested
+   * buses, except that verification happens on first read. All other buses
+   * are searched for.
+   *
+   * @throws `std::runtime_error` if a bus's possible ports cannot be expanded
+   *
    * @pre All entries of `new_buses` are in fact new to the search
    */
   void addBuses(Config::Buses const& new_buses);
@@ -38,35 +61,87 @@ public:
   /**
    * @brief Removes a bus-to-port assignment
    *
-   * The consequence is that a new search thread starts for the port and that
-   * the bus is (again) searched for on all feasible ports.
+   * The consequence is that a new search starts for the port and that the bus
+   * is (again) searched for on all feasible ports.
    *
    * @pre `port.assigned` for the respective `port`
    */
   void unassign(Config::Portname const&);
 
   /**
-   * @brief Stops all search threads and forgets all buses
+   * @brief Remembers `bus` on `port` for the next run
+   *
+   * `owner` calls this once a bus that has been searched for has started.
+   */
+  void remember(Config::Bus const& bus, Config::Portname const& port) noexcept;
+
+  /**
+   * @brief Stops all searches and forgets all buses
    *
    * To recommence searching, one has to call `addBuses` again.
    */
   void reset();
 
 private:
+  using Ports = Threadsafe::PrivateResource<std::map<Config::Portname, Port>>;
+
   // Organizes searches for the given candidates
   void addCandidates(PortFinderPlan::NewCandidates&&);
 
+  // Expands glob patterns in `bus`'s possible ports into `plan`
+  void addPatterns(PortFinderPlan& plan, Config::Bus::NonemptyPtr const& bus,
+      PortFinderPlan::NewCandidates& candidates);
+
+  // The `HotplugWatcher::Callback`
+  void nodeChanged(std::string const& path, bool present);
+
+  /*
+    Assigns the candidate's port without searching
+    return value is success
+    @pre `verification != Verification::None`
+  */
+  bool assumeCandidate(
+      PortFinderPlan::Candidate const& candidate, Verification verification);
+
   // @pre `candidate.getPort().assigned`
-  void confirmCandidate(PortFinderPlan::Candidate const& candidate);
+  // @param connection as in `ModbusTechnologyAdapterInterface::addBus`
+  void confirmCandidate(PortFinderPlan::Candidate const& candidate,
+      Verification verification, ModbusContext::Ptr const& connection);
+
+  // @pre `ports_` is locked through `ports_access`
+  Port& getPort(
+      Ports::ScopedAccessor& ports_access, Config::Portname const& portname);
 
   ModbusTechnologyAdapterInterface& owner_;
   ModbusContext::Factory context_factory_;
   Nonempty::Pointer<Threadsafe::MutexSharedPtr<PortFinderPlan>> plan_;
   Nonempty::Pointer<HaSLL::LoggerPtr> logger_;
 
-  // The mutex ensures that `Port::addCandidate` and `Port::reset` are not
-  // called concurrently
-  Threadsafe::PrivateResource<std::map<Config::Portname, Port>> ports_;
+  // Runs the searches of all `Port`s in `ports_`.
+  // Declared before `ports_` so that it outlives them.
+  WorkerPool executor_;
+
+  ProbeSchedule const probe_schedule_; // for all `Port`s
+
+  // The mutex ensures that `Port::addCandidate`, `Port::assign`, and
+  // `Port::reset` are not called concurrently
+  Ports ports_;
+
+  // While set, `addCandidates` and `assumeCandidate` are no-op.
+  // Protected by the lock on `ports_`.
+  bool resetting_ = false;
+
+  PortAssignments assignments_;
+  bool const direct_connect_;
+
+  // Glob patterns from `possible_serial_ports` and their buses
+  Threadsafe::PrivateResource<
+      std::vector<std::pair<std::string, Config::Bus::NonemptyPtr>>>
+      patterns_;
+
+  // Declared last so that its thread, which calls `nodeChanged`, terminates
+  // first
+  HotplugWatcher watcher_;
 };
 
 } // namespace Modbus
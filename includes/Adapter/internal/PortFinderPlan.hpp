@@ -1,8 +1,10 @@
 #ifndef _MODBUS_TECHNOLOGY_ADAPTER_PORT_FINDER_PLAN_HPP
 #define _MODBUS_TECHNOLOGY_ADAPTER_PORT_FINDER_PLAN_HPP
 
+#include <atomic>
 #include <list>
 #include <map>
+#include <memory>
 
 #include "Index/Indexing.hpp"
 #include "Index/Map.hpp"
@@ -32,6 +34,15 @@ class PortFinderPlan : public Threadsafe::EnableSharedFromThis<PortFinderPlan> {
     SecretConstructorArgument() = default;
   };
 
+  /*
+    Whether a bus is feasible on a port, as in `feasible`.
+
+    Written under `mutex_` whenever the state it depends on changes, but read
+    without any lock by `Candidate::stillFeasible`.
+  */
+  using Feasibility = std::atomic<bool>;
+  using FeasibilityPtr = std::shared_ptr<Feasibility>;
+
 public:
   using NonemptyPtr = Nonempty::Pointer<Threadsafe::SharedPtr<PortFinderPlan>>;
 
@@ -39,6 +50,41 @@ public:
 
   using NewCandidates = std::vector<Candidate>;
 
+  /// @brief A single register read which is expected to succeed
+  struct Probe {
+    Config::Device::NonemptyPtr device;
+    LibModbus::ReadableRegisterType type;
+    RegisterIndex register_index;
+  };
+
+  /**
+   * @brief Register reads which check a `Candidate` quickly
+   *
+   * If the `Candidate`'s bus is actually present, all probes succeed. The
+   * converse does not hold. Hence, probes can reject a `Candidate` early but
+   * do not replace reading all of its registers.
+   */
+  struct Probes {
+    /// One register per device
+    std::vector<Probe> liveness;
+
+    /**
+     * Further probes such that, together with `liveness`, some probe fails
+     * for every other bus on the port, unless that bus ambiguates the
+     * `Candidate`'s bus.
+     */
+    std::vector<Probe> distinguishing;
+
+    /**
+     * Whether some other bus on the port is told apart from the
+     * `Candidate`'s bus only by the devices' identifications. If so, devices
+     * with an identification must identify themselves by Read Device
+     * Identification. Neither reading registers nor a Report Server ID reply
+     * tells the buses apart.
+     */
+    bool identification_required = false;
+  };
+
   /// @brief A candidate for a bus/port assignment
   class Candidate {
   public:
@@ -46,22 +92,49 @@ public:
 
     /// @brief Only for internal use, yet public for technical reasons
     Candidate(SecretConstructorArgument, //
-        NonemptyPtr plan, PortIndexing::Index port, PortBusIndexing::Index bus)
-        : plan_(plan), port_(std::move(port)), bus_(std::move(bus)){};
-
+        NonemptyPtr plan, PortIndexing::Index port, PortBusIndexing::Index bus,
+        Config::Bus::NonemptyPtr bus_config, Config::Portname port_name,
+        FeasibilityPtr feasibility)
+        : plan_(plan), port_(std::move(port)), bus_(std::move(bus)),
+          bus_config_(std::move(bus_config)),
+          port_name_(std::move(port_name)),
+          feasibility_(std::move(feasibility)){};
+
+    /// Does not lock the plan
     Config::Bus::NonemptyPtr const& getBus() const;
+
+    /// Does not lock the plan
     Config::Portname const& getPort() const;
 
-    /// This check should be performed before trying the candidate
+    /**
+     * This check should be performed before trying the candidate.
+     *
+     * Does not lock the plan. Hence the result may be outdated as soon as it
+     * is returned, just as with any other check before `confirm`.
+     */
     bool stillFeasible() const;
 
     /// To be called after successfully trying the candidate
     NewCandidates confirm() const;
 
+    /// Probes to try before reading all registers of `getBus()`
+    Probes probes() const;
+
+    /**
+     * Whether the port is the only possible one for the bus, and the bus the
+     * only possible one for the port. In that case, searching is pointless.
+     */
+    bool uncontested() const;
+
   private:
     NonemptyPtr plan_;
     PortIndexing::Index port_;
     PortBusIndexing::Index bus_;
+
+    // Copies of what `port_` and `bus_` index, so that they need no lock
+    Config::Bus::NonemptyPtr bus_config_;
+    Config::Portname port_name_;
+    FeasibilityPtr feasibility_;
   };
 
   PortFinderPlan() = delete;
@@ -77,10 +150,23 @@ public:
   /**
    * @brief Adds new buses to the plan
    *
+   * Entries of `possible_serial_ports` which are glob patterns are ignored.
+   * Ports that match them are to be added through `addPossiblePort`.
+   *
    * @pre All entries of `new_buses` are in fact new to the plan
    */
   NewCandidates addBuses(Config::Buses const& /*new_buses*/);
 
+  /**
+   * @brief Adds `port` to the possible ports of `bus`
+   *
+   * No-op if `port` is already possible for `bus`.
+   *
+   * @pre `bus` has been added through `addBuses`
+   */
+  NewCandidates addPossiblePort(
+      Config::Bus::NonemptyPtr const& bus, Config::Portname const& port);
+
   /**
    * @brief Undo the assignment of some bus to `port`
    */
@@ -111,14 +197,15 @@ private:
   */
   Index::Map<Config::Portname, std::optional<Port>, PortIndexingTag> ports_;
 
-  /*
-    It is feasible to search for `bus` on `port`, if
-    - No bus is currently assigned to `port`,
-    - `bus` is currently assigned to no port, and
-    - `bus` is not ambiguous on `port`
-  */
+  // Ports whose state changed since the last `publishFeasibility`
+  std::vector<PortIndexing::Index> outdated_ports_;
+
+  // as in `Port::feasible`
   bool feasible(PortBusIndexing::Index bus, PortIndexing::Index port) const;
 
+  // as in `Candidate::uncontested`
+  bool uncontested(PortBusIndexing::Index bus, PortIndexing::Index port) const;
+
   Port const& getPort(PortIndexing::Index) const;
   Port& getPort(PortIndexing::Index);
 
@@ -132,6 +219,17 @@ private:
       NewCandidates&, PortBusIndexing::Index, PortIndexing::Index);
 
   NewCandidates assign(PortBusIndexing::Index, PortIndexing::Index);
+
+  // To be called whenever the state of a port changes
+  void markOutdated(PortIndexing::Index);
+
+  /*
+    Publishes the feasibility of all buses on outdated ports.
+    To be called at the end of every operation that changes the state.
+  */
+  void publishFeasibility();
+
+  Probes const& probes(PortBusIndexing::Index, PortIndexing::Index);
 };
 
 } // namespace Technology_Adapter::Modbus
@@ -0,0 +1,94 @@
+#ifndef _MODBUS_TECHNOLOGY_ADAPTER_PROBE_CACHE_HPP
+#define _MODBUS_TECHNOLOGY_ADAPTER_PROBE_CACHE_HPP
+
+#include <map>
+#include <optional>
+#include <set>
+#include <tuple>
+
+#include "Config.hpp"
+
+namespace Technology_Adapter::Modbus {
+
+/**
+ * @brief Remembers register reads during one round of port detection
+ *
+ * A round is one cycle of a `Port` through its candidates. Within a round,
+ * different candidates often share slaves and registers. With the present
+ * cache, each (slave, register type, register) is read at most once per
+ * round, and slaves which did not respond at all are not asked again.
+ * Likewise, each slave is asked at most once per round to identify itself.
+ *
+ * Results depend on the serial settings (baud etc.), hence they are kept
+ * separately per setting.
+ *
+ * Not thread-safe.
+ */
+class ProbeCache {
+public:
+  enum struct Result {
+    Unknown,
+    Readable,
+    Unreadable,
+  };
+
+  /// @brief The results for one set of serial settings
+  class Results {
+  public:
+    /// @brief Whether `slave_id` failed to respond to some earlier read
+    bool silent(int slave_id) const;
+
+    Result lookup(int slave_id, LibModbus::ReadableRegisterType,
+        RegisterIndex) const;
+
+    /**
+     * @brief Summary over `num_registers` registers from `start_register`
+     *
+     * `Readable` if all are known to be readable, `Unreadable` if some is known
+     * to be unreadable, and `Unknown` otherwise.
+     */
+    Result lookup(int slave_id, LibModbus::ReadableRegisterType,
+        RegisterIndex start_register, int num_registers) const;
+
+    void recordSilent(int slave_id);
+
+    void recordReadable(int slave_id, LibModbus::ReadableRegisterType,
+        RegisterIndex start_register, int num_registers);
+
+    void recordUnreadable(
+        int slave_id, LibModbus::ReadableRegisterType, RegisterIndex);
+
+    /**
+     * @brief What `slave_id` reported when asked to identify itself
+     *
+     * `nullptr` if it has not been asked yet. Points to `std::nullopt` if it
+     * does not support identification.
+     */
+    std::optional<LibModbus::DeviceIdentification> const* identity(
+        int slave_id) const;
+
+    /// @param identity `std::nullopt` if identification is unsupported
+    void recordIdentity(int slave_id,
+        std::optional<LibModbus::DeviceIdentification> identity);
+
+  private:
+    using Key = std::tuple<int, LibModbus::ReadableRegisterType, RegisterIndex>;
+
+    std::map<Key, bool> readable_;
+    std::set<int> silent_;
+    std::map<int, std::optional<LibModbus::DeviceIdentification>> identities_;
+  };
+
+  /// @brief The results for the serial settings of `bus`
+  Results& forBus(Config::Bus const& bus);
+
+  /// @brief Forgets everything, e.g. at the start of a new round
+  void clear();
+
+private:
+  std::map<Config::SerialSettings, Results> results_;
+};
+
+} // namespace Technology_Adapter::Modbus
+
+#endif // _MODBUS_TECHNOLOGY_ADAPTER_PROBE_CACHE_HPP
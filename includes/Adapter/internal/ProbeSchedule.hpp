@@ -0,0 +1,70 @@
+#ifndef _MODBUS_TECHNOLOGY_ADAPTER_PROBE_SCHEDULE_HPP
+#define _MODBUS_TECHNOLOGY_ADAPTER_PROBE_SCHEDULE_HPP
+
+#include <chrono>
+
+#include "Config.hpp"
+
+namespace Technology_Adapter::Modbus {
+
+/**
+ * @brief When a `Port` may attempt its candidates
+ *
+ * After `n > 0` consecutive unsuccessful attempts, a candidate is not
+ * attempted again until its back-off has passed. The nominal back-off is
+ * `backoff_initial * 2^(n-1)`, capped at `backoff_max`. The actual back-off
+ * is shortened by a random fraction of at most `backoff_jitter`, so that
+ * candidates which failed together do not stay in lockstep.
+ *
+ * In addition, the starts of two attempts on the same port are at least
+ * `min_attempt_interval` apart.
+ *
+ * Hence, once all candidates of a port have failed often enough, the port
+ * makes at most `steadyStateAttemptRate` attempts per second.
+ */
+class ProbeSchedule {
+public:
+  using Duration = std::chrono::milliseconds;
+
+  /// @brief No back-off and no rate cap, i.e., attempts go back to back
+  ProbeSchedule() = default;
+
+  explicit ProbeSchedule(Config::PortDetection const&);
+
+  /// @pre `backoff_initial <= backoff_max` and `0 <= jitter <= 1`
+  ProbeSchedule(Duration backoff_initial, Duration backoff_max, double jitter,
+      Duration min_attempt_interval);
+
+  /// @brief The nominal back-off after `failures` unsuccessful attempts
+  Duration backoff(size_t failures) const;
+
+  /// @brief The shortest back-off that `randomBackoff(failures)` may return
+  Duration minBackoff(size_t failures) const;
+
+  /**
+   * @brief A back-off between `minBackoff(failures)` and `backoff(failures)`
+   *
+   * Thread-safe.
+   */
+  Duration randomBackoff(size_t failures) const;
+
+  Duration minAttemptInterval() const;
+
+  /**
+   * @brief Upper bound on attempts per second on a port once its
+   * `num_candidates` candidates have reached `backoff_max`
+   *
+   * Infinite if the schedule imposes no such bound.
+   */
+  double steadyStateAttemptRate(size_t num_candidates) const;
+
+private:
+  Duration backoff_initial_{0};
+  Duration backoff_max_{0};
+  double jitter_ = 0;
+  Duration min_attempt_interval_{0};
+};
+
+} // namespace Technology_Adapter::Modbus
+
+#endif // _MODBUS_TECHNOLOGY_ADAPTER_PROBE_SCHEDULE_HPP
@@ -0,0 +1,72 @@
+#ifndef _MODBUS_TECHNOLOGY_ADAPTER_READ_CACHE_HPP
+#define _MODBUS_TECHNOLOGY_ADAPTER_READ_CACHE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#include <Information_Model/DataVariant.hpp>
+
+#include "Config.hpp"
+
+namespace Technology_Adapter::Modbus {
+
+/**
+ * @brief Serves the values of a `Readable` from memory as its `CachePolicy`
+ * permits
+ *
+ * Thread-safe. Concurrent `get`s of an expired value read only once.
+ */
+class ReadCache {
+public:
+  struct Counters {
+    uint64_t hits = 0; /// `get`s served from memory
+    uint64_t misses = 0; /// `get`s which called `read`
+  };
+
+  explicit ReadCache(Config::CachePolicy const&);
+
+  /**
+   * @brief The cached value, or else the result of `read()`
+   *
+   * For `CachePolicy::Kind::None`, always calls `read`. Allocates memory only
+   * if `read` does.
+   *
+   * @throws whatever `read` throws. Then nothing is cached.
+   */
+  template <class Read>
+  Information_Model::DataVariant get(Read const& read) {
+    std::lock_guard lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+    if (valid_ && (now < expiry_)) {
+      ++hits_;
+      return value_;
+    }
+    ++misses_;
+    value_ = read();
+    valid_ = policy_.kind != Config::CachePolicy::Kind::None;
+    expiry_ = policy_.kind == Config::CachePolicy::Kind::Constant
+        ? std::chrono::steady_clock::time_point::max()
+        : now + std::chrono::milliseconds(policy_.ttl_ms);
+    return value_;
+  }
+
+  Counters counters() const;
+
+private:
+  Config::CachePolicy const policy_;
+  std::mutex mutex_;
+
+  // Guarded by `mutex_`
+  Information_Model::DataVariant value_;
+  bool valid_ = false;
+  std::chrono::steady_clock::time_point expiry_;
+
+  std::atomic<uint64_t> hits_ = 0;
+  std::atomic<uint64_t> misses_ = 0;
+};
+
+} // namespace Technology_Adapter::Modbus
+
+#endif // _MODBUS_TECHNOLOGY_ADAPTER_READ_CACHE_HPP
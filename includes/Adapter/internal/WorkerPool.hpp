@@ -0,0 +1,117 @@
+#ifndef _MODBUS_TECHNOLOGY_ADAPTER_WORKER_POOL_HPP
+#define _MODBUS_TECHNOLOGY_ADAPTER_WORKER_POOL_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Const_String/ConstString.hpp>
+#include <HaSLL/Logger.hpp>
+#include <Nonempty/Pointer.hpp>
+
+namespace Technology_Adapter::Modbus {
+
+/**
+ * @brief A bounded set of threads that run queued tasks
+ *
+ * Tasks are started in the order in which they are posted. At most `size()`
+ * tasks run at the same time.
+ */
+class WorkerPool {
+public:
+  using Task = std::function<void()>;
+  using Clock = std::chrono::steady_clock;
+  using Ticket = size_t; /// identifies a delayed task
+
+  WorkerPool() = delete;
+
+  /**
+   * @brief Starts `num_threads` worker threads
+   *
+   * @param name Is used for logging
+   * @pre `num_threads > 0`
+   * @throws `std::system_error` if threads cannot be started
+   */
+  WorkerPool(ConstString::ConstString const& name, size_t num_threads);
+
+  /**
+   * @brief Runs all queued tasks, then terminates the worker threads
+   *
+   * Delayed tasks are run without waiting for their delay to pass.
+   */
+  ~WorkerPool() noexcept;
+
+  /**
+   * @brief Queues `task` for execution by some worker thread
+   *
+   * Exceptions thrown by `task` are logged and otherwise ignored.
+   *
+   * @throws `std::bad_alloc`
+   */
+  void post(Task);
+
+  /**
+   * @brief Like `post`, but `task` starts no earlier than `delay` from now
+   *
+   * No worker thread is blocked during the delay.
+   *
+   * return value allows to `expedite` the task
+   * @throws `std::bad_alloc`
+   */
+  Ticket postAfter(std::chrono::milliseconds delay, Task task);
+
+  /**
+   * @brief Ends the delay of a task posted by `postAfter`
+   *
+   * The task becomes due right away, like a `post`ed one. This is for tasks
+   * that should notice some change, e.g., a request to stop, without waiting
+   * for their delay to pass.
+   *
+   * return value is whether the task was still delayed
+   */
+  bool expedite(Ticket) noexcept;
+
+  /**
+   * @brief Runs all `tasks` and waits for their completion
+   *
+   * The calling thread takes part in running `tasks`. Hence it is safe to call
+   * this from within a task of the same pool.
+   * Exceptions thrown by the `tasks` are logged and otherwise ignored.
+   *
+   * @throws `std::bad_alloc`
+   */
+  void runAll(std::vector<Task> tasks);
+
+  size_t size() const;
+
+  /**
+   * @brief A pool size suitable for the present hardware
+   *
+   * The result is at least `1` and at most `upper_bound`.
+   */
+  static size_t defaultSize(size_t upper_bound);
+
+private:
+  void work() noexcept; // the body of each worker thread
+  void run(Task const&) noexcept;
+
+  Nonempty::Pointer<HaSLL::LoggerPtr> const logger_;
+  // protects `queue_`, `delayed_`, `next_ticket_`, and `terminating_`
+  std::mutex mutex_;
+  std::condition_variable wakeup_;
+  std::deque<Task> queue_; // tasks which may start right away
+  // by earliest start time
+  std::multimap<Clock::time_point, std::pair<Ticket, Task>> delayed_;
+  Ticket next_ticket_ = 0;
+  bool terminating_ = false;
+  std::vector<std::thread> threads_;
+};
+
+} // namespace Technology_Adapter::Modbus
+
+#endif // _MODBUS_TECHNOLOGY_ADAPTER_WORKER_POOL_HPP
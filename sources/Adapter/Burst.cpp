@@ -238,13 +238,50 @@ BurstPlan::BurstPlan( //
           readable_holding_registers, readable_input_registers, //
           max_burst_size)) {}
 
-BurstBuffer::BurstBuffer(BurstPlan::Task const& task,
-    RegisterSet const& readable_holding_registers,
-    RegisterSet const& readable_input_registers, //
-    std::size_t max_burst_size)
-    : plan(task, //
-          readable_holding_registers, readable_input_registers, //
-          max_burst_size),
-      padded(plan.num_plan_registers), compact(task.size()) {}
+BurstPlan BurstPlan::allOf(RegisterSet const& registers,
+    LibModbus::ReadableRegisterType type, std::size_t max_burst_size) {
+
+  Task task;
+  for (auto r : registers) {
+    task.push_back(r);
+  }
+  RegisterSet const none({});
+  return type == LibModbus::ReadableRegisterType::HoldingRegister
+      ? BurstPlan(task, registers, none, max_burst_size)
+      : BurstPlan(task, none, registers, max_burst_size);
+}
+
+namespace {
+
+/*
+  A stack of buffers. Buffers are never shrunk or freed, so that they are
+  reused by later reads of the same thread. Moving the inner vectors when the
+  outer one grows keeps their data in place.
+*/
+struct BurstArena {
+  std::vector<std::vector<uint16_t>> buffers;
+  size_t depth = 0; // number of buffers in use
+};
+
+thread_local BurstArena burst_arena; // NOLINT(cert-err58-cpp)
+
+} // namespace
+
+BurstBuffer::BurstBuffer(std::size_t num_plan_registers) {
+  auto& arena = burst_arena;
+  if (arena.depth == arena.buffers.size()) {
+    arena.buffers.emplace_back();
+  }
+  auto& buffer = arena.buffers[arena.depth];
+  if (buffer.size() < num_plan_registers) {
+    buffer.resize(num_plan_registers);
+  }
+  padded_ = buffer.data();
+  ++arena.depth;
+}
+
+BurstBuffer::~BurstBuffer() { --burst_arena.depth; }
+
+uint16_t* BurstBuffer::padded() const { return padded_; }
 
 } // namespace Technology_Adapter::Modbus
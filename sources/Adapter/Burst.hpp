@@ -81,25 +81,46 @@ struct BurstPlan {
       RegisterSet const& readable_input_registers, //
       std::size_t max_burst_size);
 
+  /**
+   * @brief A plan to read all of `registers` (and only those) with the given
+   * `type`
+   */
+  static BurstPlan allOf(RegisterSet const& registers,
+      LibModbus::ReadableRegisterType type, std::size_t max_burst_size);
+
 private:
   BurstPlan(Implementation::MutableBurstPlan&&);
 };
 
 /**
- * @brief Bundles a `BurstPlan` with the buffers needed for operation.
+ * @brief The buffer for a single run of a `BurstPlan`
+ *
+ * Buffers come from an arena local to the constructing thread and return to
+ * it on destruction. Hence concurrent reads each have a buffer of their own
+ * without any synchronization. Once the arena of a thread has grown to its
+ * largest buffer, constructing a buffer allocates no memory.
+ *
+ * The buffers of a thread must be destroyed in reverse order of construction,
+ * as they are if they are local variables.
  */
-struct BurstBuffer {
-  BurstPlan const plan;
-  std::vector<uint16_t> padded; /// of size `plan.num_plan_registers`
+class BurstBuffer {
+public:
+  /**
+   * @param num_plan_registers as in the `BurstPlan`
+   * @throws `std::bad_alloc`
+   */
+  explicit BurstBuffer(std::size_t num_plan_registers);
 
-  /// of size `task.size()`, where `task` refers to the constructor argument
-  std::vector<uint16_t> compact;
+  BurstBuffer(BurstBuffer const&) = delete;
+  BurstBuffer& operator=(BurstBuffer const&) = delete;
 
-  /// @throws `std::runtime_error` if `task` is impossible
-  BurstBuffer(BurstPlan::Task const& task,
-      RegisterSet const& readable_holding_registers,
-      RegisterSet const& readable_input_registers, //
-      std::size_t max_burst_size);
+  ~BurstBuffer();
+
+  /// @brief Of size `num_plan_registers`
+  uint16_t* padded() const;
+
+private:
+  uint16_t* padded_;
 };
 
 } // namespace Technology_Adapter::Modbus
@@ -1,24 +1,46 @@
 #include "internal/Bus.hpp"
 
 #include <thread>
+#include <type_traits>
 
 #include "Burst.hpp"
+#include "MetricTable.hpp"
 #include "internal/Logging.hpp"
 
 namespace Technology_Adapter::Modbus {
 
+static_assert(std::is_same_v<Bus::MetricHandle, MetricTable::Handle>);
+
+namespace {
+
+ModbusContext::Ptr reuseOrCreate(ModbusContext::Ptr const& connection,
+    ModbusContext::Factory const& context_factory,
+    Config::Portname const& port, Config::Bus const& config) {
+
+  if (connection != nullptr) {
+    connection->configure(config, ModbusContext::Purpose::NormalOperation);
+    return connection;
+  }
+  return context_factory(port, config, ModbusContext::Purpose::NormalOperation);
+}
+
+} // namespace
+
 Bus::Bus(ModbusTechnologyAdapterInterface& owner,
     Config::Bus::NonemptyPtr const& config,
     ModbusContext::Factory const& context_factory,
     Config::Portname const& actual_port,
     // NOLINTNEXTLINE(modernize-pass-by-value)
-    Technology_Adapter::NonemptyDeviceRegistryPtr const& model_registry)
+    Technology_Adapter::NonemptyDeviceRegistryPtr const& model_registry,
+    ModbusContext::Ptr const& connection)
     : owner_(owner), config_(config), actual_port_(actual_port), //
       logger_(HaSLL::LoggerManager::registerLogger(std::string(
           (std::string_view)("Modbus Bus " + config->id + "@" + actual_port)))),
       model_registry_(model_registry),
-      connection_(context_factory(
-          actual_port, *config, ModbusContext::Purpose::NormalOperation)) {}
+      connection_(
+          reuseOrCreate(connection, context_factory, actual_port, *config),
+          connection != nullptr),
+      metrics_(std::make_unique<MetricTable>(*config)) {}
 
 Bus::~Bus() noexcept {
   try {
@@ -31,12 +53,27 @@ Bus::~Bus() noexcept {
 }
 
 void Bus::start(Information_Model::NonemptyDeviceBuilderInterfacePtr const&
-        device_builder) {
+                    device_builder,
+    Verification verification) {
 
+  DeviceBuilderResource device_builder_resource(device_builder.base());
+  start(device_builder_resource, verification);
+}
+
+void Bus::start(
+    DeviceBuilderResource& device_builder, Verification verification) {
+
+  Logging::Stopwatch stopwatch;
   try {
     auto accessor = connection_.lock();
-    accessor->context->connect();
+    if (accessor->handed_over) {
+      accessor->handed_over = false;
+    } else {
+      accessor->context->connect();
+    }
     accessor->connected = true;
+    // Then the first read, possibly of a constant in `buildModel`, verifies
+    accessor->verified = verification == Verification::None;
   } catch (std::exception const& exception) {
     throw std::runtime_error(
         ("Starting bus " + actual_port_ + " failed: " + exception.what())
@@ -47,34 +84,129 @@ void Bus::start(Information_Model::NonemptyDeviceBuilderInterfacePtr const&
             "failed after a non-standard exception")
             .c_str());
   }
+  logger_->debug("Connected to {} after {} ms", actual_port_.c_str(),
+      stopwatch.elapsedMs());
 
+  stopwatch.restart();
   buildModel(device_builder);
+  logger_->debug("Registered all devices on bus {} after {} ms",
+      actual_port_.c_str(), stopwatch.elapsedMs());
+
+  if (verification == Verification::Eager) {
+    auto accessor = connection_.lock();
+    if (accessor->connected && !accessor->verified) {
+      stopwatch.restart();
+      verify(accessor);
+      logger_->debug("Verified bus {} after {} ms", actual_port_.c_str(),
+          stopwatch.elapsedMs());
+    }
+  }
 }
 
 void Bus::stop() {
   logger_->trace("Stopping bus {} as soon as we can", actual_port_.c_str());
+  Logging::Stopwatch stopwatch;
   {
     auto accessor = connection_.lock();
     stop(accessor);
   }
+  logger_->debug(
+      "Stopped bus {} after {} ms", actual_port_.c_str(), stopwatch.elapsedMs());
+}
+
+void Bus::verify() {
+  auto accessor = connection_.lock();
+  if (accessor->connected) {
+    verify(accessor);
+  }
 }
 
-void Bus::buildModel(Information_Model::NonemptyDeviceBuilderInterfacePtr const&
-        device_builder) {
+void Bus::verifyOnFirstRead() {
+  auto accessor = connection_.lock();
+  if (accessor->connected) {
+    logger_->debug("Deferring verification of bus {} on port {}",
+        config_->id.c_str(), actual_port_.c_str());
+    accessor->verified = false;
+  }
+}
 
+void Bus::verify(ConnectionResource::ScopedAccessor& accessor) {
+  logger_->debug("Verifying bus {} on port {}", config_->id.c_str(),
+      actual_port_.c_str());
+
+  for (auto const& device : config_->devices) {
+    for (auto type : {LibModbus::ReadableRegisterType::HoldingRegister,
+             LibModbus::ReadableRegisterType::InputRegister}) {
+      auto plan = BurstPlan::allOf(
+          type == LibModbus::ReadableRegisterType::HoldingRegister
+              ? device->holding_registers
+              : device->input_registers,
+          type, device->burst_size);
+      std::vector<uint16_t> buffer(plan.num_plan_registers);
+      uint16_t* read_dest = buffer.data();
+      accessor->context->selectDevice(*device);
+      for (auto const& burst : plan.bursts) {
+        size_t remaining_attempts = device->max_retries + 1;
+        while (true) {
+          std::string error_message = "incomplete read";
+          try {
+            if (accessor->context->readRegisters(burst.start_register,
+                    burst.type, burst.num_registers,
+                    read_dest) == burst.num_registers) {
+              break;
+            }
+          } catch (LibModbus::ModbusError const& error) {
+            if (!error.retryFeasible()) {
+              remaining_attempts = 1;
+            }
+            error_message = error.what();
+          }
+          --remaining_attempts;
+          if (remaining_attempts == 0) {
+            abort(accessor,
+                "Bus " + config_->id + " not confirmed on port " +
+                    actual_port_ + ". Reading " + device->id + " failed: " +
+                    error_message.c_str());
+          }
+          if (device->retry_delay > 0) {
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(device->retry_delay));
+          }
+        }
+        read_dest += burst.num_registers;
+      }
+    }
+  }
+  accessor->verified = true;
+  logger_->info(
+      "Confirmed bus {} on port {}", config_->id.c_str(), actual_port_.c_str());
+}
+
+void Bus::buildModel(DeviceBuilderResource& device_builder) {
   logger_->info("Registering all devices on bus {}", actual_port_.c_str());
 
   try {
+    MetricHandle next_handle = 0;
     for (auto const& device : config_->devices) {
-      device_builder->buildDeviceBase( //
-          std::string((std::string_view)device->id),
-          std::string((std::string_view)device->name),
-          std::string((std::string_view)device->description));
-      RegisterSet holding_registers(device->holding_registers);
-      RegisterSet input_registers(device->input_registers);
-      buildGroup(device_builder, "", //
-          NonemptyPtr(shared_from_this()), //
-          device, holding_registers, input_registers, *device);
+      Information_Model::DevicePtr device_model;
+      std::vector<ReadCallback> constant_reads;
+      {
+        auto builder_access = device_builder.lock();
+        Information_Model::NonemptyDeviceBuilderInterfacePtr builder(
+            *builder_access);
+        builder->buildDeviceBase( //
+            std::string((std::string_view)device->id),
+            std::string((std::string_view)device->name),
+            std::string((std::string_view)device->description));
+        buildGroup(builder, "", *device, next_handle, constant_reads);
+        device_model = builder->getResult();
+      }
+
+      // Constants are read once, before anyone else may read them, and
+      // without holding the builder. The first read verifies if required
+      for (auto const& read : constant_reads) {
+        read();
+      }
 
       {
         auto accessor = connection_.lock();
@@ -89,7 +221,7 @@ void Bus::buildModel(Information_Model::NonemptyDeviceBuilderInterfacePtr const&
       }
 
       model_registry_->registrate(
-          Information_Model::NonemptyDevicePtr(device_builder->getResult()));
+          Information_Model::NonemptyDevicePtr(device_model));
     }
   } catch (std::exception const& exception) {
     auto accessor = connection_.lock();
@@ -112,57 +244,65 @@ void Bus::buildModel(Information_Model::NonemptyDeviceBuilderInterfacePtr const&
 struct Readcallback {
 private:
   Bus::NonemptyPtr const bus;
-  Config::Device::NonemptyPtr const device;
-
-  // initialized after the constructor but before `DeviceRegistry::registrate`
-  std::shared_ptr<std::string> const metric_id;
-
-  Config::Readable const readable;
-  Nonempty::Pointer<std::shared_ptr<BurstBuffer>> const buffer;
+  Bus::MetricHandle const handle;
 
 public:
   Readcallback(
       // NOLINTBEGIN(readability-identifier-naming)
       Bus::NonemptyPtr const& bus_, // NOLINT(modernize-pass-by-value)
-      // NOLINTNEXTLINE(modernize-pass-by-value)
-      Config::Device::NonemptyPtr const& device_,
-      std::shared_ptr<std::string> metric_id_, //
-      Config::Readable readable_,
-      // NOLINTNEXTLINE(modernize-pass-by-value)
-      Nonempty::Pointer<std::shared_ptr<BurstBuffer>> const& buffer_)
+      Bus::MetricHandle handle_)
       // NOLINTEND(readability-identifier-naming)
-      : bus(bus_), device(device_), metric_id(std::move(metric_id_)),
-        readable(std::move(readable_)), buffer(buffer_) {}
+      : bus(bus_), handle(handle_) {}
 
   Information_Model::DataVariant operator()() const {
+    auto* cache = bus->metrics_->cache(handle);
+    if (cache != nullptr) {
+      return cache->get([this]() { return read(); });
+    }
+    return read();
+  }
+
+private:
+  Config::Device const& device() const { return bus->metrics_->device(handle); }
+
+  // For logging. It may still be empty during the first read of a constant
+  std::string const& metricId() const { return bus->metrics_->id(handle); }
+
+  Information_Model::DataVariant read() const {
+    auto& metrics = *bus->metrics_;
+
+    // Our own buffer, so that concurrent reads of this metric do not interfere
+    BurstBuffer buffer(metrics.numPlanRegisters(handle));
     {
       auto accessor = bus->connection_.lock();
       if (accessor->connected) {
-        bus->logger_->debug("Reading {}", *metric_id);
-        accessor->context->selectDevice(*device);
-
-        uint16_t* read_dest = buffer->padded.data();
-        for (auto const& burst : buffer->plan.bursts) {
-          readBurst(accessor, burst, read_dest);
-          read_dest += burst.num_registers;
+        if (!accessor->verified) {
+          bus->verify(accessor);
+        }
+        accessor->context->selectDevice(device());
+
+        uint16_t* read_dest = buffer.padded();
+        auto const* end = metrics.burstsEnd(handle);
+        for (auto const* burst = metrics.burstsBegin(handle); burst != end;
+             ++burst) {
+          readBurst(accessor, *burst, read_dest);
+          read_dest += burst->num_registers;
         }
       } else {
         // Some other thread closed the connection. Hence the resource has been
         // deregistered.
         bus->logger_->debug(
-            "Reading {} failed because the connection was closed", *metric_id);
+            "Reading {} failed because the connection was closed", metricId());
         throw std::runtime_error(
-            (device->id + " has been deregistered").c_str());
+            (device().id + " has been deregistered").c_str());
       }
-    } // no need to hold the lock during decoding
-    size_t compact_size = buffer->compact.size();
-    for (size_t i = 0; i < compact_size; ++i) {
-      buffer->compact[i] = buffer->padded[buffer->plan.task_to_plan[i]];
     }
-    return readable.decode(buffer->compact);
+
+    // The bus is free again while we decode
+    return metrics.memo(handle).decode(metrics.readable(handle).decode,
+        buffer.padded(), metrics.taskToPlan(handle));
   }
 
-private:
   // Reads all registers from `burst` and stores the result in `read_dest`
   void readBurst( //
       Bus::ConnectionResource::ScopedAccessor& accessor,
@@ -189,27 +329,27 @@ private:
       int num) const {
 
     int num_read = 0;
-    size_t remaining_attempts = device->max_retries + 1;
+    size_t remaining_attempts = device().max_retries + 1;
     while ((num_read == 0) && (remaining_attempts > 0)) {
       try {
         num_read = accessor->context->readRegisters(
             first_register, burst.type, num, read_dest);
         if (num_read == 0) {
-          bus->logger_->debug("Reading {} failed", *metric_id);
+          bus->logger_->debug("Reading {} failed", metricId());
           retryOrAbort(remaining_attempts, accessor,
-              "Deregistered " + device->id +
-                  " after too many read attempts for " + *metric_id);
+              "Deregistered " + device().id +
+                  " after too many read attempts for " + metricId());
         }
       } catch (LibModbus::ModbusError const& error) {
-        bus->logger_->debug("Reading {} failed: {}", *metric_id, error.what());
+        bus->logger_->debug("Reading {} failed: {}", metricId(), error.what());
         if (error.retryFeasible()) {
           retryOrAbort(remaining_attempts, accessor,
-              "Deregistered " + device->id +
-                  " after too many read attempts for " + *metric_id +
+              "Deregistered " + device().id +
+                  " after too many read attempts for " + metricId() +
                   ". Last error was: " + error.what());
         } else {
           bus->abort(accessor,
-              "Deregistered " + device->id + " after: " + error.what());
+              "Deregistered " + device().id + " after: " + error.what());
         }
       }
       --remaining_attempts;
@@ -225,11 +365,11 @@ private:
       ConstString::ConstString const& error_message) const {
 
     if (remaining_attempts > 1) {
-      if (device->retry_delay > 0) {
+      if (device().retry_delay > 0) {
         std::this_thread::sleep_for(
-            std::chrono::milliseconds(device->retry_delay));
+            std::chrono::milliseconds(device().retry_delay));
       }
-      bus->logger_->debug("Retrying to read {}", *metric_id);
+      bus->logger_->debug("Retrying to read {}", metricId());
       // wait for next iteration of `ReadRegisters`
     } else {
       bus->abort(accessor, error_message);
@@ -237,34 +377,48 @@ private:
   }
 };
 
+uint64_t Bus::changeCount(std::string const& metric_id) {
+  auto handle = metrics_->find(metric_id);
+  return handle ? metrics_->memo(*handle).changeCount() : 0;
+}
+
+ReadCache::Counters Bus::cacheCounters(std::string const& metric_id) {
+  auto handle = metrics_->find(metric_id);
+  ReadCache const* cache = handle ? metrics_->cache(*handle) : nullptr;
+  return cache == nullptr ? ReadCache::Counters{} : cache->counters();
+}
+
+std::function<Information_Model::DataVariant()> Bus::readCallback(
+    MetricHandle handle) {
+
+  return Readcallback(NonemptyPtr(shared_from_this()), handle);
+}
+
 void Bus::buildGroup(
     Information_Model::NonemptyDeviceBuilderInterfacePtr const& device_builder,
     std::string const& group_id, //
-    NonemptyPtr const& shared_this, //
-    Config::Device::NonemptyPtr const& device, //
-    RegisterSet const& holding_registers, RegisterSet const& input_registers,
-    Config::Group const& group) {
+    Config::Group const& group, //
+    MetricHandle& next_handle, //
+    std::vector<ReadCallback>& constant_reads) {
 
   for (auto const& readable : group.readables) {
-    auto buffer = Nonempty::make_shared<BurstBuffer>( //
-        readable.registers, //
-        holding_registers, input_registers, //
-        device->burst_size);
-
-    auto metric_id = std::make_shared<std::string>();
-
-    *metric_id = device_builder->addReadableMetric( //
-        group_id, std::string((std::string_view)readable.name),
-        std::string((std::string_view)readable.description), readable.type,
-        Readcallback(shared_this, device, metric_id, readable, buffer));
+    MetricHandle handle = next_handle++;
+    auto read = readCallback(handle);
+    if (readable.cache.kind == Config::CachePolicy::Kind::Constant) {
+      constant_reads.push_back(read);
+    }
+    metrics_->identify(handle,
+        device_builder->addReadableMetric( //
+            group_id, std::string((std::string_view)readable.name),
+            std::string((std::string_view)readable.description),
+            readable.type, std::move(read)));
   }
 
   for (auto const& subgroup : group.subgroups) {
     std::string group_id = device_builder->addDeviceElementGroup(
         std::string((std::string_view)subgroup.name),
         std::string((std::string_view)subgroup.description));
-    buildGroup(device_builder, group_id, shared_this, device, //
-        holding_registers, input_registers, subgroup);
+    buildGroup(device_builder, group_id, subgroup, next_handle, constant_reads);
   }
 }
 
@@ -274,9 +428,10 @@ void Bus::stop(ConnectionResource::ScopedAccessor& accessor) {
     model_registry_->deregistrate(std::string((std::string_view)device));
   }
   accessor->devices_to_deregister.clear();
-  if (accessor->connected) {
+  if (accessor->connected || accessor->handed_over) {
     accessor->context->close();
     accessor->connected = false;
+    accessor->handed_over = false;
   }
 }
 
@@ -4,6 +4,28 @@ namespace Technology_Adapter::Modbus::Config {
 
 // NOLINTBEGIN(readability-identifier-naming)
 
+bool Identification::matches(
+    LibModbus::DeviceIdentification const& reported) const {
+
+  if (!reported.server_id.empty()) {
+    for (auto const* expected : {&vendor, &product, &revision}) {
+      if (reported.server_id.find((std::string_view)*expected) ==
+          std::string::npos) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  auto equals = [](ConstString::ConstString const& expected,
+                    std::string const& reported_string) {
+    return (expected.length() == 0) ||
+        ((std::string_view)expected == reported_string);
+  };
+  return equals(vendor, reported.vendor) &&
+      equals(product, reported.product) && equals(revision, reported.revision);
+}
+
 Device::Device(ConstString::ConstString id_, ConstString::ConstString name,
     ConstString::ConstString description, std::vector<Readable> readables_,
     std::vector<Group> subgroups_,
@@ -11,13 +33,14 @@ Device::Device(ConstString::ConstString id_, ConstString::ConstString name,
     int slave_id_, size_t burst_size_, size_t max_retries_, size_t retry_delay_,
     // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
     std::vector<RegisterRange> const& holding_registers_,
-    std::vector<RegisterRange> const& input_registers_)
+    std::vector<RegisterRange> const& input_registers_,
+    std::optional<Identification> identification_)
     : Group{std::move(name), std::move(description), std::move(readables_),
           std::move(subgroups_)},
       id(std::move(id_)), slave_id(slave_id_), burst_size(burst_size_),
       max_retries(max_retries_), retry_delay(retry_delay_),
-      holding_registers(holding_registers_), input_registers(input_registers_) {
-}
+      holding_registers(holding_registers_), input_registers(input_registers_),
+      identification(std::move(identification_)) {}
 
 /// @brief Creates a bus Id (for logging) from Ids of the bus' devices
 ConstString::ConstString busId(
@@ -51,6 +74,9 @@ Bus::Bus(std::vector<Portname> possible_serial_ports_, int baud_,
     size_t inter_use_delay_when_running_,
     size_t inter_device_delay_when_searching_,
     size_t inter_device_delay_when_running_,
+    size_t response_timeout_when_searching_,
+    size_t max_response_timeout_when_searching_,
+    size_t byte_timeout_when_searching_,
     std::vector<Device::NonemptyPtr> devices_)
     : possible_serial_ports(std::move(possible_serial_ports_)), baud(baud_),
       parity(parity_), data_bits(data_bits_), stop_bits(stop_bits_),
@@ -59,8 +85,17 @@ Bus::Bus(std::vector<Portname> possible_serial_ports_, int baud_,
       inter_use_delay_when_running(inter_use_delay_when_running_),
       inter_device_delay_when_searching(inter_device_delay_when_searching_),
       inter_device_delay_when_running(inter_device_delay_when_running_),
+      response_timeout_when_searching(response_timeout_when_searching_),
+      max_response_timeout_when_searching(
+          max_response_timeout_when_searching_),
+      byte_timeout_when_searching(byte_timeout_when_searching_),
       devices(std::move(devices_)), id(busId(devices)) {}
 
 // NOLINTEND(readability-identifier-naming)
 
+SerialSettings serialSettings(Bus const& bus) {
+  return SerialSettings(
+      bus.baud, bus.parity, bus.data_bits, bus.stop_bits, bus.rts_delay);
+}
+
 } // namespace Technology_Adapter::Modbus::Config
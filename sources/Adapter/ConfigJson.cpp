@@ -1,9 +1,11 @@
 #include "internal/ConfigJson.hpp"
 
-#include <cmath>
 #include <fstream>
+#include <map>
+#include <string_view>
+#include <unordered_map>
 
-#include "HSCUL/FloatingPoint.hpp"
+#include "internal/Expression.hpp"
 
 namespace Technology_Adapter::Modbus::Config {
 
@@ -11,18 +13,6 @@ using List = std::vector<json>;
 
 namespace {
 
-// Lifts conversion from `std::string` to `ConstString` to vectors
-std::vector<ConstString::ConstString> constStringVector(
-    std::vector<std::string> const& strings) {
-
-  std::vector<ConstString::ConstString> result;
-  result.reserve(strings.size());
-  for (auto const& string : strings) {
-    result.emplace_back(string);
-  }
-  return result;
-}
-
 // Like `json.at(field_name).get<T>()`, but with `default_value`
 template <class T>
 T readWithDefault(json const& json, char const* field_name, T default_value) {
@@ -31,88 +21,28 @@ T readWithDefault(json const& json, char const* field_name, T default_value) {
       : default_value;
 }
 
-// NOLINTNEXTLINE(cert-err58-cpp)
-TypedDecoder float_decoder{
-    [](std::vector<uint16_t> const& registers)
-        -> Information_Model::DataVariant {
-      //
-      // Convert 16-bit registers to bytes
-      size_t num_registers = registers.size();
-      std::vector<uint8_t> bytes;
-      bytes.reserve(2 * num_registers);
-      for (auto register_value : registers) {
-        bytes.push_back(register_value);
-        // NOLINTNEXTLINE(readability-magic-numbers)
-        bytes.push_back(register_value >> 8);
-      }
-
-      switch (num_registers) {
-      case 2:
-        return HSCUL::toFloat(bytes, HSCUL::ByteOrder::LSB_First);
-      case 4:
-        return HSCUL::toDouble(bytes, HSCUL::ByteOrder::LSB_First);
-      default:
-        throw std::runtime_error(
-            "In float decoder: Unsupported size for IEEE 754");
-      }
-    },
-    Information_Model::DataType::Double,
-};
-
-template <class Iterator>
-uint64_t decodeUnsigned(Iterator const& begin, Iterator const& end) {
-  uint64_t value = 0;
-  unsigned shift = 0;
-  Iterator it = begin;
-  while (it != end) {
-    uint16_t register_value = *it;
-    value |= ((uint64_t)register_value) << shift;
-    shift += 16; // NOLINT(readability-magic-numbers)
-    ++it;
-  }
-  return value;
-}
-
-// If we had C++20, we could just use `decodeUnsigned` and convert
-template <class Iterator>
-int64_t decodeSigned(Iterator const& begin, Iterator const& end) {
-  /*
-    In the following, we use `+` instead of `|` because it is unclear (at least
-    to the author) whether `|` is defined for negative numbers.
-  */
-  int64_t value = 0;
-  unsigned shift = 0;
-  bool negative = false;
-  Iterator it = begin;
-  while (it != end) {
-    uint16_t register_value = *it;
-    // NOLINTNEXTLINE(readability-magic-numbers)
-    negative = (register_value & 32768) != 0;
-    value += ((int64_t)((uint32_t)register_value)) << shift;
-    shift += 16; // NOLINT(readability-magic-numbers)
-    ++it;
-  }
-  // Promote the sign to unread bits
-  if (negative) {
-    while (shift < 64) { // NOLINT(readability-magic-numbers)
-      value += 65535L << shift; // NOLINT(readability-magic-numbers)
-      shift += 16; // NOLINT(readability-magic-numbers)
-    }
+// Reads the optional `"byte_order"` of a decoder
+Decoder::ByteOrder byteOrderOfJson(json const& json) {
+  auto name = readWithDefault<std::string>(json, "byte_order", "big_endian");
+  if (name == "big_endian") {
+    return Decoder::ByteOrder::BigEndian;
+  } else if (name == "little_endian") {
+    return Decoder::ByteOrder::LittleEndian;
+  } else {
+    throw std::runtime_error("Could not parse byte order " + name);
   }
-  return value;
 }
 
-// used by `mantissa/exponent` decoder
-int narrowExponent(int64_t exponent) {
-  if ((exponent > std::numeric_limits<int>::max()) ||
-      (exponent < std::numeric_limits<int>::min())) {
-    // As we are talking about an exponent, the value would most likely not be
-    // meaningful anyway.
-    throw std::runtime_error("Exponent out of range");
+// Reads the optional `"word_order"` of a decoder
+Decoder::WordOrder wordOrderOfJson(json const& json) {
+  auto name = readWithDefault<std::string>(json, "word_order", "little_endian");
+  if (name == "little_endian") {
+    return Decoder::WordOrder::LittleEndian;
+  } else if (name == "big_endian") {
+    return Decoder::WordOrder::BigEndian;
+  } else {
+    throw std::runtime_error("Could not parse word order " + name);
   }
-  // We have just checked that the value can be represented. Hence:
-  // NOLINTNEXTLINE(bugprone-narrowing-conversions)
-  return exponent;
 }
 
 } // namespace
@@ -140,205 +70,410 @@ RegisterRange RegisterRangeOfJson(json const& json) {
 TypedDecoder DecoderOfJson(json const& json) {
   auto const& type = json.at("type").get_ref<std::string const&>();
   if (type == "linear") {
-    auto factor = readWithDefault<double>(json, "factor", 1);
-    auto offset = readWithDefault<double>(json, "offset", 0);
-    if (readWithDefault<bool>(json, "signed", false)) {
-      return {
-          [factor, offset](std::vector<uint16_t> const& register_values) {
-            auto base =
-                decodeSigned(register_values.begin(), register_values.end());
-            return ((double)base) * factor + offset;
-          },
-          Information_Model::DataType::Double,
-      };
-    } else {
-      return {
-          [factor, offset](std::vector<uint16_t> const& register_values) {
-            auto base =
-                decodeUnsigned(register_values.begin(), register_values.end());
-            return ((double)base) * factor + offset;
-          },
-          Information_Model::DataType::Double,
-      };
-    }
+    return {
+        Decoder::linear(readWithDefault<bool>(json, "signed", false),
+            readWithDefault<double>(json, "factor", 1),
+            readWithDefault<double>(json, "offset", 0), //
+            byteOrderOfJson(json), wordOrderOfJson(json)),
+        Information_Model::DataType::Double,
+    };
   } else if (type == "float") {
-    return float_decoder;
+    return {
+        Decoder::ieee754(byteOrderOfJson(json), wordOrderOfJson(json)),
+        Information_Model::DataType::Double,
+    };
   } else if (type == "mantissa/exponent") {
-    double base = json.at("base").get<double>();
-    if (readWithDefault<bool>(json, "signed", false)) {
-      return {
-          [base](std::vector<uint16_t> const& register_values) {
-            auto it = register_values.begin();
-            if (it == register_values.end()) {
-              throw std::runtime_error(
-                  "Exponent missing in mantissa/exponent decoding");
-            }
-            ++it;
-            auto exponent =
-                narrowExponent(decodeSigned(register_values.begin(), it));
-            auto mantissa = decodeSigned(it, register_values.end());
-            return ((double)mantissa) * std::pow(base, exponent);
-          },
-          Information_Model::DataType::Double,
-      };
-    } else {
-      return {
-          [base](std::vector<uint16_t> const& register_values) {
-            auto it = register_values.begin();
-            if (it == register_values.end()) {
-              throw std::runtime_error(
-                  "Exponent missing in mantissa/exponent decoding");
-            }
-            ++it;
-            auto exponent =
-                narrowExponent(decodeSigned(register_values.begin(), it));
-            auto mantissa = decodeUnsigned(it, register_values.end());
-            return ((double)mantissa) * std::pow(base, exponent);
-          },
-          Information_Model::DataType::Double,
-      };
-    }
+    return {
+        Decoder::mantissaExponent(readWithDefault<bool>(json, "signed", false),
+            json.at("base").get<double>()),
+        Information_Model::DataType::Double,
+    };
   } else {
     throw std::runtime_error("Unsupported decoder type " + type);
   }
 }
 
-Readable ReadableOfJson(json const& json) {
-  auto decoder = DecoderOfJson(json.at("decoder"));
-
-  return Readable{
-      ConstString::ConstString(json.at("name").get<std::string>()), //
-      ConstString::ConstString(json.at("description").get<std::string>()), //
-      decoder.return_type, //
-      json.at("registers").get<std::vector<int>>(), //
-      decoder.decoder,
-  };
+CachePolicy CachePolicyOfJson(json const& json) {
+  if (json.is_object()) {
+    return CachePolicy{
+        CachePolicy::Kind::Ttl, json.at("ttl_ms").get<size_t>()};
+  }
+  auto const& name = json.get_ref<std::string const&>();
+  if (name == "none") {
+    return CachePolicy{CachePolicy::Kind::None};
+  } else if (name == "constant") {
+    return CachePolicy{CachePolicy::Kind::Constant};
+  } else {
+    throw std::runtime_error("Could not parse cache policy " + name);
+  }
 }
 
+namespace {
+
 /*
-  Extracts `Readable`s from `json` using `ReadableOfJson`.
+  Parses the parts of a single configuration, such that they share what they
+  have in common: Equal strings share one `ConstString` and equal decoder
+  objects share one `Decoder`, including the table of powers of a
+  mantissa/exponent decoder. Child vectors are allocated at their exact size
+  rather than grown. This saves most of the small allocations of large
+  configurations, which are otherwise repeated per readable.
+
+  The functions are as the public `...OfJson` functions.
+*/
+class Parser {
+public:
+  Readable readable(json const& json, ReadablesByName const& device_readables) {
+    auto cache = json.count("cache") > 0 //
+        ? CachePolicyOfJson(json.at("cache"))
+        : CachePolicy{};
+
+    if (json.count("expression") > 0) {
+      if ((json.count("registers") > 0) || (json.count("decoder") > 0)) {
+        throw std::runtime_error(
+            "A readable with an expression has no registers or decoder");
+      }
+      auto expression = std::make_shared<Expression const>(Expression::compile(
+          json.at("expression").get<std::string>(),
+          [&device_readables](std::string const& name) -> Readable const& {
+            auto readable = device_readables.find(name);
+            if (readable == device_readables.end()) {
+              throw std::runtime_error("Unknown readable " + name);
+            }
+            if (!readable->second.has_value()) {
+              throw std::runtime_error("Ambiguous readable " + name);
+            }
+            return *readable->second;
+          }));
+
+      return Readable{
+          string(json.at("name")), //
+          string(json.at("description")), //
+          Information_Model::DataType::Double, //
+          expression->registers(), //
+          Decoder::expression(expression), //
+          cache,
+      };
+    }
 
-  `json` is expected to be as for `GroupOfJson`.
+    auto const& decoder = this->decoder(json.at("decoder"));
 
-  @throws `std::runtime_error
-  @throws whatever `nlohmann/json` throws
-*/
-std::vector<Readable> readablesOfJson(json const& json) {
-  std::vector<Readable> readables;
-  auto const& elements = json.at("elements").get_ref<List const&>();
-  for (auto const& element : elements) {
-    auto const& type = element.at("element_type").get_ref<std::string const&>();
-    if (type == "readable") {
-      readables.push_back(ReadableOfJson(element));
-    } else if (type == "group") {
-    } else {
-      throw std::runtime_error("Unsupported element type " + type);
+    return Readable{
+        string(json.at("name")), //
+        string(json.at("description")), //
+        decoder.return_type, //
+        json.at("registers").get<std::vector<int>>(), //
+        decoder.decoder, //
+        cache,
+    };
+  }
+
+  Group group(json const& json, ReadablesByName const& device_readables) {
+    return Group{
+        string(json.at("name")),
+        string(json.at("description")),
+        readables(json, device_readables),
+        subgroups(json, device_readables),
+    };
+  }
+
+  Device::NonemptyPtr device(json const& json) {
+    auto const& holding_registers_json =
+        json.at("holding_registers").get_ref<List const&>();
+    std::vector<RegisterRange> holding_registers;
+    holding_registers.reserve(holding_registers_json.size());
+    for (auto const& range : holding_registers_json) {
+      holding_registers.push_back(RegisterRangeOfJson(range));
     }
+
+    auto const& input_registers_json =
+        json.at("input_registers").get_ref<List const&>();
+    std::vector<RegisterRange> input_registers;
+    input_registers.reserve(input_registers_json.size());
+    for (auto const& range : input_registers_json) {
+      input_registers.push_back(RegisterRangeOfJson(range));
+    }
+
+    ReadablesByName device_readables;
+    collectReadables(json, device_readables);
+
+    return Device::NonemptyPtr::make( //
+        string(json.at("id")), //
+        string(json.at("name")), //
+        string(json.at("description")), //
+        readables(json, device_readables),
+        subgroups(json, device_readables),
+        json.at("slave_id").get<int>(), //
+        json.at("burst_size").get<size_t>(), //
+        readWithDefault<size_t>(json, "max_retries", 3), //
+        readWithDefault<size_t>(json, "retry_delay", 0), //
+        holding_registers, input_registers,
+        json.count("identification") > 0
+            ? std::optional(IdentificationOfJson(json.at("identification")))
+            : std::nullopt);
   }
-  return readables;
-}
 
-/*
-  Extracts `Group`s from `json` using `ReadableOfJson`.
+  Bus::NonemptyPtr bus(json const& json) {
+    std::vector<Device::NonemptyPtr> devices;
+    auto const& devices_json = json.at("devices").get_ref<List const&>();
+    devices.reserve(devices_json.size());
+    for (auto const& device : devices_json) {
+      devices.push_back(this->device(device));
+    }
 
-  `json` is expected to be as for `GroupOfJson`.
+    auto const& ports_json =
+        json.at("possible_serial_ports").get_ref<List const&>();
+    std::vector<Portname> ports;
+    ports.reserve(ports_json.size());
+    for (auto const& port : ports_json) {
+      ports.push_back(string(port));
+    }
 
-  @throws `std::runtime_error
-  @throws whatever `nlohmann/json` throws
-*/
-std::vector<Group> subgroupsOfJson(json const& json) {
-  std::vector<Group> subgroups;
-  auto const& elements = json.at("elements").get_ref<List const&>();
-  for (auto const& element : elements) {
-    auto const& type = element.at("element_type").get_ref<std::string const&>();
-    if (type == "readable") {
-    } else if (type == "group") {
-      subgroups.push_back(GroupOfJson(element));
-    } else {
-      throw std::runtime_error("Unsupported element type " + type);
+    return Bus::NonemptyPtr::make( //
+        std::move(ports), //
+        json.at("baud").get<int>(), //
+        ParityOfJson(json.at("parity")), //
+        json.at("data_bits").get<int>(), //
+        json.at("stop_bits").get<int>(), //
+        readWithDefault<size_t>(json, "rts_delay", 0), //
+        readWithDefault<size_t>(json, "inter_use_delay_when_searching", 0), //
+        readWithDefault<size_t>(json, "inter_use_delay_when_running", 0), //
+        readWithDefault<size_t>(
+            json, "inter_device_delay_when_searching", 0), //
+        readWithDefault<size_t>(json, "inter_device_delay_when_running", 0), //
+        readWithDefault<size_t>(json, "response_timeout_when_searching", 0), //
+        readWithDefault<size_t>(
+            json, "max_response_timeout_when_searching", 0), //
+        readWithDefault<size_t>(json, "byte_timeout_when_searching", 0), //
+        devices);
+  }
+
+private:
+  // The interned string of `json`, which must be of JSON type `string`
+  ConstString::ConstString string(json const& json) {
+    auto const& value = json.get_ref<std::string const&>();
+    auto interned = strings_.find(value);
+    if (interned != strings_.end()) {
+      return interned->second;
     }
+    ConstString::ConstString result(value);
+    strings_.emplace((std::string_view)result, result);
+    return result;
   }
-  return subgroups;
-}
 
-Group GroupOfJson(json const& json) {
-  return Group{
-      ConstString::ConstString(json.at("name").get<std::string>()),
-      ConstString::ConstString(json.at("description").get<std::string>()),
-      readablesOfJson(json),
-      subgroupsOfJson(json),
-  };
-}
+  // The shared decoder of `json`
+  TypedDecoder const& decoder(json const& json) {
+    auto decoder = decoders_.find(json);
+    if (decoder == decoders_.end()) {
+      decoder = decoders_.emplace(json, DecoderOfJson(json)).first;
+    }
+    return decoder->second;
+  }
 
-Device::NonemptyPtr DeviceOfJson(json const& json) {
-  auto const& holding_registers_json =
-      json.at("holding_registers").get_ref<List const&>();
-  std::vector<RegisterRange> holding_registers;
-  holding_registers.reserve(holding_registers_json.size());
-  for (auto const& range : holding_registers_json) {
-    holding_registers.push_back(RegisterRangeOfJson(range));
+  /*
+    Extracts `Readable`s from `json` using `readable`.
+
+    `json` is expected to be as for `GroupOfJson`.
+  */
+  std::vector<Readable> readables(
+      json const& json, ReadablesByName const& device_readables) {
+
+    auto const& elements = json.at("elements").get_ref<List const&>();
+    std::vector<Readable> readables;
+    readables.reserve(count(elements, "readable"));
+    for (auto const& element : elements) {
+      if (element.at("element_type").get_ref<std::string const&>() ==
+          "readable") {
+        readables.push_back(collected(element, device_readables));
+      }
+    }
+    return readables;
+  }
+
+  // `readable`, unless `collectReadables` has already parsed `json`
+  Readable collected(
+      json const& json, ReadablesByName const& device_readables) {
+
+    auto parsed = collected_.find(&json);
+    if (parsed == collected_.end()) {
+      return readable(json, device_readables);
+    }
+    Readable result = std::move(parsed->second);
+    collected_.erase(parsed);
+    return result;
+  }
+
+  /*
+    Extracts `Group`s from `json` using `group`.
+
+    `json` is expected to be as for `GroupOfJson`.
+  */
+  std::vector<Group> subgroups(
+      json const& json, ReadablesByName const& device_readables) {
+
+    auto const& elements = json.at("elements").get_ref<List const&>();
+    std::vector<Group> subgroups;
+    subgroups.reserve(count(elements, "group"));
+    for (auto const& element : elements) {
+      if (element.at("element_type").get_ref<std::string const&>() ==
+          "group") {
+        subgroups.push_back(group(element, device_readables));
+      }
+    }
+    return subgroups;
+  }
+
+  /*
+    The number of `elements` of `element_type` `type`.
+
+    @throws `std::runtime_error` if some element has an unsupported type
+  */
+  static size_t count(List const& elements, char const* type) {
+    size_t count = 0;
+    for (auto const& element : elements) {
+      auto const& element_type =
+          element.at("element_type").get_ref<std::string const&>();
+      if (element_type == type) {
+        ++count;
+      } else if ((element_type != "readable") && (element_type != "group")) {
+        throw std::runtime_error("Unsupported element type " + element_type);
+      }
+    }
+    return count;
   }
 
-  auto const& input_registers_json =
-      json.at("input_registers").get_ref<List const&>();
-  std::vector<RegisterRange> input_registers;
-  input_registers.reserve(input_registers_json.size());
-  for (auto const& range : input_registers_json) {
-    input_registers.push_back(RegisterRangeOfJson(range));
+  /*
+    Adds the non-derived readables in `json` and its subgroups to `readables`.
+    Each is parsed only once, as `collected` returns it again.
+
+    `json` is expected to be as for `GroupOfJson`.
+  */
+  void collectReadables(json const& json, ReadablesByName& readables) {
+    auto const& elements = json.at("elements").get_ref<List const&>();
+    for (auto const& element : elements) {
+      auto const& type =
+          element.at("element_type").get_ref<std::string const&>();
+      if (type == "readable") {
+        if (element.count("expression") == 0) {
+          auto const& parsed =
+              collected_.emplace(&element, readable(element, {})).first->second;
+          auto name = element.at("name").get<std::string>();
+          auto inserted = readables.emplace(name, parsed);
+          if (!inserted.second) {
+            inserted.first->second.reset();
+          }
+        }
+      } else if (type == "group") {
+        collectReadables(element, readables);
+      }
+    }
   }
 
-  return Device::NonemptyPtr::make( //
-      ConstString::ConstString(json.at("id").get<std::string>()), //
-      ConstString::ConstString(json.at("name").get<std::string>()), //
-      ConstString::ConstString(json.at("description").get<std::string>()), //
-      readablesOfJson(json), subgroupsOfJson(json),
-      json.at("slave_id").get<int>(), //
-      json.at("burst_size").get<size_t>(), //
-      readWithDefault<size_t>(json, "max_retries", 3), //
-      readWithDefault<size_t>(json, "retry_delay", 0), //
-      holding_registers, input_registers);
+  // Views into the values, which stay in place
+  std::unordered_map<std::string_view, ConstString::ConstString> strings_;
+
+  std::map<nlohmann::json, TypedDecoder> decoders_;
+
+  // Readables parsed by `collectReadables`, until `collected` takes them
+  std::unordered_map<json const*, Readable> collected_;
+};
+
+} // namespace
+
+Readable ReadableOfJson(
+    json const& json, ReadablesByName const& device_readables) {
+
+  return Parser().readable(json, device_readables);
+}
+
+Group GroupOfJson(json const& json, ReadablesByName const& device_readables) {
+  return Parser().group(json, device_readables);
 }
 
-Bus::NonemptyPtr BusOfJson(json const& json) {
-  std::vector<Device::NonemptyPtr> devices;
-  auto const& devices_json = json.at("devices").get_ref<List const&>();
-  devices.reserve(devices_json.size());
-  for (auto const& device : devices_json) {
-    devices.push_back(DeviceOfJson(device));
+Identification IdentificationOfJson(json const& json) {
+  Identification identification{
+      ConstString::ConstString(readWithDefault<std::string>(json, "vendor", "")),
+      ConstString::ConstString(
+          readWithDefault<std::string>(json, "product", "")),
+      ConstString::ConstString(
+          readWithDefault<std::string>(json, "revision", "")),
+  };
+  if ((identification.vendor.length() == 0) &&
+      (identification.product.length() == 0) &&
+      (identification.revision.length() == 0)) {
+    throw std::runtime_error(
+        "identification needs a vendor, product, or revision");
   }
+  return identification;
+}
 
-  return Bus::NonemptyPtr::make( //
-      constStringVector(
-          json.at("possible_serial_ports").get<std::vector<std::string>>()),
-      json.at("baud").get<int>(), //
-      ParityOfJson(json.at("parity")), //
-      json.at("data_bits").get<int>(), //
-      json.at("stop_bits").get<int>(), //
-      readWithDefault<size_t>(json, "rts_delay", 0), //
-      readWithDefault<size_t>(json, "inter_use_delay_when_searching", 0), //
-      readWithDefault<size_t>(json, "inter_use_delay_when_running", 0), //
-      readWithDefault<size_t>(json, "inter_device_delay_when_searching", 0), //
-      readWithDefault<size_t>(json, "inter_device_delay_when_running", 0), //
-      devices);
+Device::NonemptyPtr DeviceOfJson(json const& json) {
+  return Parser().device(json);
 }
 
+Bus::NonemptyPtr BusOfJson(json const& json) { return Parser().bus(json); }
+
 Buses BusesOfJson(json const& json) {
+  Parser parser;
   Buses buses;
   auto const& buses_json = json.get_ref<List const&>();
+  buses.reserve(buses_json.size());
   for (auto const& bus_json : buses_json) {
-    buses.push_back(BusOfJson(bus_json));
+    buses.push_back(parser.bus(bus_json));
   }
   return buses;
 }
 
-Buses loadConfig(ConstString::ConstString const& file_path) {
+PortDetection PortDetectionOfJson(json const& json) {
+  PortDetection port_detection;
+  port_detection.max_concurrent_probes = readWithDefault(json,
+      "max_concurrent_probes", port_detection.max_concurrent_probes);
+  if (port_detection.max_concurrent_probes == 0) {
+    throw std::runtime_error("max_concurrent_probes must be positive");
+  }
+  port_detection.state_file =
+      readWithDefault(json, "state_file", port_detection.state_file);
+  port_detection.direct_connect =
+      readWithDefault(json, "direct_connect", port_detection.direct_connect);
+  port_detection.watch_hotplug =
+      readWithDefault(json, "watch_hotplug", port_detection.watch_hotplug);
+  port_detection.backoff_initial =
+      readWithDefault(json, "backoff_initial", port_detection.backoff_initial);
+  port_detection.backoff_max =
+      readWithDefault(json, "backoff_max", port_detection.backoff_max);
+  if (port_detection.backoff_max < port_detection.backoff_initial) {
+    throw std::runtime_error("backoff_max must be at least backoff_initial");
+  }
+  port_detection.backoff_jitter =
+      readWithDefault(json, "backoff_jitter", port_detection.backoff_jitter);
+  if ((port_detection.backoff_jitter < 0) ||
+      (port_detection.backoff_jitter > 1)) {
+    throw std::runtime_error("backoff_jitter must be between 0 and 1");
+  }
+  port_detection.min_attempt_interval = readWithDefault(
+      json, "min_attempt_interval", port_detection.min_attempt_interval);
+  return port_detection;
+}
+
+Adapter AdapterOfJson(json const& json) {
+  if (json.is_array()) {
+    return Adapter{BusesOfJson(json), PortDetection()};
+  }
+  return Adapter{
+      BusesOfJson(json.at("buses")),
+      json.count("port_detection") > 0
+          ? PortDetectionOfJson(json.at("port_detection"))
+          : PortDetection(),
+  };
+}
+
+Adapter loadConfig(ConstString::ConstString const& file_path) {
   std::ifstream input_stream(file_path.c_str());
   if (!input_stream) {
     throw std::runtime_error(("Could not open " + file_path).c_str());
   }
   nlohmann::json json;
   input_stream >> json;
-  return BusesOfJson(json);
+  return AdapterOfJson(json);
 }
 
 } // namespace Technology_Adapter::Modbus::Config
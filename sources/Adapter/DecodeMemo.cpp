@@ -0,0 +1,58 @@
+#include "internal/DecodeMemo.hpp"
+
+namespace Technology_Adapter::Modbus {
+
+DecodeMemo::DecodeMemo(size_t num_registers) : raw_(num_registers) {}
+
+Information_Model::DataVariant DecodeMemo::decode(
+    Config::Decoder const& decoder, uint16_t const* registers,
+    size_t const* indices) {
+
+  {
+    std::lock_guard lock(mutex_);
+    if (same(registers, indices)) {
+      changed_ = false;
+      return value_;
+    }
+  }
+
+  // Throws before anything is remembered
+  auto value = decoder(registers, indices, raw_.size());
+
+  std::lock_guard lock(mutex_);
+  if (same(registers, indices)) {
+    // A concurrent `decode` has remembered these raw values meanwhile
+    changed_ = false;
+  } else {
+    size_t num_registers = raw_.size();
+    for (size_t i = 0; i < num_registers; ++i) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      raw_[i] = registers[indices[i]];
+    }
+    value_ = value;
+    valid_ = true;
+    changed_ = true;
+    ++change_count_;
+  }
+  return value;
+}
+
+bool DecodeMemo::changed() const { return changed_; }
+
+uint64_t DecodeMemo::changeCount() const { return change_count_; }
+
+bool DecodeMemo::same(uint16_t const* registers, size_t const* indices) const {
+  if (!valid_) {
+    return false;
+  }
+  size_t num_registers = raw_.size();
+  for (size_t i = 0; i < num_registers; ++i) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    if (registers[indices[i]] != raw_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace Technology_Adapter::Modbus
@@ -0,0 +1,604 @@
+#include "internal/Decoder.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "internal/Expression.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define MODBUS_DECODER_SIMD
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MODBUS_DECODER_SIMD
+#endif
+
+namespace Technology_Adapter::Modbus::Config {
+
+namespace {
+
+// Registers `begin` to `end` (exclusive) of `registers`
+template <class Registers>
+uint64_t decodeUnsigned(Registers const& registers, size_t begin, size_t end) {
+  uint64_t value = 0;
+  unsigned shift = 0;
+  for (size_t i = begin; i < end; ++i) {
+    value |= ((uint64_t)registers[i]) << shift;
+    shift += 16; // NOLINT(readability-magic-numbers)
+  }
+  return value;
+}
+
+// If we had C++20, we could just use `decodeUnsigned` and convert
+template <class Registers>
+int64_t decodeSigned(Registers const& registers, size_t begin, size_t end) {
+  /*
+    In the following, we use `+` instead of `|` because it is unclear (at least
+    to the author) whether `|` is defined for negative numbers.
+  */
+  int64_t value = 0;
+  unsigned shift = 0;
+  bool negative = false;
+  for (size_t i = begin; i < end; ++i) {
+    uint16_t register_value = registers[i];
+    // NOLINTNEXTLINE(readability-magic-numbers)
+    negative = (register_value & 32768) != 0;
+    value += ((int64_t)((uint32_t)register_value)) << shift;
+    shift += 16; // NOLINT(readability-magic-numbers)
+  }
+  // Promote the sign to unread bits
+  if (negative) {
+    while (shift < 64) { // NOLINT(readability-magic-numbers)
+      value += 65535L << shift; // NOLINT(readability-magic-numbers)
+      shift += 16; // NOLINT(readability-magic-numbers)
+    }
+  }
+  return value;
+}
+
+// used by `mantissa/exponent` decoder
+int narrowExponent(int64_t exponent) {
+  if ((exponent > std::numeric_limits<int>::max()) ||
+      (exponent < std::numeric_limits<int>::min())) {
+    // As we are talking about an exponent, the value would most likely not be
+    // meaningful anyway.
+    throw std::runtime_error("Exponent out of range");
+  }
+  // We have just checked that the value can be represented. Hence:
+  // NOLINTNEXTLINE(bugprone-narrowing-conversions)
+  return exponent;
+}
+
+/*
+  Reinterprets the little endian `registers` as an IEEE 754 type.
+  `Float` and `Bits` must have the same size, which is that of `registers`.
+*/
+template <class Float, class Bits, class Registers>
+double ieee754Of(Registers const& registers) {
+  static_assert(sizeof(Float) == sizeof(Bits));
+  Bits bits = 0;
+  for (size_t i = 0; i < sizeof(Bits) / sizeof(uint16_t); ++i) {
+    bits |= ((Bits)registers[i]) << (16 * i); // NOLINT(readability-magic-numbers)
+  }
+  Float value = 0;
+  std::memcpy(&value, &bits, sizeof(Float));
+  return value;
+}
+
+/*
+  `Registers` given in `byte_order` and `word_order`, presented in the
+  standard order, i.e., with big endian bytes and little endian words
+*/
+template <Decoder::ByteOrder byte_order, Decoder::WordOrder word_order,
+    class Registers>
+struct Ordered {
+  Registers const& registers;
+  size_t num_registers;
+
+  uint16_t operator[](size_t i) const {
+    uint16_t value = word_order == Decoder::WordOrder::LittleEndian
+        ? registers[i]
+        : registers[num_registers - 1 - i];
+    if constexpr (byte_order == Decoder::ByteOrder::LittleEndian) {
+      // NOLINTNEXTLINE(readability-magic-numbers)
+      value = (uint16_t)((value << 8) | (value >> 8));
+    }
+    return value;
+  }
+};
+
+#if defined(MODBUS_DECODER_SIMD)
+
+/*
+  Helpers for `Decoder::decodeBatch`, which decodes four lanes at a time.
+  A `Quad` holds the four resulting `double`s.
+*/
+
+#if defined(__AVX__)
+
+struct Quad {
+  __m256d value;
+};
+
+Quad quadOfInt32s(__m128i values) { return {_mm256_cvtepi32_pd(values)}; }
+Quad quadOfFloats(__m128 values) { return {_mm256_cvtps_pd(values)}; }
+Quad quadOf(double value) { return {_mm256_set1_pd(value)}; }
+Quad operator+(Quad x, Quad y) { return {_mm256_add_pd(x.value, y.value)}; }
+Quad operator*(Quad x, Quad y) { return {_mm256_mul_pd(x.value, y.value)}; }
+
+/*
+  `x * y + z`, as a single expression like in the scalar kernel. Hence the
+  compiler contracts it into a fused multiply-add if and only if it does so
+  for the scalar kernel, and the results agree.
+*/
+Quad multiplyAdd(Quad x, Quad y, Quad z) {
+#if defined(__GNUC__)
+  return {x.value * y.value + z.value};
+#else
+  return x * y + z;
+#endif
+}
+
+void store(double* destination, Quad x) {
+  _mm256_storeu_pd(destination, x.value);
+}
+
+#else
+
+struct Quad {
+  __m128d low;
+  __m128d high;
+};
+
+Quad quadOfInt32s(__m128i values) {
+  return {_mm_cvtepi32_pd(values),
+      // NOLINTNEXTLINE(readability-magic-numbers)
+      _mm_cvtepi32_pd(_mm_shuffle_epi32(values, 0xEE))};
+}
+
+Quad quadOfFloats(__m128 values) {
+  return {_mm_cvtps_pd(values), _mm_cvtps_pd(_mm_movehl_ps(values, values))};
+}
+
+Quad quadOf(double value) { return {_mm_set1_pd(value), _mm_set1_pd(value)}; }
+
+Quad operator+(Quad x, Quad y) {
+  return {_mm_add_pd(x.low, y.low), _mm_add_pd(x.high, y.high)};
+}
+
+Quad operator*(Quad x, Quad y) {
+  return {_mm_mul_pd(x.low, y.low), _mm_mul_pd(x.high, y.high)};
+}
+
+// As for AVX. Without AVX, there is no fused multiply-add to contract into
+Quad multiplyAdd(Quad x, Quad y, Quad z) { return x * y + z; }
+
+void store(double* destination, Quad x) {
+  _mm_storeu_pd(destination, x.low);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  _mm_storeu_pd(destination + 2, x.high);
+}
+
+#endif
+
+// Four register values from `row` in the low 64 bits, in standard byte order
+template <Decoder::ByteOrder byte_order>
+__m128i load16s(uint16_t const* row) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  __m128i values = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(row));
+  if constexpr (byte_order == Decoder::ByteOrder::LittleEndian) {
+    // NOLINTNEXTLINE(readability-magic-numbers)
+    values = _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8));
+  }
+  return values;
+}
+
+// Four register values from `row` as 32 bit integers
+template <Decoder::ByteOrder byte_order, bool is_signed>
+__m128i loadInt32s(uint16_t const* row) {
+  __m128i values = load16s<byte_order>(row);
+  if constexpr (is_signed) {
+    // NOLINTNEXTLINE(readability-magic-numbers)
+    return _mm_srai_epi32(_mm_unpacklo_epi16(_mm_setzero_si128(), values), 16);
+  } else {
+    return _mm_unpacklo_epi16(values, _mm_setzero_si128());
+  }
+}
+
+/*
+  The integers in `num_rows` rows from `lane` on, least significant first.
+  Only the most significant row is signed, if `is_signed`. Exact for up to
+  three rows.
+*/
+template <Decoder::ByteOrder byte_order, bool is_signed>
+Quad integerQuad(uint16_t const* const* rows, size_t num_rows, size_t lane) {
+  Quad value = quadOf(0);
+  double weight = 1;
+  for (size_t i = 0; i < num_rows; ++i) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    uint16_t const* row = rows[i] + lane;
+    __m128i integers = (is_signed && (i + 1 == num_rows))
+        ? loadInt32s<byte_order, true>(row)
+        : loadInt32s<byte_order, false>(row);
+    value = value + quadOfInt32s(integers) * quadOf(weight);
+    weight *= 65536; // NOLINT(readability-magic-numbers)
+  }
+  return value;
+}
+
+// Four IEEE 754 Singles from two rows, least significant first
+template <Decoder::ByteOrder byte_order>
+Quad singleQuad(uint16_t const* const* rows, size_t lane) {
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  __m128i bits = _mm_unpacklo_epi16(
+      load16s<byte_order>(rows[0] + lane), load16s<byte_order>(rows[1] + lane));
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  return quadOfFloats(_mm_castsi128_ps(bits));
+}
+
+// Stores four IEEE 754 Doubles from four rows, least significant first
+template <Decoder::ByteOrder byte_order>
+void storeDoubles(uint16_t const* const* rows, size_t lane, double* values) {
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  __m128i low = _mm_unpacklo_epi16(
+      load16s<byte_order>(rows[0] + lane), load16s<byte_order>(rows[1] + lane));
+  __m128i high = _mm_unpacklo_epi16(
+      load16s<byte_order>(rows[2] + lane), load16s<byte_order>(rows[3] + lane));
+  _mm_storeu_pd(values + lane, _mm_castsi128_pd(_mm_unpacklo_epi32(low, high)));
+  _mm_storeu_pd(
+      values + lane + 2, _mm_castsi128_pd(_mm_unpackhi_epi32(low, high)));
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+#endif
+
+} // namespace
+
+Decoder Decoder::linear(bool is_signed, double factor, double offset,
+    ByteOrder byte_order, WordOrder word_order) {
+
+  return Decoder(
+      Kind::Linear, is_signed, factor, offset, 0, byte_order, word_order);
+}
+
+Decoder Decoder::ieee754(ByteOrder byte_order, WordOrder word_order) {
+  return Decoder(Kind::Float, false, 1, 0, 0, byte_order, word_order);
+}
+
+Decoder Decoder::mantissaExponent(bool is_signed, double base) {
+  return Decoder(Kind::MantissaExponent, is_signed, 1, 0, base,
+      ByteOrder::BigEndian, WordOrder::LittleEndian);
+}
+
+Decoder Decoder::expression(std::shared_ptr<Expression const> expression) {
+  Decoder decoder(Kind::Expression, false, 1, 0, 0, ByteOrder::BigEndian,
+      WordOrder::LittleEndian);
+  decoder.expression_ = std::move(expression);
+  return decoder;
+}
+
+Decoder::Kind Decoder::kind() const { return kind_; }
+
+struct Decoder::Gathered {
+  uint16_t const* registers;
+  size_t const* indices;
+
+  uint16_t operator[](size_t i) const {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return registers[indices[i]];
+  }
+};
+
+struct Decoder::Strided {
+  uint16_t const* registers;
+  size_t stride;
+
+  uint16_t operator[](size_t i) const {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return registers[i * stride];
+  }
+};
+
+struct Decoder::Kernels {
+  // The kernel for `kind` and `is_signed` on registers in standard order
+  template <Kind kind, bool is_signed, class Registers>
+  static double decode(Decoder const& decoder, Registers const& registers,
+      size_t num_registers) {
+
+    if constexpr (kind == Kind::Linear) {
+      double integer = is_signed
+          ? (double)decodeSigned(registers, 0, num_registers)
+          : (double)decodeUnsigned(registers, 0, num_registers);
+      return integer * decoder.factor_ + decoder.offset_;
+    } else if constexpr (kind == Kind::Float) {
+      switch (num_registers) {
+      case 2:
+        return ieee754Of<float, uint32_t>(registers);
+      case 4:
+        return ieee754Of<double, uint64_t>(registers);
+      default:
+        throw std::runtime_error(
+            "In float decoder: Unsupported size for IEEE 754");
+      }
+    } else if constexpr (kind == Kind::MantissaExponent) {
+      if (num_registers == 0) {
+        throw std::runtime_error(
+            "Exponent missing in mantissa/exponent decoding");
+      }
+      auto exponent = narrowExponent(decodeSigned(registers, 0, 1));
+      double mantissa = is_signed
+          ? (double)decodeSigned(registers, 1, num_registers)
+          : (double)decodeUnsigned(registers, 1, num_registers);
+      return mantissa * decoder.power(exponent);
+    } else {
+      static_assert(kind == Kind::Expression);
+      if (num_registers != decoder.expression_->registers().size()) {
+        throw std::runtime_error("Wrong number of registers for expression");
+      }
+      // `Expression::evaluate` needs the values next to each other
+      std::array<uint16_t, Expression::MAX_REGISTERS> values{};
+      for (size_t i = 0; i < num_registers; ++i) {
+        values[i] = registers[i];
+      }
+      return decoder.expression_->evaluate(values.data());
+    }
+  }
+
+  // The kernel for `kind`, `is_signed` and `order`
+  template <Kind kind, bool is_signed, Order order, class Registers>
+  static double run(Decoder const& decoder, Registers const& registers,
+      size_t num_registers) {
+
+    if constexpr (order == Order::Standard) {
+      return decode<kind, is_signed>(decoder, registers, num_registers);
+    } else if constexpr (order == Order::SwappedBytes) {
+      return decode<kind, is_signed>(decoder,
+          Ordered<ByteOrder::LittleEndian, WordOrder::LittleEndian, Registers>{
+              registers, num_registers},
+          num_registers);
+    } else if constexpr (order == Order::SwappedWords) {
+      return decode<kind, is_signed>(decoder,
+          Ordered<ByteOrder::BigEndian, WordOrder::BigEndian, Registers>{
+              registers, num_registers},
+          num_registers);
+    } else {
+      return decode<kind, is_signed>(decoder,
+          Ordered<ByteOrder::LittleEndian, WordOrder::BigEndian, Registers>{
+              registers, num_registers},
+          num_registers);
+    }
+  }
+
+  static Order order(ByteOrder byte_order, WordOrder word_order) {
+    if (word_order == WordOrder::LittleEndian) {
+      return byte_order == ByteOrder::BigEndian ? Order::Standard
+                                                : Order::SwappedBytes;
+    }
+    return byte_order == ByteOrder::BigEndian ? Order::SwappedWords
+                                              : Order::Swapped;
+  }
+
+  /*
+    The SIMD part of `batch`. Decodes the lanes of `block` up to a multiple
+    of four and returns their number, which is 0 if there is no suitable SIMD
+    kernel. Exceptions are left to the scalar kernel.
+  */
+  template <Kind kind, bool is_signed, Order order>
+  static size_t quads([[maybe_unused]] Decoder const& decoder,
+      [[maybe_unused]] Block const& block, [[maybe_unused]] double* values) {
+
+#if defined(MODBUS_DECODER_SIMD)
+    constexpr size_t MAX_ROWS = 4;
+    if constexpr (kind == Kind::Expression) {
+      return 0;
+    } else {
+      size_t num_rows = block.num_registers;
+      if ((kind == Kind::Linear) && (num_rows > 3)) {
+        return 0; // beyond 48 bits, `double` may round differently
+      }
+      if ((kind == Kind::Float) && (num_rows != 2) && (num_rows != 4)) {
+        return 0;
+      }
+      if ((kind == Kind::MantissaExponent) &&
+          ((num_rows == 0) || (num_rows > MAX_ROWS))) {
+        return 0;
+      }
+
+      // rows in standard word order
+      constexpr bool words_swapped =
+          (order == Order::SwappedWords) || (order == Order::Swapped);
+      std::array<uint16_t const*, MAX_ROWS> rows{};
+      for (size_t i = 0; i < num_rows; ++i) {
+        size_t row = words_swapped ? num_rows - 1 - i : i;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        rows[i] = block.registers + row * block.num_lanes;
+      }
+      constexpr auto byte_order =
+          ((order == Order::SwappedBytes) || (order == Order::Swapped))
+          ? ByteOrder::LittleEndian
+          : ByteOrder::BigEndian;
+
+      size_t num_quad_lanes = block.num_lanes - block.num_lanes % 4;
+      for (size_t lane = 0; lane < num_quad_lanes; lane += 4) {
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if constexpr (kind == Kind::Linear) {
+          Quad integer =
+              integerQuad<byte_order, is_signed>(rows.data(), num_rows, lane);
+          store(values + lane,
+              multiplyAdd(integer, quadOf(decoder.factor_),
+                  quadOf(decoder.offset_)));
+        } else if constexpr (kind == Kind::Float) {
+          if (num_rows == 2) {
+            store(values + lane, singleQuad<byte_order>(rows.data(), lane));
+          } else {
+            storeDoubles<byte_order>(rows.data(), lane, values);
+          }
+        } else {
+          // Only the mantissas. The exponents are applied below
+          store(values + lane,
+              integerQuad<byte_order, is_signed>(
+                  rows.data() + 1, num_rows - 1, lane));
+        }
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      }
+
+      if constexpr (kind == Kind::MantissaExponent) {
+        for (size_t lane = 0; lane < num_quad_lanes; ++lane) {
+          // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+          values[lane] *= decoder.power((int16_t)rows[0][lane]);
+          // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+      }
+      return num_quad_lanes;
+    }
+#else
+    return 0;
+#endif
+  }
+
+  // The batch kernel for `kind`, `is_signed` and `order`
+  template <Kind kind, bool is_signed, Order order>
+  static void batch(
+      Decoder const& decoder, Block const& block, double* values) {
+
+    size_t lane = quads<kind, is_signed, order>(decoder, block, values);
+    for (; lane < block.num_lanes; ++lane) {
+      // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      values[lane] = run<kind, is_signed, order, Strided>(decoder,
+          Strided{block.registers + lane, block.num_lanes},
+          block.num_registers);
+      // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+  }
+
+  // `Entry`s of `select`
+  template <class Registers>
+  struct Single {
+    using Pointer = Kernel<Registers>;
+
+    template <Kind kind, bool is_signed, Order order>
+    static Pointer get() {
+      return &run<kind, is_signed, order, Registers>;
+    }
+  };
+
+  struct Batch {
+    using Pointer = BatchKernel;
+
+    template <Kind kind, bool is_signed, Order order>
+    static Pointer get() {
+      return &batch<kind, is_signed, order>;
+    }
+  };
+
+  template <class Entry, Kind kind, bool is_signed>
+  static typename Entry::Pointer select(Order order) {
+    switch (order) {
+    case Order::Standard:
+      return Entry::template get<kind, is_signed, Order::Standard>();
+    case Order::SwappedBytes:
+      return Entry::template get<kind, is_signed, Order::SwappedBytes>();
+    case Order::SwappedWords:
+      return Entry::template get<kind, is_signed, Order::SwappedWords>();
+    case Order::Swapped:
+      return Entry::template get<kind, is_signed, Order::Swapped>();
+    }
+    throw std::logic_error("Unknown decoder order");
+  }
+
+  /*
+    The kernel which `Entry` gives for `kind`, `is_signed` and `order`.
+
+    The mantissa/exponent layout has no byte or word order, floats have no
+    sign, and expressions read raw registers
+  */
+  template <class Entry>
+  static typename Entry::Pointer select(
+      Kind kind, bool is_signed, Order order) {
+
+    switch (kind) {
+    case Kind::Linear:
+      return is_signed ? select<Entry, Kind::Linear, true>(order)
+                       : select<Entry, Kind::Linear, false>(order);
+    case Kind::Float:
+      return select<Entry, Kind::Float, false>(order);
+    case Kind::MantissaExponent:
+      return is_signed
+          ? Entry::template get<Kind::MantissaExponent, true, Order::Standard>()
+          : Entry::template get<Kind::MantissaExponent, false,
+                Order::Standard>();
+    case Kind::Expression:
+      return Entry::template get<Kind::Expression, false, Order::Standard>();
+    }
+    throw std::logic_error("Unknown decoder kind");
+  }
+};
+
+double Decoder::decodeDouble(
+    uint16_t const* registers, size_t num_registers) const {
+
+  return kernel_(*this, registers, num_registers);
+}
+
+double Decoder::decodeDouble(uint16_t const* registers, size_t const* indices,
+    size_t num_registers) const {
+
+  return gathered_kernel_(*this, Gathered{registers, indices}, num_registers);
+}
+
+void Decoder::decodeBatch(Block const& block, double* values) const {
+  batch_kernel_(*this, block, values);
+}
+
+Information_Model::DataVariant Decoder::operator()(
+    uint16_t const* registers, size_t num_registers) const {
+
+  return decodeDouble(registers, num_registers);
+}
+
+Information_Model::DataVariant Decoder::operator()(
+    std::vector<uint16_t> const& registers) const {
+
+  return decodeDouble(registers.data(), registers.size());
+}
+
+Information_Model::DataVariant Decoder::operator()(uint16_t const* registers,
+    size_t const* indices, size_t num_registers) const {
+
+  return decodeDouble(registers, indices, num_registers);
+}
+
+Decoder::Decoder(Kind kind, bool is_signed, double factor, double offset,
+    double base, ByteOrder byte_order, WordOrder word_order)
+    : kind_(kind),
+      kernel_(Kernels::select<Kernels::Single<uint16_t const*>>(
+          kind, is_signed, Kernels::order(byte_order, word_order))),
+      gathered_kernel_(Kernels::select<Kernels::Single<Gathered>>(
+          kind, is_signed, Kernels::order(byte_order, word_order))),
+      batch_kernel_(Kernels::select<Kernels::Batch>(
+          kind, is_signed, Kernels::order(byte_order, word_order))),
+      factor_(factor), offset_(offset), base_(base) {
+
+  if (kind_ == Kind::MantissaExponent) {
+    auto powers = std::make_shared<std::vector<double>>();
+    powers->reserve(2 * MAX_TABULATED_EXPONENT + 1);
+    for (int exponent = -MAX_TABULATED_EXPONENT;
+        exponent <= MAX_TABULATED_EXPONENT; ++exponent) {
+      powers->push_back(std::pow(base_, exponent));
+    }
+    powers_ = std::move(powers);
+  }
+}
+
+double Decoder::power(int exponent) const {
+  if ((exponent < -MAX_TABULATED_EXPONENT) ||
+      (exponent > MAX_TABULATED_EXPONENT)) {
+    return std::pow(base_, exponent);
+  }
+  return (*powers_)[exponent + MAX_TABULATED_EXPONENT];
+}
+
+} // namespace Technology_Adapter::Modbus::Config
@@ -0,0 +1,407 @@
+#include "internal/Expression.hpp"
+
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+
+#if !defined(__cpp_lib_to_chars)
+#include <locale>
+#include <sstream>
+#endif
+
+namespace Technology_Adapter::Modbus::Config {
+
+namespace {
+
+using Code = Expression::Instruction::Code;
+
+// The bound of `int64_t`, exactly representable as a `double`
+constexpr double TWO_TO_63 = 9223372036854775808.0;
+
+/*
+  Converts a number as scanned by `Parser::number`, regardless of the locale.
+  Empty if out of range.
+*/
+std::optional<double> decimal(char const* begin, char const* end) {
+  double value = 0;
+#if defined(__cpp_lib_to_chars)
+  auto result = std::from_chars(begin, end, value, std::chars_format::general);
+  if ((result.ec != std::errc()) || (result.ptr != end)) {
+    return std::nullopt;
+  }
+#else
+  std::istringstream stream(std::string(begin, end));
+  stream.imbue(std::locale::classic());
+  stream >> value;
+  if (stream.fail() || !stream.eof()) {
+    return std::nullopt;
+  }
+#endif
+  return value;
+}
+
+/*
+  Recursive descent parser which emits a postfix program.
+
+  expression := term (('+' | '-') term)*
+  term := unary (('*' | '/') unary)*
+  unary := '-' unary | power
+  power := primary ('^' unary)?
+  primary := number | '#' digits | name | '(' expression ')'
+    | 'bit' '(' expression ',' expression ')'
+  number := (digits ('.' digits?)? | '.' digits)
+    (('e' | 'E') ('+' | '-')? digits)?
+*/
+class Parser {
+public:
+  std::vector<int> registers;
+  std::vector<Expression::Instruction> program;
+  std::vector<Expression::Operand> operands;
+  size_t max_depth = 0;
+
+  Parser(std::string const& source, Expression::Lookup const& lookup)
+      : source_(source), lookup_(lookup) {}
+
+  void parse() {
+    expression();
+    skipSpace();
+    if (position_ != source_.size()) {
+      fail("unexpected character");
+    }
+  }
+
+private:
+  // Modbus addresses registers by 16 bits
+  static constexpr int MAX_REGISTER_NUMBER = 65535;
+
+  // Bound on the recursion of `unary`, so that the parser's stack is bounded
+  static constexpr size_t MAX_NESTING = 256;
+
+  std::string const& source_;
+  Expression::Lookup const& lookup_;
+  size_t position_ = 0;
+  size_t depth_ = 0; // of the stack after the instructions so far
+  size_t nesting_ = 0; // of the calls to `unary` in progress
+
+  void expression() {
+    term();
+    while (true) {
+      if (accept('+')) {
+        term();
+        emit(Code::Add);
+      } else if (accept('-')) {
+        term();
+        emit(Code::Subtract);
+      } else {
+        return;
+      }
+    }
+  }
+
+  void term() {
+    unary();
+    while (true) {
+      if (accept('*')) {
+        unary();
+        emit(Code::Multiply);
+      } else if (accept('/')) {
+        unary();
+        emit(Code::Divide);
+      } else {
+        return;
+      }
+    }
+  }
+
+  // Every recursion of the parser passes here
+  void unary() {
+    if (nesting_ == MAX_NESTING) {
+      fail("too deeply nested");
+    }
+    ++nesting_;
+    if (accept('-')) {
+      unary();
+      emit(Code::Negate);
+    } else {
+      power();
+    }
+    --nesting_;
+  }
+
+  void power() {
+    primary();
+    if (accept('^')) {
+      unary();
+      emit(Code::Power);
+    }
+  }
+
+  void primary() {
+    skipSpace();
+    if (position_ == source_.size()) {
+      fail("operand missing");
+    }
+    char next = source_[position_];
+    if (accept('(')) {
+      expression();
+      expect(')');
+    } else if (accept('#')) {
+      emit(Code::Register, 0, registerIndex(digits()));
+    } else if ((std::isdigit((unsigned char)next) != 0) || (next == '.')) {
+      number();
+    } else if (next == '\'') {
+      ++position_;
+      size_t end = source_.find('\'', position_);
+      if (end == std::string::npos) {
+        fail("unterminated name");
+      }
+      std::string name = source_.substr(position_, end - position_);
+      position_ = end + 1;
+      readable(name);
+    } else if ((std::isalpha((unsigned char)next) != 0) || (next == '_')) {
+      std::string name = identifier();
+      if ((name == "bit") && accept('(')) {
+        expression();
+        expect(',');
+        expression();
+        expect(')');
+        emit(Code::Bit);
+      } else {
+        readable(name);
+      }
+    } else {
+      fail("unexpected character");
+    }
+  }
+
+  // Unlike `strtod`, neither hexadecimal numbers nor "inf" or "nan"
+  void number() {
+    size_t begin = position_;
+    size_t num_digits = skipDigits();
+    if (at('.')) {
+      ++position_;
+      num_digits += skipDigits();
+    }
+    if (num_digits == 0) {
+      fail("malformed number");
+    }
+    if (at('e') || at('E')) {
+      ++position_;
+      if (at('+') || at('-')) {
+        ++position_;
+      }
+      if (skipDigits() == 0) {
+        fail("malformed number");
+      }
+    }
+    auto value = decimal(source_.data() + begin, source_.data() + position_);
+    if (!value.has_value()) {
+      fail("number out of range");
+    }
+    emit(Code::Constant, value.value());
+  }
+
+  void readable(std::string const& name) {
+    Readable const& readable = lookup_(name);
+    Expression::Operand operand{readable.decode, {}};
+    operand.indices.reserve(readable.registers.size());
+    for (int register_index : readable.registers) {
+      operand.indices.push_back(registerIndex(register_index));
+    }
+    operands.push_back(std::move(operand));
+    emit(Code::Readable, 0, operands.size() - 1);
+  }
+
+  // Index of `register_index` in `registers`, which is extended if necessary
+  size_t registerIndex(int register_index) {
+    for (size_t i = 0; i < registers.size(); ++i) {
+      if (registers[i] == register_index) {
+        return i;
+      }
+    }
+    if (registers.size() == Expression::MAX_REGISTERS) {
+      fail("too many registers");
+    }
+    registers.push_back(register_index);
+    return registers.size() - 1;
+  }
+
+  void emit(Code code, double constant = 0, size_t operand = 0) {
+    switch (code) {
+    case Code::Constant:
+    case Code::Register:
+    case Code::Readable:
+      ++depth_;
+      break;
+    case Code::Negate:
+      break;
+    default: // binary
+      --depth_;
+    }
+    if (depth_ > max_depth) {
+      max_depth = depth_;
+    }
+    program.push_back({code, constant, operand});
+  }
+
+  // A register number
+  int digits() {
+    size_t begin = position_;
+    int value = 0;
+    while ((position_ < source_.size()) &&
+        (std::isdigit((unsigned char)source_[position_]) != 0)) {
+      // NOLINTNEXTLINE(readability-magic-numbers)
+      value = 10 * value + (source_[position_] - '0');
+      if (value > MAX_REGISTER_NUMBER) {
+        fail("register number out of range");
+      }
+      ++position_;
+    }
+    if (position_ == begin) {
+      fail("register number missing");
+    }
+    return value;
+  }
+
+  std::string identifier() {
+    size_t begin = position_;
+    while ((position_ < source_.size()) &&
+        ((std::isalnum((unsigned char)source_[position_]) != 0) ||
+            (source_[position_] == '_'))) {
+      ++position_;
+    }
+    return source_.substr(begin, position_ - begin);
+  }
+
+  // Number of digits skipped
+  size_t skipDigits() {
+    size_t begin = position_;
+    while ((position_ < source_.size()) &&
+        (std::isdigit((unsigned char)source_[position_]) != 0)) {
+      ++position_;
+    }
+    return position_ - begin;
+  }
+
+  // Whether the next character, without skipping space, is `c`
+  bool at(char c) const {
+    return (position_ < source_.size()) && (source_[position_] == c);
+  }
+
+  void skipSpace() {
+    while ((position_ < source_.size()) &&
+        (std::isspace((unsigned char)source_[position_]) != 0)) {
+      ++position_;
+    }
+  }
+
+  bool accept(char c) {
+    skipSpace();
+    if ((position_ < source_.size()) && (source_[position_] == c)) {
+      ++position_;
+      return true;
+    }
+    return false;
+  }
+
+  void expect(char c) {
+    if (!accept(c)) {
+      fail(std::string("expected '") + c + "'");
+    }
+  }
+
+  [[noreturn]] void fail(std::string const& what) const {
+    throw std::runtime_error("In expression \"" + source_ + "\" at position " +
+        std::to_string(position_) + ": " + what);
+  }
+};
+
+} // namespace
+
+Expression Expression::compile(
+    std::string const& source, Lookup const& lookup) {
+
+  Parser parser(source, lookup);
+  parser.parse();
+  if (parser.max_depth > MAX_DEPTH) {
+    throw std::runtime_error(
+        "In expression \"" + source + "\": too deeply nested");
+  }
+  return Expression(std::move(parser.registers), std::move(parser.program),
+      std::move(parser.operands));
+}
+
+std::vector<int> const& Expression::registers() const { return registers_; }
+
+double Expression::evaluate(uint16_t const* registers) const {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+  std::array<double, MAX_DEPTH> stack;
+  size_t size = 0;
+  for (auto const& instruction : program_) {
+    switch (instruction.code) {
+    case Code::Constant:
+      stack[size++] = instruction.constant;
+      break;
+    case Code::Register:
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      stack[size++] = registers[instruction.operand];
+      break;
+    case Code::Readable: {
+      auto const& operand = operands_[instruction.operand];
+      stack[size++] = operand.decoder.decodeDouble(
+          registers, operand.indices.data(), operand.indices.size());
+      break;
+    }
+    case Code::Add:
+      --size;
+      stack[size - 1] += stack[size];
+      break;
+    case Code::Subtract:
+      --size;
+      stack[size - 1] -= stack[size];
+      break;
+    case Code::Multiply:
+      --size;
+      stack[size - 1] *= stack[size];
+      break;
+    case Code::Divide:
+      --size;
+      stack[size - 1] /= stack[size];
+      break;
+    case Code::Power:
+      --size;
+      stack[size - 1] = std::pow(stack[size - 1], stack[size]);
+      break;
+    case Code::Negate:
+      stack[size - 1] = -stack[size - 1];
+      break;
+    case Code::Bit: {
+      --size;
+      double bit = stack[size];
+      // NaN fails all comparisons, hence the negated form
+      if (!((bit >= 0) && (bit < 64))) { // NOLINT(readability-magic-numbers)
+        throw std::runtime_error("Bit index out of range");
+      }
+      // Converting to `int64_t` is undefined outside of its range
+      double value = stack[size - 1];
+      if (!((value >= -TWO_TO_63) && (value < TWO_TO_63))) {
+        throw std::runtime_error("Operand of bit out of range");
+      }
+      auto integer = (uint64_t)(int64_t)value;
+      stack[size - 1] = (double)((integer >> (unsigned)bit) & 1U);
+      break;
+    }
+    }
+  }
+  return stack[0];
+}
+
+Expression::Expression(std::vector<int> registers,
+    std::vector<Instruction> program, std::vector<Operand> operands)
+    : registers_(std::move(registers)), program_(std::move(program)),
+      operands_(std::move(operands)) {}
+
+} // namespace Technology_Adapter::Modbus::Config
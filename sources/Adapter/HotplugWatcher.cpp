@@ -0,0 +1,243 @@
+#include "internal/HotplugWatcher.hpp"
+
+#include <array>
+#include <cerrno>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <glob.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <HaSLL/LoggerManager.hpp>
+
+#include "internal/Logging.hpp"
+#include "internal/ThreadsafeStrerror.hpp"
+
+namespace Technology_Adapter::Modbus {
+
+namespace {
+
+// Events which make a node (more) usable
+constexpr uint32_t APPEARANCE_EVENTS = IN_CREATE | IN_ATTRIB | IN_MOVED_TO;
+
+// Events which make a node unusable
+constexpr uint32_t DISAPPEARANCE_EVENTS = IN_DELETE | IN_MOVED_FROM;
+
+// @pre `path` is absolute
+std::string directoryOf(std::string const& path) {
+  auto slash = path.rfind('/');
+  if (slash == 0) {
+    return "/";
+  }
+  return path.substr(0, slash);
+}
+
+} // namespace
+
+HotplugWatcher::HotplugWatcher(Callback callback, bool enabled)
+    : callback_(std::move(callback)),
+      logger_(HaSLL::LoggerManager::registerLogger(
+          "Modbus Adapter hotplug watcher")) {
+
+  if (!enabled) {
+    return;
+  }
+
+  inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotify_fd_ < 0) {
+    logger_->warning("inotify is unavailable, falling back to polling: {}",
+        Errno::strerror(errno).c_str());
+    return;
+  }
+  if (pipe2(termination_fds_, O_CLOEXEC) != 0) {
+    logger_->warning("Cannot create pipe, falling back to polling: {}",
+        Errno::strerror(errno).c_str());
+    close(inotify_fd_);
+    inotify_fd_ = -1;
+    return;
+  }
+  thread_ = std::thread([this]() { run(); });
+}
+
+HotplugWatcher::~HotplugWatcher() noexcept {
+  if (thread_.joinable()) {
+    char byte = 0;
+    // If this fails, the pipe is broken, which wakes `run` just the same
+    (void)write(termination_fds_[1], &byte, 1);
+    thread_.join();
+  }
+  for (int fd : {inotify_fd_, termination_fds_[0], termination_fds_[1]}) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+bool HotplugWatcher::watchDirectoryOf(std::string const& path) {
+  if ((inotify_fd_ < 0) || path.empty() || (path.front() != '/')) {
+    return false;
+  }
+
+  auto directory = directoryOf(path);
+  std::lock_guard lock(mutex_);
+  for (auto const& watched : directories_) {
+    if (watched.second == directory) {
+      return true;
+    }
+  }
+  int watch_descriptor = inotify_add_watch(inotify_fd_, directory.c_str(),
+      APPEARANCE_EVENTS | DISAPPEARANCE_EVENTS | IN_ONLYDIR);
+  if (watch_descriptor < 0) {
+    logger_->warning("Cannot watch {}, falling back to polling: {}", directory,
+        Errno::strerror(errno).c_str());
+    return false;
+  }
+  directories_.insert_or_assign(watch_descriptor, directory);
+  logger_->debug("Watching {}", directory);
+  return true;
+}
+
+bool HotplugWatcher::isPattern(std::string const& path) {
+  return path.find_first_of("*?[") != std::string::npos;
+}
+
+std::vector<std::string> HotplugWatcher::expand(std::string const& pattern) {
+  std::vector<std::string> result;
+  glob_t matches;
+  if (glob(pattern.c_str(), 0, nullptr, &matches) == 0) {
+    try {
+      for (size_t i = 0; i < matches.gl_pathc; ++i) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        result.emplace_back(matches.gl_pathv[i]);
+      }
+    } catch (...) {
+      globfree(&matches);
+      throw;
+    }
+  }
+  globfree(&matches);
+  return result;
+}
+
+bool HotplugWatcher::matches(
+    std::string const& pattern, std::string const& path) {
+
+  return fnmatch(pattern.c_str(), path.c_str(), FNM_PATHNAME) == 0;
+}
+
+void HotplugWatcher::run() noexcept {
+  Logging::trace(logger_, "Starting");
+
+  // Large enough for several events, and aligned as inotify requires
+  alignas(inotify_event) char buffer[4096];
+
+  std::array<pollfd, 2> fds{{
+      {inotify_fd_, POLLIN, 0},
+      {termination_fds_[0], POLLIN, 0},
+  }};
+  while (true) {
+    if (poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      Logging::error(
+          logger_, "poll failed: {}", Errno::strerror(errno).c_str());
+      break;
+    }
+    if (fds[1].revents != 0) {
+      break;
+    }
+
+    ssize_t size = read(inotify_fd_, buffer, sizeof(buffer));
+    if (size <= 0) {
+      continue;
+    }
+    try {
+      for (auto const& change : parseEvents(buffer, size)) {
+        Logging::debug(logger_, "{} {}", change.first,
+            change.second ? "appeared" : "disappeared");
+        callback_(change.first, change.second);
+      }
+    } catch (std::exception const& exception) {
+      Logging::error(
+          logger_, "While handling hotplug events: {}", exception.what());
+    }
+  }
+  Logging::trace(logger_, "Terminating");
+}
+
+HotplugWatcher::Changes HotplugWatcher::parseEvents(
+    char const* buffer, size_t size) {
+
+  Changes changes;
+  std::lock_guard lock(mutex_);
+  bool overflow = false;
+  size_t offset = 0;
+  while (offset < size) {
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    auto const* event = reinterpret_cast<inotify_event const*>(buffer + offset);
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    offset += sizeof(inotify_event) + event->len;
+
+    if ((event->mask & IN_Q_OVERFLOW) != 0) {
+      overflow = true;
+      continue;
+    }
+    auto directory = directories_.find(event->wd);
+    if ((directory == directories_.end()) || (event->len == 0)) {
+      continue;
+    }
+    std::string path = directory->second == "/"
+        ? "/" + std::string(event->name)
+        : directory->second + "/" + event->name;
+    if ((event->mask & APPEARANCE_EVENTS) != 0) {
+      changes.emplace_back(std::move(path), true);
+    } else if ((event->mask & DISAPPEARANCE_EVENTS) != 0) {
+      changes.emplace_back(std::move(path), false);
+    }
+  }
+
+  if (overflow) {
+    logger_->warning(
+        "inotify queue overflowed, rescanning the watched directories");
+    auto present = scanDirectories();
+    changes.insert(changes.end(), present.begin(), present.end());
+  }
+  return changes;
+}
+
+HotplugWatcher::Changes HotplugWatcher::scanDirectories() {
+  Changes changes;
+  for (auto const& directory : directories_) {
+    DIR* stream = opendir(directory.second.c_str());
+    if (stream == nullptr) {
+      continue;
+    }
+    try {
+      // `stream` is ours alone, which makes `readdir` safe
+      // NOLINTNEXTLINE(concurrency-mt-unsafe)
+      while (dirent const* entry = readdir(stream)) {
+        std::string name = entry->d_name;
+        if ((name == ".") || (name == "..")) {
+          continue;
+        }
+        changes.emplace_back(directory.second == "/"
+                ? "/" + name
+                : directory.second + "/" + name,
+            true);
+      }
+    } catch (...) {
+      closedir(stream);
+      throw;
+    }
+    closedir(stream);
+  }
+  return changes;
+}
+
+} // namespace Technology_Adapter::Modbus
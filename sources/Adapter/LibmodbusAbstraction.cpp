@@ -1,9 +1,15 @@
 #include "internal/LibmodbusAbstraction.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cerrno>
 #include <cstring>
 #include <thread>
 
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 #include "modbus/modbus-rtu.h"
 
 #include "internal/Config.hpp"
@@ -36,6 +42,10 @@ bool ModbusError::retryFeasible() const {
   }
 }
 
+bool ModbusError::unsupportedRequest() const {
+  return (errno_ == XILFUN) || (errno_ == XILADD) || (errno_ == XILVAL);
+}
+
 // NOLINTBEGIN(readability-identifier-naming)
 int const ModbusError::XILFUN = EMBXILFUN;
 int const ModbusError::XILADD = EMBXILADD;
@@ -55,6 +65,67 @@ int const ModbusError::MDATA = EMBMDATA;
 int const ModbusError::BADSLAVE = EMBBADSLAVE;
 // NOLINTEND(readability-identifier-naming)
 
+namespace {
+
+// Like `poll`, but with a finer timeout and retrying if interrupted
+int pollFor(pollfd* fds, nfds_t num_fds, std::chrono::microseconds timeout) {
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (true) {
+    auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        deadline - std::chrono::steady_clock::now());
+    if (remaining.count() < 0) {
+      remaining = std::chrono::nanoseconds(0);
+    }
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(remaining);
+    timespec timeout_spec{(time_t)seconds.count(),
+        (long)(remaining - seconds).count()}; // NOLINT(google-runtime-int)
+    int result = ppoll(fds, num_fds, &timeout_spec, nullptr);
+    if ((result >= 0) || (errno != EINTR)) {
+      return result;
+    }
+  }
+}
+
+[[noreturn]] void throwError(int errnum) {
+  errno = errnum;
+  throw ModbusError();
+}
+
+} // namespace
+
+// Cancellation
+
+Cancellation::Cancellation() : fd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+  if (fd_ < 0) {
+    throw ModbusError();
+  }
+}
+
+Cancellation::~Cancellation() { ::close(fd_); }
+
+void Cancellation::cancel() noexcept {
+  uint64_t one = 1;
+  // This can only fail on counter overflow, when we are cancelled anyway
+  (void)write(fd_, &one, sizeof(one));
+}
+
+void Cancellation::reset() noexcept {
+  uint64_t counter;
+  // This fails with `EAGAIN` if we are not cancelled, which is fine
+  (void)read(fd_, &counter, sizeof(counter));
+}
+
+bool Cancellation::cancelled() const noexcept {
+  return waitFor(std::chrono::microseconds(0));
+}
+
+bool Cancellation::waitFor(std::chrono::microseconds duration) const noexcept {
+  pollfd fds{fd_, POLLIN, 0};
+  return pollFor(&fds, 1, duration) > 0;
+}
+
+int Cancellation::fd() const noexcept { return fd_; }
+
 // LibModbusContext
 
 Context::Context(_modbus* internal) : internal_(internal) {
@@ -63,19 +134,32 @@ Context::Context(_modbus* internal) : internal_(internal) {
   }
 }
 
-Context::~Context() { modbus_free(internal_); }
+Context::~Context() {
+  close();
+  modbus_free(internal_);
+}
 
 void Context::connect() {
   if (modbus_connect(internal_) != 0) {
     throw ModbusError();
   }
+  connected_ = true;
 }
 
-void Context::close() noexcept { modbus_close(internal_); }
+void Context::close() noexcept {
+  if (connected_) {
+    modbus_close(internal_);
+    connected_ = false;
+  }
+}
 
 int Context::readRegisters(
     int addr, ReadableRegisterType type, int nb, uint16_t* dest) {
 
+  if (cancellation_ != nullptr) {
+    return readRegistersCancellably(addr, type, nb, dest);
+  }
+
   int retval = -1;
   switch (type) {
   case ReadableRegisterType::HoldingRegister:
@@ -91,6 +175,309 @@ int Context::readRegisters(
   return retval;
 }
 
+int Context::readRegistersCancellably(
+    int addr, ReadableRegisterType type, int nb, uint16_t* dest) {
+
+  // NOLINTBEGIN(readability-magic-numbers)
+  if ((nb < 1) || (nb > MODBUS_MAX_READ_REGISTERS)) {
+    throwError(EMBMDATA);
+  }
+
+  uint8_t function = 0;
+  switch (type) {
+  case ReadableRegisterType::HoldingRegister:
+    function = MODBUS_FC_READ_HOLDING_REGISTERS;
+    break;
+  case ReadableRegisterType::InputRegister:
+    function = MODBUS_FC_READ_INPUT_REGISTERS;
+    break;
+  }
+  auto data = exchange({(uint8_t)modbus_get_slave(internal_), function,
+      (uint8_t)(addr >> 8), (uint8_t)(addr & 0xFF), (uint8_t)(nb >> 8),
+      (uint8_t)(nb & 0xFF)});
+
+  // `data` is the byte count followed by the register values
+  size_t num_bytes = 2 * (size_t)nb;
+  if ((data.size() != num_bytes + 1) || (data[0] != num_bytes)) {
+    throwError(EMBBADDATA);
+  }
+  for (int i = 0; i < nb; ++i) {
+    dest[i] = (uint16_t)((data[2 * i + 1] << 8) | data[2 * i + 2]);
+  }
+  // NOLINTEND(readability-magic-numbers)
+  return nb;
+}
+
+namespace {
+
+// NOLINTBEGIN(readability-magic-numbers)
+constexpr uint8_t FC_REPORT_SERVER_ID = 0x11;
+constexpr uint8_t FC_ENCAPSULATED_INTERFACE = 0x2B;
+constexpr uint8_t MEI_READ_DEVICE_ID = 0x0E;
+constexpr uint8_t READ_BASIC_DEVICE_ID = 0x01;
+constexpr uint8_t MORE_FOLLOWS = 0xFF;
+// NOLINTEND(readability-magic-numbers)
+
+// The basic category has three objects, which may come one per response
+constexpr size_t MAX_DEVICE_ID_RESPONSES = 3;
+
+// Only RTU contexts exist, which end their messages with a CRC
+constexpr size_t CHECKSUM_LENGTH = 2;
+
+/*
+  The length, including CRC, of the RTU response that starts with `response`,
+  or the length of a longer start which tells it.
+  @pre `response` has at least slave ID and function code
+  @throws `ModbusError` with `BADDATA` for unknown function codes
+*/
+size_t responseLength(std::vector<uint8_t> const& response) {
+  // NOLINTBEGIN(readability-magic-numbers)
+  uint8_t function = response[1];
+  if ((function & 0x80U) != 0) {
+    // slave ID, function code, and exception code
+    return 3 + CHECKSUM_LENGTH;
+  }
+  switch (function) {
+  case MODBUS_FC_READ_HOLDING_REGISTERS:
+  case MODBUS_FC_READ_INPUT_REGISTERS:
+  case FC_REPORT_SERVER_ID:
+    // slave ID, function code, a byte count, and that many bytes
+    return response.size() < 3 ? 3 : 3 + response[2] + CHECKSUM_LENGTH;
+  case FC_ENCAPSULATED_INTERFACE: {
+    // slave ID, function code, six bytes as in `readDeviceIdentification`
+    // up to the number of objects, and then the objects
+    size_t offset = 8;
+    if (response.size() < offset) {
+      return offset;
+    }
+    for (size_t n = 0; n < response[7]; ++n) {
+      if (response.size() < offset + 2) {
+        return offset + 2;
+      }
+      offset += 2 + response[offset + 1];
+    }
+    return offset + CHECKSUM_LENGTH;
+  }
+  default:
+    throwError(EMBBADDATA);
+  }
+  // NOLINTEND(readability-magic-numbers)
+}
+
+// The CRC of Modbus RTU
+uint16_t crc16(uint8_t const* data, size_t size) {
+  // NOLINTBEGIN(readability-magic-numbers)
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < size; ++i) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 1U) != 0 ? (uint16_t)((crc >> 1) ^ 0xA001U) : crc >> 1;
+    }
+  }
+  return crc;
+  // NOLINTEND(readability-magic-numbers)
+}
+
+} // namespace
+
+DeviceIdentification Context::readDeviceIdentification() {
+  DeviceIdentification result;
+  auto slave = (uint8_t)modbus_get_slave(internal_);
+  uint8_t object_id = 0;
+  for (size_t i = 0; i < MAX_DEVICE_ID_RESPONSES; ++i) {
+    auto data = exchange({slave, FC_ENCAPSULATED_INTERFACE,
+        MEI_READ_DEVICE_ID, READ_BASIC_DEVICE_ID, object_id});
+
+    /*
+      `data` is the MEI type, the read device ID code, the conformity level,
+      the more-follows flag, the next object ID, the number of objects, and
+      then the objects as (ID, length, value)
+    */
+    constexpr size_t objects_offset = 6;
+    if ((data.size() < objects_offset) || (data[0] != MEI_READ_DEVICE_ID)) {
+      throwError(EMBBADDATA);
+    }
+    size_t offset = objects_offset;
+    for (size_t n = 0; n < data[objects_offset - 1]; ++n) {
+      if ((offset + 2 > data.size()) ||
+          (offset + 2 + data[offset + 1] > data.size())) {
+        throwError(EMBBADDATA);
+      }
+      auto begin = data.begin() + (std::ptrdiff_t)offset + 2;
+      std::string value(begin, begin + data[offset + 1]);
+      switch (data[offset]) {
+      case 0:
+        result.vendor = std::move(value);
+        break;
+      case 1:
+        result.product = std::move(value);
+        break;
+      case 2:
+        result.revision = std::move(value);
+        break;
+      default:
+        break;
+      }
+      offset += 2 + data[offset + 1];
+    }
+
+    if (data[3] != MORE_FOLLOWS) {
+      break;
+    }
+    object_id = data[4];
+  }
+  return result;
+}
+
+DeviceIdentification Context::reportServerId() {
+  auto data = exchange({(uint8_t)modbus_get_slave(internal_),
+      FC_REPORT_SERVER_ID});
+
+  // `data` is the byte count, the server ID, the run indicator, and then
+  // device-specific data
+  if (data.empty() || (data[0] + 1U > data.size())) {
+    throwError(EMBBADDATA);
+  }
+  size_t end = data[0] + 1U;
+  size_t begin = std::min<size_t>(3, end);
+  DeviceIdentification result;
+  result.server_id.assign(data.begin() + (std::ptrdiff_t)begin,
+      data.begin() + (std::ptrdiff_t)end);
+  return result;
+}
+
+std::vector<uint8_t> Context::exchange(std::vector<uint8_t> const& request) {
+  if (cancellation_ != nullptr) {
+    if (cancellation_->cancelled()) {
+      throwError(ECANCELED);
+    }
+    // Discard leftovers of an earlier exchange, e.g., a cancelled one
+    (void)modbus_flush(internal_);
+  }
+  if (modbus_send_raw_request(internal_, request.data(), request.size()) < 0) {
+    throw ModbusError();
+  }
+
+  /*
+    We receive the response ourselves. libmodbus only knows the length of
+    responses to the functions it implements, and cuts others, e.g. of Read
+    Device Identification, short.
+  */
+  uint8_t function = request[1];
+  std::vector<uint8_t> response;
+  receiveBytes(response, 2);
+  // NOLINTNEXTLINE(readability-magic-numbers)
+  if ((response[1] != function) && (response[1] != (function | 0x80U))) {
+    (void)modbus_flush(internal_);
+    throwError(EMBBADDATA);
+  }
+  for (size_t length = responseLength(response); length != response.size();
+       length = responseLength(response)) {
+    if (length > MODBUS_RTU_MAX_ADU_LENGTH) {
+      (void)modbus_flush(internal_);
+      throwError(EMBBADDATA);
+    }
+    receiveBytes(response, length);
+  }
+
+  auto checksum_begin = response.end() - (std::ptrdiff_t)CHECKSUM_LENGTH;
+  auto checksum = crc16(response.data(), response.size() - CHECKSUM_LENGTH);
+  // NOLINTNEXTLINE(readability-magic-numbers)
+  if ((checksum_begin[0] != (checksum & 0xFFU)) ||
+      (checksum_begin[1] != (checksum >> 8))) {
+    throwError(EMBBADCRC);
+  }
+  if (response[0] != request[0]) {
+    throwError(EMBBADSLAVE);
+  }
+  if (response[1] != function) {
+    throwError(MODBUS_ENOBASE + response[2]);
+  }
+  return std::vector<uint8_t>(response.begin() + 2, checksum_begin);
+}
+
+void Context::receiveBytes(std::vector<uint8_t>& response, size_t length) {
+  int socket = modbus_get_socket(internal_);
+  std::array<pollfd, 2> fds{{
+      {socket, POLLIN, 0},
+      {cancellation_ == nullptr ? -1 : cancellation_->fd(), POLLIN, 0},
+  }};
+  while (response.size() < length) {
+    auto timeout = response.empty() ? responseTimeout() : byteTimeout();
+    int result = pollFor(fds.data(), fds.size(), timeout);
+    if (result < 0) {
+      throw ModbusError();
+    }
+    if (fds[1].revents != 0) {
+      throwError(ECANCELED);
+    }
+    if (result == 0) {
+      throwError(ETIMEDOUT);
+    }
+
+    std::array<uint8_t, MODBUS_RTU_MAX_ADU_LENGTH> buffer{};
+    ssize_t size = read(socket, buffer.data(),
+        std::min(buffer.size(), length - response.size()));
+    if (size < 0) {
+      if ((errno == EAGAIN) || (errno == EINTR)) {
+        continue;
+      }
+      throw ModbusError();
+    }
+    if (size == 0) {
+      throwError(EIO); // the other end hung up
+    }
+    response.insert(response.end(), buffer.begin(), buffer.begin() + size);
+  }
+}
+
+void Context::setCancellation(Cancellation::Ptr cancellation) noexcept {
+  cancellation_ = std::move(cancellation);
+}
+
+namespace {
+
+constexpr std::chrono::microseconds::rep MICROSECONDS_PER_SECOND = 1000000;
+
+} // namespace
+
+void Context::setResponseTimeout(std::chrono::microseconds timeout) {
+  if (modbus_set_response_timeout(internal_,
+          (uint32_t)(timeout.count() / MICROSECONDS_PER_SECOND),
+          (uint32_t)(timeout.count() % MICROSECONDS_PER_SECOND)) != 0) {
+    throw ModbusError();
+  }
+}
+
+std::chrono::microseconds Context::responseTimeout() const {
+  uint32_t seconds = 0;
+  uint32_t microseconds = 0;
+  if (modbus_get_response_timeout(internal_, &seconds, &microseconds) != 0) {
+    throw ModbusError();
+  }
+  return std::chrono::seconds(seconds) +
+      std::chrono::microseconds(microseconds);
+}
+
+void Context::setByteTimeout(std::chrono::microseconds timeout) {
+  if (modbus_set_byte_timeout(internal_,
+          (uint32_t)(timeout.count() / MICROSECONDS_PER_SECOND),
+          (uint32_t)(timeout.count() % MICROSECONDS_PER_SECOND)) != 0) {
+    throw ModbusError();
+  }
+}
+
+std::chrono::microseconds Context::byteTimeout() const {
+  uint32_t seconds = 0;
+  uint32_t microseconds = 0;
+  if (modbus_get_byte_timeout(internal_, &seconds, &microseconds) != 0) {
+    throw ModbusError();
+  }
+  return std::chrono::seconds(seconds) +
+      std::chrono::microseconds(microseconds);
+}
+
 // ContextRTU
 
 // Converts `parity` into the `char` expected by the libmodbus API
@@ -0,0 +1,107 @@
+#include "MetricTable.hpp"
+
+namespace Technology_Adapter::Modbus {
+
+MetricTable::MetricTable(Config::Bus const& bus) : bus_(bus) {
+  bursts_begin_.push_back(0);
+  task_to_plan_begin_.push_back(0);
+  for (uint32_t i = 0; i < bus.devices.size(); ++i) {
+    auto const& device = *bus.devices[i];
+    addGroup(i, device, device);
+  }
+  id_.resize(readable_.size());
+
+  // Growing has left up to half of each column unused
+  device_.shrink_to_fit();
+  readable_.shrink_to_fit();
+  bursts_begin_.shrink_to_fit();
+  task_to_plan_begin_.shrink_to_fit();
+  num_plan_registers_.shrink_to_fit();
+  cache_.shrink_to_fit();
+  bursts_.shrink_to_fit();
+  task_to_plan_.shrink_to_fit();
+}
+
+size_t MetricTable::size() const { return readable_.size(); }
+
+Config::Device const& MetricTable::device(Handle handle) const {
+  return *bus_.devices[device_[handle]];
+}
+
+Config::Readable const& MetricTable::readable(Handle handle) const {
+  return *readable_[handle];
+}
+
+BurstPlan::Burst const* MetricTable::burstsBegin(Handle handle) const {
+  return bursts_.data() + bursts_begin_[handle];
+}
+
+BurstPlan::Burst const* MetricTable::burstsEnd(Handle handle) const {
+  return bursts_.data() + bursts_begin_[handle + 1];
+}
+
+size_t MetricTable::numPlanRegisters(Handle handle) const {
+  return num_plan_registers_[handle];
+}
+
+size_t const* MetricTable::taskToPlan(Handle handle) const {
+  return task_to_plan_.data() + task_to_plan_begin_[handle];
+}
+
+DecodeMemo& MetricTable::memo(Handle handle) { return memo_[handle]; }
+
+ReadCache* MetricTable::cache(Handle handle) { return cache_[handle].get(); }
+
+std::string const& MetricTable::id(Handle handle) const { return id_[handle]; }
+
+void MetricTable::identify(Handle handle, std::string const& metric_id) {
+  auto handles_access = handles_.lock();
+  auto& id = id_[handle];
+  if (!id.empty()) {
+    handles_access->erase(id);
+  }
+  id = metric_id;
+  handles_access->insert_or_assign(id, handle);
+}
+
+std::optional<MetricTable::Handle> MetricTable::find(
+    std::string const& metric_id) {
+
+  auto handles_access = handles_.lock();
+  auto handle = handles_access->find(metric_id);
+  if (handle == handles_access->end()) {
+    return std::nullopt;
+  }
+  return handle->second;
+}
+
+void MetricTable::addGroup(uint32_t device_index, Config::Device const& device,
+    Config::Group const& group) {
+
+  for (auto const& readable : group.readables) {
+    BurstPlan plan(readable.registers, //
+        device.holding_registers, device.input_registers, //
+        device.burst_size);
+
+    device_.push_back(device_index);
+    readable_.push_back(&readable);
+    for (auto const& burst : plan.bursts) {
+      bursts_.push_back(burst);
+    }
+    bursts_begin_.push_back(bursts_.size());
+    task_to_plan_.insert(task_to_plan_.end(), plan.task_to_plan.begin(),
+        plan.task_to_plan.end());
+    task_to_plan_begin_.push_back(task_to_plan_.size());
+    num_plan_registers_.push_back(plan.num_plan_registers);
+    memo_.emplace_back(readable.registers.size());
+    cache_.push_back(readable.cache.kind == Config::CachePolicy::Kind::None
+            ? nullptr
+            : std::make_unique<ReadCache>(readable.cache));
+  }
+
+  for (auto const& subgroup : group.subgroups) {
+    addGroup(device_index, device, subgroup);
+  }
+}
+
+} // namespace Technology_Adapter::Modbus
@@ -0,0 +1,109 @@
+#ifndef _MODBUS_TECHNOLOGY_ADAPTER_METRIC_TABLE_HPP
+#define _MODBUS_TECHNOLOGY_ADAPTER_METRIC_TABLE_HPP
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Threadsafe_Containers/PrivateResource.hpp"
+
+#include "Burst.hpp"
+#include "internal/Config.hpp"
+#include "internal/DecodeMemo.hpp"
+#include "internal/ReadCache.hpp"
+
+namespace Technology_Adapter::Modbus {
+
+/**
+ * @brief What a `Bus` keeps per metric, for all of its metrics
+ *
+ * The table is a structure of arrays with one row per readable, which is
+ * addressed by a small integer `Handle`. Readables themselves are referred to
+ * rather than copied, and the `BurstPlan`s of all readables share two
+ * contiguous arrays. Hence callbacks need to carry nothing but a handle.
+ *
+ * All rows are made by the constructor, and only `identify`, the memos, and
+ * the caches change afterwards. Hence reading rows needs no synchronization.
+ */
+class MetricTable {
+public:
+  using Handle = uint32_t;
+
+  /**
+   * @brief A row for each readable of `bus`
+   *
+   * Rows are in the order in which `Bus::buildModel` visits readables, i.e.,
+   * device by device, and within each group first its readables, then its
+   * subgroups.
+   *
+   * @throws `std::runtime_error` if the registers of some readable cannot be
+   *   read in bursts from its device
+   * @pre The lifetime of `bus` contains the lifetime of `this`
+   */
+  explicit MetricTable(Config::Bus const& bus);
+
+  size_t size() const;
+
+  Config::Device const& device(Handle) const;
+  Config::Readable const& readable(Handle) const;
+
+  /// @brief The bursts of the `BurstPlan` of the readable
+  BurstPlan::Burst const* burstsBegin(Handle) const;
+  BurstPlan::Burst const* burstsEnd(Handle) const;
+
+  /// @brief As `num_plan_registers` of the `BurstPlan` of the readable
+  size_t numPlanRegisters(Handle) const;
+
+  /// @brief As `task_to_plan` of the `BurstPlan` of the readable
+  size_t const* taskToPlan(Handle) const;
+
+  DecodeMemo& memo(Handle);
+
+  /// @brief `nullptr` if the readable has `CachePolicy::Kind::None`
+  ReadCache* cache(Handle);
+
+  /// @brief As set by `identify`, empty before
+  std::string const& id(Handle) const;
+
+  /**
+   * @brief Sets the metric id of a row
+   *
+   * @pre No callback of the row runs concurrently
+   */
+  void identify(Handle, std::string const& metric_id);
+
+  /// @brief The row whose metric id is `metric_id`, if any
+  std::optional<Handle> find(std::string const& metric_id);
+
+private:
+  void addGroup(uint32_t device_index, Config::Device const&,
+      Config::Group const&);
+
+  Config::Bus const& bus_;
+
+  // Columns. The `..._begin_` columns have an extra entry at the end
+  std::vector<uint32_t> device_; // into `bus_.devices`
+  std::vector<Config::Readable const*> readable_;
+  std::vector<uint32_t> bursts_begin_; // into `bursts_`
+  std::vector<uint32_t> task_to_plan_begin_; // into `task_to_plan_`
+  std::vector<uint32_t> num_plan_registers_;
+  std::deque<DecodeMemo> memo_;
+  std::vector<std::unique_ptr<ReadCache>> cache_;
+  std::vector<std::string> id_;
+
+  std::vector<BurstPlan::Burst> bursts_;
+  std::vector<size_t> task_to_plan_;
+
+  // Views into `id_`, whose strings stay in place
+  Threadsafe::PrivateResource<std::unordered_map<std::string_view, Handle>>
+      handles_;
+};
+
+} // namespace Technology_Adapter::Modbus
+
+#endif // _MODBUS_TECHNOLOGY_ADAPTER_METRIC_TABLE_HPP
@@ -1,5 +1,6 @@
 #include "internal/Modbus.hpp"
 
+#include <algorithm>
 #include <thread>
 
 namespace Technology_Adapter::Modbus {
@@ -30,12 +31,35 @@ ModbusRTUContext::ModbusRTUContext(ConstString::ConstString const& port,
     Config::Bus const& bus, Purpose purpose)
     : libmodbus_context_(port, bus.baud, bus.parity, bus.data_bits,
           bus.stop_bits, bus.rts_delay),
+      default_response_timeout_(libmodbus_context_.responseTimeout()),
+      default_byte_timeout_(libmodbus_context_.byteTimeout()),
       end_of_last_use_(std::chrono::steady_clock::now()) {
 
+  configure(bus, purpose);
+}
+
+void ModbusRTUContext::configure(Config::Bus const& bus, Purpose purpose) {
+  purpose_ = purpose;
   inter_use_delay_ = std::chrono::microseconds(interUseDelay(bus, purpose));
   inter_device_delay_ =
       std::chrono::microseconds(interDeviceDelay(bus, purpose));
   inter_device_delay_ += inter_use_delay_;
+
+  std::chrono::microseconds byte_timeout = default_byte_timeout_;
+  response_timeout_ = std::chrono::microseconds(0);
+  max_response_timeout_ = std::chrono::microseconds(0);
+  if (purpose == Purpose::PortAutoDetection) {
+    if (bus.byte_timeout_when_searching > 0) {
+      byte_timeout = std::chrono::microseconds(bus.byte_timeout_when_searching);
+    }
+    response_timeout_ =
+        std::chrono::microseconds(bus.response_timeout_when_searching);
+    max_response_timeout_ =
+        std::chrono::microseconds(bus.max_response_timeout_when_searching);
+  }
+  libmodbus_context_.setByteTimeout(byte_timeout);
+  libmodbus_context_.setResponseTimeout(default_response_timeout_);
+  setDetectionRound(0);
 }
 
 void ModbusRTUContext::connect() { libmodbus_context_.connect(); }
@@ -51,6 +75,33 @@ void ModbusRTUContext::selectDevice(
 int ModbusRTUContext::readRegisters(int addr,
     LibModbus::ReadableRegisterType register_type, int nb, uint16_t* dest) {
 
+  awaitDelay();
+  auto retval = libmodbus_context_.readRegisters(addr, register_type, nb, dest);
+  end_of_last_use_ = std::chrono::steady_clock::now();
+  return retval;
+}
+
+LibModbus::DeviceIdentification ModbusRTUContext::identify() {
+  awaitDelay();
+  try {
+    auto result = libmodbus_context_.readDeviceIdentification();
+    end_of_last_use_ = std::chrono::steady_clock::now();
+    return result;
+  } catch (LibModbus::ModbusError const& error) {
+    end_of_last_use_ = std::chrono::steady_clock::now();
+    if (!error.unsupportedRequest()) {
+      throw;
+    }
+  }
+
+  // The device responded, so the delay is that of the same device
+  awaitDelay();
+  auto result = libmodbus_context_.reportServerId();
+  end_of_last_use_ = std::chrono::steady_clock::now();
+  return result;
+}
+
+void ModbusRTUContext::awaitDelay() {
   auto required_delay = current_slave_id_ == last_use_slave_id_
       ? inter_use_delay_
       : inter_device_delay_;
@@ -58,13 +109,44 @@ int ModbusRTUContext::readRegisters(int addr,
   auto elapsed_since_last_use =
       std::chrono::steady_clock::now() - end_of_last_use_;
   if (elapsed_since_last_use < required_delay) {
-    std::this_thread::sleep_for(required_delay - elapsed_since_last_use);
+    auto remaining = std::chrono::ceil<std::chrono::microseconds>(
+        required_delay - elapsed_since_last_use);
+    if (cancellation_ != nullptr) {
+      // If cancelled, the subsequent request fails right away
+      cancellation_->waitFor(remaining);
+    } else {
+      std::this_thread::sleep_for(remaining);
+    }
   }
+}
 
-  auto retval = libmodbus_context_.readRegisters(addr, register_type, nb, dest);
+void ModbusRTUContext::setCancellation(
+    LibModbus::Cancellation::Ptr cancellation) noexcept {
 
-  end_of_last_use_ = std::chrono::steady_clock::now();
-  return retval;
+  libmodbus_context_.setCancellation(cancellation);
+  cancellation_ = std::move(cancellation);
+}
+
+void ModbusRTUContext::setDetectionRound(size_t round) {
+  if ((purpose_ != Purpose::PortAutoDetection) ||
+      (response_timeout_.count() == 0)) {
+    return;
+  }
+
+  libmodbus_context_.setResponseTimeout(
+      escalatedTimeout(response_timeout_, max_response_timeout_, round));
+}
+
+std::chrono::microseconds ModbusRTUContext::escalatedTimeout(
+    std::chrono::microseconds initial, std::chrono::microseconds max,
+    size_t round) {
+
+  auto timeout = initial;
+  // Doubling stops at `max`, which also prevents overflows
+  for (size_t i = 0; (i < round) && (timeout < max); ++i) {
+    timeout *= 2;
+  }
+  return std::max(initial, std::min(timeout, max));
 }
 
 ModbusRTUContext::Ptr ModbusRTUContext::make(
@@ -1,17 +1,24 @@
 #include "internal/ModbusTechnologyAdapterImplementation.hpp"
 
 #include "internal/ConfigJson.hpp"
+#include "internal/Logging.hpp"
 
 namespace Technology_Adapter::Modbus {
 
 ModbusTechnologyAdapterImplementation::ModbusTechnologyAdapterImplementation(
     ModbusContext::Factory context_factory, Config::Buses bus_configs)
+    : ModbusTechnologyAdapterImplementation(std::move(context_factory),
+          Config::Adapter{std::move(bus_configs), Config::PortDetection()}) {}
+
+ModbusTechnologyAdapterImplementation::ModbusTechnologyAdapterImplementation(
+    ModbusContext::Factory context_factory, Config::Adapter config)
     : ModbusTechnologyAdapterInterface(),
       logger_(HaSLL::LoggerManager::registerLogger(
           "Modbus Adapter implementation")),
-      bus_configs_(std::move(bus_configs)),
+      bus_configs_(std::move(config.buses)),
       context_factory_(std::move(context_factory)),
-      port_finder_(*this, context_factory_) {
+      port_finder_(*this, context_factory_, config.port_detection),
+      workers_("bus workers", WorkerPool::defaultSize(MAX_BUS_WORKERS)) {
 
   logger_->info("Initializing Modbus Technology Adapter implementation");
 }
@@ -19,7 +26,7 @@ ModbusTechnologyAdapterImplementation::ModbusTechnologyAdapterImplementation(
 ModbusTechnologyAdapterImplementation::ModbusTechnologyAdapterImplementation(
     ModbusContext::Factory context_factory, nlohmann::json const& config)
     : ModbusTechnologyAdapterImplementation(
-          std::move(context_factory), Config::BusesOfJson(config)) {}
+          std::move(context_factory), Config::AdapterOfJson(config)) {}
 
 ModbusTechnologyAdapterImplementation::ModbusTechnologyAdapterImplementation(
     ModbusContext::Factory context_factory,
@@ -44,64 +51,140 @@ void ModbusTechnologyAdapterImplementation::start() {
 }
 
 void ModbusTechnologyAdapterImplementation::stop() {
-  *stopping_.lock() = true;
-  // From now on, no thread can be in the main part of `addBus`
+  Logging::Stopwatch total_stopwatch;
+  {
+    std::unique_lock lock(stopping_mutex_);
+    stopping_ = true;
+    starts_finished_.wait(lock, [this]() { return pending_starts_ == 0; });
+  }
+  // From now on, no thread can be in the main part of `addBus` or `startBus`
+  logger_->debug("Waited {} ms for pending bus starts", //
+      total_stopwatch.elapsedMs());
 
   /*
     Stopping all buses.
     We iterate over a copy of `buses_` so that we only need to lock for a short
     time, and thus concurrent `cancelBus` are still possible
   */
+  Logging::Stopwatch stopwatch;
   std::map<Config::Portname, Bus::NonemptyPtr> buses_copy;
   {
     auto buses_access = buses_.lock();
     buses_copy = std::move(*buses_access);
     buses_access->clear();
   }
-  for (auto& port_and_bus : buses_copy) {
-    port_and_bus.second->stop();
+  std::vector<WorkerPool::Task> stop_tasks;
+  stop_tasks.reserve(buses_copy.size());
+  for (auto const& port_and_bus : buses_copy) {
+    auto const& bus = port_and_bus.second;
+    stop_tasks.emplace_back([bus]() { bus->stop(); });
   }
+  workers_.runAll(std::move(stop_tasks));
+  logger_->debug(
+      "Stopped {} buses in {} ms", buses_copy.size(), stopwatch.elapsedMs());
 
+  stopwatch.restart();
   port_finder_.reset();
+  logger_->debug("Reset port finder in {} ms", stopwatch.elapsedMs());
 
-  *stopping_.lock() = false;
+  {
+    std::lock_guard lock(stopping_mutex_);
+    stopping_ = false;
+  }
+  logger_->info("Stopped after {} ms", total_stopwatch.elapsedMs());
 }
 
 void ModbusTechnologyAdapterImplementation::addBus(
-    Config::Bus::NonemptyPtr const& config,
-    Config::Portname const& actual_port) {
+    Config::Bus::NonemptyPtr const& config, Config::Portname const& actual_port,
+    Verification verification, ModbusContext::Ptr const& connection) {
 
-  auto stopping_access = stopping_.lock();
-  if (*stopping_access) {
-    // Don't add anything if we are already in the process of stopping
-    return;
+  {
+    std::lock_guard lock(stopping_mutex_);
+    if (stopping_) {
+      // Don't add anything if we are already in the process of stopping
+      return;
+    }
+    /*
+      If another thread wants to enter the "stopping" stage, it has to wait
+      for us (and `startBus`) to finish doing our damage so that, when it
+      cleans stuff, it does not miss anything we've done.
+    */
+    ++pending_starts_;
   }
-  /*
-    We keep holding the lock on `stopping_`: If another thread wants to enter
-    the "stopping" stage, it has to wait for us to finish doing our damage so
-    that, when it cleans stuff, it does not miss anything we've done.
-  */
 
   logger_->info(
       "Adding bus {} on port {}", config->id.c_str(), actual_port.c_str());
   try {
     auto bus = Bus::NonemptyPtr::make(*this, config, context_factory_,
-        actual_port, Technology_Adapter::NonemptyDeviceRegistryPtr(registry_));
+        actual_port, Technology_Adapter::NonemptyDeviceRegistryPtr(registry_),
+        connection);
     buses_.lock()->insert_or_assign(actual_port, bus);
     try {
-      bus->start(Information_Model::NonemptyDeviceBuilderInterfacePtr(
-          *device_builder_.lock()));
+      workers_.post([this, bus, config, actual_port, verification]() {
+        startBus(bus, *config, actual_port, verification);
+      });
     } catch (...) {
       buses_.lock()->erase(actual_port);
       throw;
     }
   } catch (std::runtime_error const&) {
+    finishStart();
     // exception is already fine
     throw;
   } catch (std::exception const& exception) {
+    finishStart();
     throw std::runtime_error(std::string((std::string_view)(
         "Unable to add bus " + actual_port + ": " + exception.what())));
+  } catch (...) {
+    finishStart();
+    throw;
+  }
+}
+
+void ModbusTechnologyAdapterImplementation::startBus(
+    Bus::NonemptyPtr const& bus, Config::Bus const& config,
+    Config::Portname const& actual_port, Verification verification) {
+
+  Logging::Stopwatch stopwatch;
+  try {
+    bus->start(device_builder_, verification);
+    logger_->info("Started bus on port {} in {} ms", actual_port.c_str(),
+        stopwatch.elapsedMs());
+    if (verification == Verification::None) {
+      // Remembered only now, so that a failed start is not assumed next time
+      port_finder_.remember(config, actual_port);
+    }
+  } catch (std::exception const& exception) {
+    logger_->error("Unable to start bus on port {}: {}", actual_port.c_str(),
+        exception.what());
+
+    /*
+      If `bus` got as far as connecting, it has already cancelled itself,
+      which includes removal from `buses_`. Otherwise, we have to hand the
+      port back to `port_finder_` ourselves.
+    */
+    bool still_listed = false;
+    {
+      auto accessor = buses_.lock();
+      auto iterator = accessor->find(actual_port);
+      if ((iterator != accessor->end()) && (iterator->second == bus)) {
+        accessor->erase(iterator);
+        still_listed = true;
+      }
+    }
+    if (still_listed) {
+      port_finder_.unassign(actual_port);
+    }
+  }
+  finishStart();
+}
+
+void ModbusTechnologyAdapterImplementation::finishStart() {
+  {
+    std::lock_guard lock(stopping_mutex_);
+    --pending_starts_;
   }
+  starts_finished_.notify_all();
 }
 
 void ModbusTechnologyAdapterImplementation::cancelBus(
@@ -119,8 +202,8 @@ void ModbusTechnologyAdapterImplementation::cancelBus(
       auto iterator = accessor->find(port);
       if (iterator != accessor->end()) {
         bus = iterator->second.base();
+        accessor->erase(iterator);
       }
-      accessor->erase(iterator);
     }
   }
 
@@ -1,21 +1,73 @@
+#include <algorithm>
+#include <cerrno>
+#include <set>
+
 #include <HaSLL/LoggerManager.hpp>
 
+#include "Burst.hpp"
 #include "internal/Logging.hpp"
 #include "internal/Port.hpp"
 
 namespace Technology_Adapter::Modbus {
 
 /*
-  This is how long a we wait between attempts in case there is no port.
+  This is how long a we wait between attempts in case there is no port and
+  the port is not watched.
 */
 constexpr size_t HOTPLUG_WAIT_TIME_MS = 100;
 
+/*
+  This is how long we wait at most when all candidates are backing off. It
+  bounds how long stopping the search and trying new candidates may be
+  delayed.
+*/
+constexpr size_t BACKOFF_WAIT_TIME_MS = 100;
+
+namespace {
+
+char const* registerTypeName(LibModbus::ReadableRegisterType type) {
+  switch (type) {
+  case LibModbus::ReadableRegisterType::HoldingRegister:
+    return "holding";
+  case LibModbus::ReadableRegisterType::InputRegister:
+    return "input";
+  default:
+    throw std::logic_error("Incomplete switch");
+  }
+}
+
+// Whether `errno_` indicates a problem with the port rather than the bus
+bool portFailed(int errno_) {
+  return (errno_ == EIO) || (errno_ == ENXIO) || (errno_ == ENODEV) ||
+      (errno_ == EBADF) || (errno_ == EPIPE);
+}
+
+// Falls back to uninterruptible reads if need be
+LibModbus::Cancellation::Ptr makeCancellation(
+    Nonempty::Pointer<HaSLL::LoggerPtr> const& logger) {
+
+  try {
+    return std::make_shared<LibModbus::Cancellation>();
+  } catch (LibModbus::ModbusError const& error) {
+    logger->warning("Reads cannot be cancelled: {}", error.what());
+    return nullptr;
+  }
+}
+
+} // namespace
+
+Port::Entry::Entry(PortFinderPlan::Candidate const& candidate_)
+    : candidate(candidate_) {}
+
 Port::Port(ModbusContext::Factory context_factory, Config::Portname port,
-    SuccessCallback success_callback)
+    SuccessCallback success_callback, WorkerPool& executor,
+    ProbeSchedule schedule, bool watched)
     : context_factory_(std::move(context_factory)),
       logger_(HaSLL::LoggerManager::registerLogger(
           std::string((std::string_view)("Modbus Adapter port " + port)))),
-      port_(std::move(port)), success_callback_(std::move(success_callback)) {
+      port_(std::move(port)), success_callback_(std::move(success_callback)),
+      executor_(executor), schedule_(schedule), watched_(watched),
+      cancellation_(makeCancellation(logger_)) {
 
   logger_->trace("state is Idle");
 }
@@ -23,46 +75,56 @@ Port::Port(ModbusContext::Factory context_factory, Config::Portname port,
 Port::~Port() noexcept {
   Logging::trace(logger_, "Destructing");
 
-  stopThread();
-  for (auto& thread : other_threads_) {
-    thread.join();
-  }
-  other_threads_.clear();
+  stopSearch();
+  std::unique_lock lock(mutex_);
+  step_or_callback_finished_.wait(
+      lock, [this]() { return !callback_scheduled_; });
+
+  // No step runs any more
+  closeContext();
 }
 
 void Port::addCandidate(PortFinderPlan::Candidate const& candidate) {
   logger_->debug("Adding candidate {}", candidate.getBus()->id.c_str());
   {
-    auto state_access = state_.lock();
-    switch (*state_access) {
+    std::unique_lock lock(mutex_);
+    switch (state_) {
     case State::OutOfCandidates:
-      // `search_thread_` is non-empty by the invariant. Hence:
-      // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
-      search_thread_.value().join();
+      // The last step may still be running
+      step_or_callback_finished_.wait(
+          lock, [this]() { return !step_scheduled_; });
 
       [[fallthrough]];
     case State::Idle:
-      // This is the first candidate. We need to start a thread.
+      // This is the first candidate. We need to start searching.
 
       // By the precondition, neither `reset` nor another `addCandidate` runs.
-      // `search` also does not run:
-      // - If we entered via `OutOfCandidates`, we have already called `join`
-      // - If we entered via `Idle`, `search_thread_` is empty by the invariant.
+      // No step runs either:
+      // - If we entered via `OutOfCandidates`, we have already waited
+      // - If we entered via `Idle`, `!step_scheduled_` by the invariant.
       // The fact that nothing else runs provides the thread-safety we need.
 
       // previous candidates, if any, are left-over garbage
       candidates_.clear();
       candidates_.emplace_front(candidate);
-
-      // start a new `search` thread
-      *state_access = State::Searching;
+      next_candidate_ = candidates_.begin();
+      some_port_existed_ = false;
+      some_attempt_made_ = false;
+      round_ = 0;
+      node_appeared_ = false;
+      candidates_unsorted_ = false;
+      probe_cache_.clear();
+
+      state_ = State::Searching;
       logger_->trace("state is Searching");
-      search_thread_.emplace([this] { this->search(); });
+      scheduleStep(std::chrono::milliseconds(0));
 
       break;
 
     case State::Searching:
+    case State::WaitingForPort:
       candidates_.emplace_front(candidate);
+      candidates_unsorted_ = true;
       break;
 
     case State::Found:
@@ -72,130 +134,453 @@ void Port::addCandidate(PortFinderPlan::Candidate const& candidate) {
   }
 }
 
+void Port::nodeAppeared() {
+  std::unique_lock lock(mutex_);
+  switch (state_) {
+  case State::WaitingForPort:
+    // The last step may still be running
+    step_or_callback_finished_.wait(
+        lock, [this]() { return !step_scheduled_; });
+
+    // As in `addCandidate`, nothing else runs now
+    resetBackoffs();
+    sortCandidates();
+    next_candidate_ = candidates_.begin();
+    some_port_existed_ = false;
+    some_attempt_made_ = false;
+    round_ = 0;
+    node_appeared_ = false;
+    probe_cache_.clear();
+
+    state_ = State::Searching;
+    logger_->trace("state is Searching");
+    scheduleStep(std::chrono::milliseconds(0));
+    break;
+
+  case State::Searching:
+    // Don't let the current round end in `WaitingForPort`
+    node_appeared_ = true;
+    resetBackoffs();
+    // A step which waits for back-offs may try right away
+    executor_.expedite(step_ticket_);
+    break;
+
+  default:
+    break;
+  }
+}
+
+void Port::nodeDisappeared() {
+  std::lock_guard lock(mutex_);
+  if (watched_ && (state_ == State::Searching)) {
+    // The step which is scheduled will notice and finish
+    state_ = State::WaitingForPort;
+    logger_->trace("state is WaitingForPort");
+  }
+}
+
+bool Port::assign() {
+  std::unique_lock lock(mutex_);
+  if (state_ == State::Found) {
+    return false;
+  }
+
+  // Like `stopSearch`, but without giving a step the chance to succeed
+  state_ = State::Stopping;
+  logger_->trace("state is Stopping");
+  awaitStep(lock);
+
+  state_ = State::Found;
+  logger_->trace("state is Found");
+  return true;
+}
+
 void Port::reset() {
-  stopThread();
+  stopSearch();
 
-  *state_.lock() = State::Idle;
+  std::lock_guard lock(mutex_);
+  state_ = State::Idle;
   logger_->trace("state is Idle");
 }
 
-void Port::stopThread() {
-  *state_.lock() = State::Stopping;
+std::vector<Port::ScheduledCandidate> Port::schedule() {
+  std::vector<ScheduledCandidate> result;
+  std::lock_guard lock(mutex_);
+  switch (state_) {
+  case State::Searching:
+  case State::WaitingForPort:
+    for (auto const& entry : candidates_) {
+      result.push_back(ScheduledCandidate{
+          entry.candidate.getBus(), entry.failures, entry.not_before});
+    }
+    break;
+  default:
+    break;
+  }
+  return result;
+}
+
+void Port::sortCandidates() {
+  if (!candidates_unsorted_) {
+    return;
+  }
+  candidates_unsorted_ = false;
+
+  std::vector<Entry const*> sorted;
+  for (auto const& entry : candidates_) {
+    sorted.push_back(&entry);
+  }
+  auto settings = [](Entry const* entry) {
+    return Config::serialSettings(*entry->candidate.getBus());
+  };
+  auto less = [&settings](Entry const* lhs, Entry const* rhs) {
+    return settings(lhs) < settings(rhs);
+  };
+  if (std::is_sorted(sorted.begin(), sorted.end(), less)) {
+    return;
+  }
+  std::stable_sort(sorted.begin(), sorted.end(), less);
+
+  std::vector<Entry> entries;
+  entries.reserve(sorted.size());
+  for (auto const* entry : sorted) {
+    entries.push_back(*entry);
+  }
+  candidates_.clear();
+  for (auto const& entry : entries) {
+    candidates_.emplace_back(entry);
+  }
+}
+
+void Port::resetBackoffs() {
+  for (auto& entry : candidates_) {
+    entry.failures = 0;
+    entry.not_before = Clock::time_point();
+  }
+}
+
+void Port::stopSearch() {
+  std::unique_lock lock(mutex_);
+  state_ = State::Stopping;
   logger_->trace("state is Stopping");
+  awaitStep(lock);
+}
+
+void Port::awaitStep(std::unique_lock<std::mutex>& lock) {
+  if (step_scheduled_) {
+    // The step will notice `state_` as soon as it runs or reads
+    executor_.expedite(step_ticket_);
+    if (cancellation_ != nullptr) {
+      cancellation_->cancel();
+    }
+  }
+  step_or_callback_finished_.wait(lock, [this]() { return !step_scheduled_; });
+  if (cancellation_ != nullptr) {
+    cancellation_->reset();
+  }
+}
 
-  if (search_thread_.has_value()) {
-    search_thread_.value().join();
-    search_thread_.reset();
+void Port::scheduleStep(std::chrono::milliseconds delay) {
+  step_scheduled_ = true;
+  try {
+    /*
+      Here, we pass `this` to a task. Hence, a word about lifetimes.
+      `~Port` waits until `!step_scheduled_`, which the task only sets as its
+      last action.
+    */
+    step_ticket_ = executor_.postAfter(delay, [this]() { searchStep(); });
+  } catch (...) {
+    step_scheduled_ = false;
+    state_ = State::OutOfCandidates;
+    step_or_callback_finished_.notify_all();
+    throw;
   }
 }
 
 /*
-  @brief Internal data for `Port::search()`
+  @brief Internal data for `Port::searchStep()`
 */
 struct Port::Search {
   Port& port;
-  Threadsafe::List<PortFinderPlan::Candidate>::iterator next_candidate;
-  bool some_port_existed;
+  Threadsafe::List<Entry>::iterator& next_candidate;
+  bool& some_port_existed;
+  bool attempted = false; // during the present step
 
   void tryCandidate() {
-    if (next_candidate->stillFeasible()) {
-      switch (port.tryCandidate(*next_candidate)) {
-      case TryResult::NoPort:
-        break;
-      case TryResult::NotFound:
-        some_port_existed = true;
-        break;
-      case TryResult::Found: {
-        bool was_still_searching;
-        {
-          auto state_access = port.state_.lock();
-          was_still_searching = *state_access == State::Searching;
-          if (was_still_searching) {
-            *state_access = State::Found;
-            port.logger_->trace("state is Found");
-          }
-        }
+    auto& entry = *next_candidate;
+    auto const& candidate = entry.candidate;
+    if (!candidate.stillFeasible()) {
+      port.logger_->debug(
+          "{} no longer feasible", candidate.getBus()->id.c_str());
+      std::lock_guard lock(port.mutex_);
+      port.candidates_.erase(next_candidate);
+      return;
+    }
+
+    auto now = Clock::now();
+    {
+      std::lock_guard lock(port.mutex_);
+      if (now < entry.not_before) {
+        // still backing off
+        return;
+      }
+    }
+
+    attempted = true;
+    port.some_attempt_made_ = true;
+    port.last_attempt_ = now;
+    switch (port.tryCandidate(candidate)) {
+    case TryResult::NoPort:
+      break;
+    case TryResult::Unavailable: // retried after a back-off like `NotFound`
+    case TryResult::NotFound: {
+      some_port_existed = true;
+      std::lock_guard lock(port.mutex_);
+      ++entry.failures;
+      auto backoff = port.schedule_.randomBackoff(entry.failures);
+      entry.not_before = Clock::now() + backoff;
+      port.logger_->trace("Backing off {} for {} ms",
+          candidate.getBus()->id.c_str(), backoff.count());
+    } break;
+    case TryResult::Found: {
+      bool was_still_searching;
+      {
+        std::lock_guard lock(port.mutex_);
+        was_still_searching = port.state_ == State::Searching;
         if (was_still_searching) {
-          port.other_threads_.emplace_back(
-              port.success_callback_, *next_candidate);
+          port.state_ = State::Found;
+          port.logger_->trace("state is Found");
         }
-      } break;
-      default:
-        throw std::logic_error("Incomplete switch");
       }
-    } else {
-      port.logger_->debug(
-          "{} no longer feasible", next_candidate->getBus()->id.c_str());
-      port.candidates_.erase(next_candidate);
+      if (was_still_searching) {
+        // The successful context goes with the candidate
+        auto connection = std::move(port.open_context_);
+        if (connection != nullptr) {
+          connection->setCancellation(nullptr);
+        }
+        port.succeed(candidate, std::move(connection));
+      }
+    } break;
+    default:
+      throw std::logic_error("Incomplete switch");
     }
   }
 
-  void next() {
+  // Returns the delay before the next step
+  std::chrono::milliseconds next() {
+    std::chrono::milliseconds delay(0);
+    if (attempted) {
+      // Keep the attempt rate below the cap
+      auto earliest = port.last_attempt_ + port.schedule_.minAttemptInterval();
+      delay = std::max(delay,
+          std::chrono::ceil<std::chrono::milliseconds>(earliest - Clock::now()));
+    }
+
     ++next_candidate;
-    if ((*port.state_.lock() == Port::State::Searching) &&
+    std::lock_guard lock(port.mutex_);
+    if ((port.state_ == Port::State::Searching) &&
         (next_candidate == port.candidates_.end())) {
 
       next_candidate = port.candidates_.begin();
       if (next_candidate == port.candidates_.end()) {
-        *port.state_.lock() = Port::State::OutOfCandidates;
+        port.state_ = Port::State::OutOfCandidates;
         port.logger_->trace("state is OutOfCandidates");
       } else {
-        if (!some_port_existed) {
+        if (!port.some_attempt_made_) {
+          // All candidates are backing off. We wait for the first of them.
+          delay = std::max(delay, backoffWaitTime());
+        } else if (!some_port_existed) {
           /*
             The next round of attempts will fail just the same unless some
-            hardware is hot-plugged. We may just as well wait a bit.
+            hardware is hot-plugged.
           */
-          std::this_thread::sleep_for(
-              std::chrono::milliseconds(HOTPLUG_WAIT_TIME_MS));
+          if (!port.watched_) {
+            // We may just as well wait a bit.
+            delay = std::chrono::milliseconds(HOTPLUG_WAIT_TIME_MS);
+          } else if (!port.node_appeared_) {
+            // `nodeAppeared` will resume the search
+            port.state_ = Port::State::WaitingForPort;
+            port.logger_->trace("state is WaitingForPort");
+          }
         }
 
+        if (port.some_attempt_made_) {
+          ++port.round_;
+        }
         some_port_existed = false;
+        port.some_attempt_made_ = false;
+        port.node_appeared_ = false;
+
+        port.sortCandidates();
+        next_candidate = port.candidates_.begin();
       }
+      port.probe_cache_.clear();
     }
+    return delay;
+  }
+
+  // @pre `port.mutex_` is locked
+  std::chrono::milliseconds backoffWaitTime() const {
+    auto first = Clock::time_point::max();
+    for (auto const& entry : port.candidates_) {
+      first = std::min(first, entry.not_before);
+    }
+    auto result = std::chrono::milliseconds(BACKOFF_WAIT_TIME_MS);
+    if (first - Clock::now() < result) {
+      result = std::max(std::chrono::milliseconds(0),
+          std::chrono::ceil<std::chrono::milliseconds>(first - Clock::now()));
+    }
+    return result;
   }
 };
 
-void Port::search() {
-  Search search{*this, candidates_.begin(), false};
+void Port::searchStep() noexcept {
+  // By the invariant, we are the only step. Hence `next_candidate_` is ours.
+  // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+  Search search{*this, next_candidate_.value(), some_port_existed_};
+  std::chrono::milliseconds delay(0);
 
-  while (*state_.lock() == State::Searching) {
-    if (search.next_candidate == candidates_.end()) {
-      *state_.lock() = State::OutOfCandidates;
-      logger_->trace("state is OutOfCandidates");
-    } else {
+  try {
+    bool searching;
+    {
+      std::lock_guard lock(mutex_);
+      searching = state_ == State::Searching;
+      if (searching && (search.next_candidate == candidates_.end())) {
+        state_ = State::OutOfCandidates;
+        logger_->trace("state is OutOfCandidates");
+        searching = false;
+      }
+    }
+    if (searching) {
       search.tryCandidate();
-      search.next();
+      delay = search.next();
     }
+  } catch (std::exception const& exception) {
+    Logging::error(logger_, "Search step failed: {}", exception.what());
+  }
+
+  ModbusContext::Ptr finished_context;
+  {
+    std::lock_guard lock(mutex_);
+    if (state_ == State::Searching) {
+      try {
+        scheduleStep(delay);
+        return;
+      } catch (std::exception const& exception) {
+        Logging::error(
+            logger_, "Cannot continue search: {}", exception.what());
+        // `scheduleStep` has already cleaned up
+      }
+    } else {
+      // Once `!step_scheduled_`, `*this` may vanish. Hence we close later.
+      finished_context = std::move(open_context_);
+      step_scheduled_ = false;
+      step_or_callback_finished_.notify_all();
+      Logging::trace(logger_, "Finishing search");
+    }
+  }
+  if (finished_context != nullptr) {
+    finished_context->close();
+  }
+}
+
+void Port::succeed(PortFinderPlan::Candidate const& candidate,
+    ModbusContext::Ptr connection) noexcept {
+
+  {
+    std::lock_guard lock(mutex_);
+    callback_scheduled_ = true;
+  }
+  try {
+    // `~Port` waits for `!callback_scheduled_`, so `this` stays valid
+    executor_.post([this, candidate, connection]() {
+      try {
+        success_callback_(candidate, connection);
+      } catch (...) {
+        std::lock_guard lock(mutex_);
+        callback_scheduled_ = false;
+        step_or_callback_finished_.notify_all();
+        throw;
+      }
+      std::lock_guard lock(mutex_);
+      callback_scheduled_ = false;
+      step_or_callback_finished_.notify_all();
+    });
+  } catch (std::exception const& exception) {
+    Logging::error(logger_, "Cannot report success: {}", exception.what());
+    std::lock_guard lock(mutex_);
+    callback_scheduled_ = false;
+    step_or_callback_finished_.notify_all();
   }
-  logger_->trace("Finishing search");
 }
 
 Port::TryResult Port::tryCandidate(
     PortFinderPlan::Candidate const& candidate) noexcept {
 
   Logging::debug(logger_, "Trying {}", candidate.getBus()->id.c_str());
+  bool port_missing = false;
+  auto context = openContext(*candidate.getBus(), port_missing);
+  if (context == nullptr) {
+    return port_missing ? TryResult::NoPort : TryResult::Unavailable;
+  }
+  bool result = tryCandidate(candidate, context);
+  if (context_broken_) {
+    // Maybe the device node is gone. The next attempt will tell.
+    Logging::debug(logger_, "Closing the port after an I/O error");
+    closeContext();
+  }
+  return result ? TryResult::Found : TryResult::NotFound;
+}
+
+ModbusContext::Ptr Port::openContext(
+    Config::Bus const& bus, bool& port_missing) noexcept {
+  auto settings = Config::serialSettings(bus);
+  if ((open_context_ != nullptr) && (open_settings_ == settings)) {
+    try {
+      open_context_->configure(bus, ModbusContext::Purpose::PortAutoDetection);
+      open_context_->setDetectionRound(round_);
+      return open_context_;
+    } catch (std::exception const& exception) {
+      Logging::error(
+          logger_, "While reconfiguring context: {}", exception.what());
+    }
+  }
+  closeContext();
+
   try {
-    auto const& bus = *candidate.getBus();
     auto context =
         context_factory_(port_, bus, ModbusContext::Purpose::PortAutoDetection);
+    context->setDetectionRound(round_);
+    context->setCancellation(cancellation_);
     try {
       context->connect();
-      bool result = tryCandidate(candidate, context);
-      context->close();
-      return result ? TryResult::Found : TryResult::NotFound;
-    } catch (std::exception const& exception) {
+    } catch (LibModbus::ModbusError const& error) {
       /*
-        Above, everything after `connect` is `noexcept.
-        Hence it was `connect` that threw.
-        Thus we don't have to `close` the context.
+        Only a missing node is worth waiting for a notification. Other
+        errors, such as `EBUSY` or `EACCES`, may pass without any.
       */
+      Logging::error(logger_, "While connecting: {}", error.what());
+      port_missing = error.errno_ == ENOENT;
+      return nullptr;
+    } catch (std::exception const& exception) {
       Logging::error(logger_, "While connecting: {}", exception.what());
-      return TryResult::NoPort;
+      return nullptr;
     }
+    open_context_ = context;
+    open_settings_ = settings;
+    return context;
   } catch (std::exception const& exception) {
     Logging::error(logger_, "While creating context: {}", exception.what());
-    return TryResult::NoPort;
+    return nullptr;
+  }
+}
+
+void Port::closeContext() noexcept {
+  if (open_context_ != nullptr) {
+    open_context_->close();
+    open_context_.reset();
   }
+  context_broken_ = false;
 }
 
 bool Port::tryCandidate(PortFinderPlan::Candidate const& candidate,
@@ -203,45 +588,82 @@ bool Port::tryCandidate(PortFinderPlan::Candidate const& candidate,
 
   auto const& bus = *candidate.getBus();
   try {
-    uint16_t value;
+    auto& cached = probe_cache_.forBus(bus);
+
+    auto probes = candidate.probes();
+
+    // First, identification where configured, one request per device
+    std::set<Config::Device const*> identified;
     for (auto const& device : bus.devices) {
-      context->selectDevice(*device);
-      for (auto holding_register : device->holding_registers) {
-        Logging::trace(logger_, "Trying to read holding register {} of {}",
-            holding_register, device->id.c_str());
-        try {
-          int num_read = context->readRegisters(holding_register,
-              LibModbus::ReadableRegisterType::HoldingRegister, 1, &value);
-          if (num_read != 1) {
-            Logging::trace(logger_,
-                "Holding register {} of {} could not be read", holding_register,
-                device->id.c_str());
-            return false;
-          }
-        } catch (std::exception const& exception) {
-          Logging::error(logger_,
-              "Holding register {} of {} could not be read: {}",
-              holding_register, device->id.c_str(), exception.what());
-          return false;
-        }
+      if (!device->identification.has_value()) {
+        continue;
       }
-      for (auto input_register : device->input_registers) {
-        Logging::trace(logger_, "Trying to read input register {} of {}",
-            input_register, device->id.c_str());
-        try {
-          int num_read = context->readRegisters(input_register,
-              LibModbus::ReadableRegisterType::InputRegister, 1, &value);
-          if (num_read != 1) {
-            Logging::debug(logger_, "Input register {} of {} could not be read",
-                input_register, device->id.c_str());
-            return false;
-          }
-        } catch (std::exception const& exception) {
-          Logging::error(logger_,
-              "Input register {} of {} could not be read: {}", input_register,
-              device->id.c_str(), exception.what());
+      switch (
+          identify(context, *device, cached, probes.identification_required)) {
+      case IdentifyOutcome::Match:
+        identified.insert(&*device);
+        break;
+      case IdentifyOutcome::Mismatch:
+        Logging::debug(logger_, "{} rejected by identification of {}",
+            bus.id.c_str(), device->id.c_str());
+        return false;
+      case IdentifyOutcome::NoResponse:
+        Logging::debug(logger_, "{} failed identification of {}",
+            bus.id.c_str(), device->id.c_str());
+        return false;
+      case IdentifyOutcome::Unsupported:
+        if (probes.identification_required) {
+          // Registers cannot tell this bus apart from another one
+          Logging::debug(logger_, "{} could not be told apart by {}",
+              bus.id.c_str(), device->id.c_str());
           return false;
         }
+        break;
+      default:
+        throw std::logic_error("Incomplete switch");
+      }
+    }
+    if (identified.size() == bus.devices.size()) {
+      Logging::debug(logger_, "{} was identified", bus.id.c_str());
+      return true;
+    }
+
+    /*
+      Then, for the other devices, a few cheap probes which reject most wrong
+      candidates. Only if they pass do we read everything.
+    */
+    auto skip_identified = [&identified](
+                               std::vector<PortFinderPlan::Probe>& probes_) {
+      probes_.erase(std::remove_if(probes_.begin(), probes_.end(),
+                        [&identified](auto const& probe) {
+                          return identified.count(&*probe.device) > 0;
+                        }),
+          probes_.end());
+    };
+    skip_identified(probes.liveness);
+    skip_identified(probes.distinguishing);
+    if (!readProbes(probes.liveness, context, cached)) {
+      Logging::debug(logger_, "{} failed liveness check", bus.id.c_str());
+      return false;
+    }
+    if (!readProbes(probes.distinguishing, context, cached)) {
+      Logging::debug(logger_, "{} rejected by distinguishing probes",
+          bus.id.c_str());
+      return false;
+    }
+
+    for (auto const& device : bus.devices) {
+      if (identified.count(&*device) > 0) {
+        continue;
+      }
+      auto holding_plan = BurstPlan::allOf(device->holding_registers,
+          LibModbus::ReadableRegisterType::HoldingRegister,
+          device->burst_size);
+      auto input_plan = BurstPlan::allOf(device->input_registers,
+          LibModbus::ReadableRegisterType::InputRegister, device->burst_size);
+      if (!readBursts(holding_plan, *device, context, cached) ||
+          !readBursts(input_plan, *device, context, cached)) {
+        return false;
       }
     }
 
@@ -256,4 +678,180 @@ bool Port::tryCandidate(PortFinderPlan::Candidate const& candidate,
   }
 }
 
+Port::ReadOutcome Port::readRegisters(ModbusContext::Ptr const& context,
+    Config::Device const& device, LibModbus::ReadableRegisterType type,
+    RegisterIndex start_register, int num_registers, uint16_t* buffer,
+    ProbeCache::Results& cached) {
+
+  try {
+    context->selectDevice(device);
+    int num_read =
+        context->readRegisters(start_register, type, num_registers, buffer);
+    if (num_read == num_registers) {
+      cached.recordReadable(
+          device.slave_id, type, start_register, num_registers);
+      return ReadOutcome::Success;
+    }
+    Logging::trace(logger_, "{} {} register(s) from {} of {} could not be read",
+        num_registers, registerTypeName(type), start_register,
+        device.id.c_str());
+  } catch (LibModbus::ModbusError const& error) {
+    Logging::trace(logger_,
+        "{} {} register(s) from {} of {} could not be read: {}", num_registers,
+        registerTypeName(type), start_register, device.id.c_str(),
+        error.what());
+    if (error.errno_ == ECANCELED) {
+      // The search is stopping. The outcome tells nothing about the bus.
+      return ReadOutcome::NoResponse;
+    }
+    if (error.errno_ == ETIMEDOUT) {
+      cached.recordSilent(device.slave_id);
+      return ReadOutcome::NoResponse;
+    }
+    if (portFailed(error.errno_)) {
+      context_broken_ = true;
+      return ReadOutcome::NoResponse;
+    }
+  }
+  if (num_registers == 1) {
+    cached.recordUnreadable(device.slave_id, type, start_register);
+  }
+  return ReadOutcome::Failure;
+}
+
+Port::IdentifyOutcome Port::identify(ModbusContext::Ptr const& context,
+    Config::Device const& device, ProbeCache::Results& cached, bool strict) {
+
+  if (cached.silent(device.slave_id)) {
+    Logging::trace(logger_, "{} is known to be silent", device.id.c_str());
+    return IdentifyOutcome::NoResponse;
+  }
+
+  std::optional<LibModbus::DeviceIdentification> identity;
+  auto const* known = cached.identity(device.slave_id);
+  if (known != nullptr) {
+    identity = *known;
+  } else {
+    try {
+      Logging::trace(logger_, "Asking {} to identify", device.id.c_str());
+      context->selectDevice(device);
+      identity = context->identify();
+      cached.recordIdentity(device.slave_id, identity);
+    } catch (LibModbus::ModbusError const& error) {
+      Logging::trace(logger_, "{} did not identify: {}", device.id.c_str(),
+          error.what());
+      if (error.errno_ == ECANCELED) {
+        return IdentifyOutcome::NoResponse;
+      }
+      if (error.errno_ == ETIMEDOUT) {
+        cached.recordSilent(device.slave_id);
+        return IdentifyOutcome::NoResponse;
+      }
+      if (portFailed(error.errno_)) {
+        context_broken_ = true;
+        return IdentifyOutcome::NoResponse;
+      }
+      if (error.unsupportedRequest()) {
+        cached.recordIdentity(device.slave_id, std::nullopt);
+      }
+      // Otherwise, e.g. for a bad CRC, registers may do better this time
+      return IdentifyOutcome::Unsupported;
+    }
+  }
+
+  if (!identity.has_value() || (strict && !identity->server_id.empty())) {
+    return IdentifyOutcome::Unsupported;
+  }
+  // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+  return device.identification->matches(*identity) ? IdentifyOutcome::Match
+                                                   : IdentifyOutcome::Mismatch;
+}
+
+bool Port::readProbes(std::vector<PortFinderPlan::Probe> const& probes,
+    ModbusContext::Ptr const& context, ProbeCache::Results& cached) {
+
+  uint16_t value;
+  for (auto const& probe : probes) {
+    auto const& device = *probe.device;
+    if (cached.silent(device.slave_id)) {
+      Logging::trace(logger_, "{} is known to be silent", device.id.c_str());
+      return false;
+    }
+    switch (cached.lookup(device.slave_id, probe.type, probe.register_index)) {
+    case ProbeCache::Result::Readable:
+      continue;
+    case ProbeCache::Result::Unreadable:
+      return false;
+    case ProbeCache::Result::Unknown:
+      break;
+    default:
+      throw std::logic_error("Incomplete switch");
+    }
+
+    Logging::trace(logger_, "Probing {} register {} of {}",
+        registerTypeName(probe.type), probe.register_index, device.id.c_str());
+    if (readRegisters(context, device, probe.type, probe.register_index, 1,
+            &value, cached) != ReadOutcome::Success) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Port::readBursts(BurstPlan const& plan, Config::Device const& device,
+    ModbusContext::Ptr const& context, ProbeCache::Results& cached) {
+
+  std::vector<uint16_t> buffer(device.burst_size > 0 ? device.burst_size : 1);
+  for (auto const& burst : plan.bursts) {
+    if (cached.silent(device.slave_id)) {
+      Logging::trace(logger_, "{} is known to be silent", device.id.c_str());
+      return false;
+    }
+    switch (cached.lookup(device.slave_id, burst.type, burst.start_register,
+        burst.num_registers)) {
+    case ProbeCache::Result::Readable:
+      continue;
+    case ProbeCache::Result::Unreadable:
+      return false;
+    case ProbeCache::Result::Unknown:
+      break;
+    default:
+      throw std::logic_error("Incomplete switch");
+    }
+
+    Logging::trace(logger_, "Trying to read {} {} register(s) from {} of {}",
+        burst.num_registers, registerTypeName(burst.type), burst.start_register,
+        device.id.c_str());
+    switch (readRegisters(context, device, burst.type, burst.start_register,
+        burst.num_registers, buffer.data(), cached)) {
+    case ReadOutcome::Success:
+      continue;
+    case ReadOutcome::NoResponse:
+      return false;
+    case ReadOutcome::Failure:
+      break;
+    default:
+      throw std::logic_error("Incomplete switch");
+    }
+    if (burst.num_registers == 1) {
+      return false;
+    }
+
+    // Locate the failure
+    for (RegisterIndex r = burst.start_register;
+        r < burst.start_register + burst.num_registers; ++r) {
+      if (readRegisters(context, device, burst.type, r, 1, buffer.data(),
+              cached) != ReadOutcome::Success) {
+        return false;
+      }
+    }
+    Logging::debug(logger_,
+        "Burst of {} {} registers from {} of {} failed, yet all of its "
+        "registers could be read singly",
+        burst.num_registers, registerTypeName(burst.type), burst.start_register,
+        device.id.c_str());
+  }
+  return true;
+}
+
 } // namespace Technology_Adapter::Modbus
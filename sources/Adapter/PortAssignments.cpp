@@ -0,0 +1,92 @@
+#include "internal/PortAssignments.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+#include <HaSLL/LoggerManager.hpp>
+#include <nlohmann/json.hpp>
+
+#include "internal/Logging.hpp"
+
+namespace Technology_Adapter::Modbus {
+
+PortAssignments::PortAssignments(std::string file_path)
+    : file_path_(std::move(file_path)),
+      logger_(HaSLL::LoggerManager::registerLogger(
+          "Modbus Adapter port assignments")) {
+
+  if (!file_path_.empty()) {
+    load();
+  }
+}
+
+std::optional<Config::Portname> PortAssignments::lookup(
+    Config::Bus const& bus) const {
+
+  std::lock_guard lock(mutex_);
+  auto iterator = assignments_.find(std::string((std::string_view)bus.id));
+  if (iterator == assignments_.end()) {
+    return std::nullopt;
+  }
+  return Config::Portname(iterator->second);
+}
+
+void PortAssignments::remember(
+    Config::Bus const& bus, Config::Portname const& port) noexcept {
+
+  if (file_path_.empty()) {
+    return;
+  }
+  try {
+    std::lock_guard lock(mutex_);
+    auto& entry = assignments_[std::string((std::string_view)bus.id)];
+    auto port_string = std::string((std::string_view)port);
+    if (entry != port_string) {
+      entry = std::move(port_string);
+      save();
+    }
+  } catch (std::exception const& exception) {
+    Logging::error(logger_, "Cannot remember bus {} on port {}: {}",
+        bus.id.c_str(), port.c_str(), exception.what());
+  }
+}
+
+void PortAssignments::load() {
+  std::ifstream input_stream(file_path_);
+  if (!input_stream) {
+    logger_->info("No port assignments in {}", file_path_);
+    return;
+  }
+  try {
+    nlohmann::json json;
+    input_stream >> json;
+    assignments_ = json.get<std::map<std::string, std::string>>();
+    logger_->info(
+        "Loaded {} port assignment(s) from {}", assignments_.size(), file_path_);
+  } catch (std::exception const& exception) {
+    logger_->warning(
+        "Ignoring port assignments in {}: {}", file_path_, exception.what());
+    assignments_.clear();
+  }
+}
+
+void PortAssignments::save() const {
+  /*
+    We write to a temporary file first and then rename it, so that the file
+    is never left half-written, e.g., after a power loss.
+  */
+  std::string temporary_path = file_path_ + ".tmp";
+  {
+    std::ofstream output_stream(temporary_path, std::ios::trunc);
+    output_stream << nlohmann::json(assignments_).dump(2) << std::endl;
+    if (!output_stream) {
+      throw std::runtime_error("Cannot write " + temporary_path);
+    }
+  }
+  if (std::rename(temporary_path.c_str(), file_path_.c_str()) != 0) {
+    throw std::runtime_error("Cannot replace " + file_path_);
+  }
+  logger_->debug("Saved port assignments to {}", file_path_);
+}
+
+} // namespace Technology_Adapter::Modbus
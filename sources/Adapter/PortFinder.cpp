@@ -7,62 +7,212 @@
 namespace Technology_Adapter::Modbus {
 
 PortFinder::PortFinder(ModbusTechnologyAdapterInterface& owner,
-    ModbusContext::Factory context_factory)
+    ModbusContext::Factory context_factory,
+    Config::PortDetection const& config)
     : owner_(owner), context_factory_(std::move(context_factory)),
       plan_(PortFinderPlan::make()),
       logger_(
-          HaSLL::LoggerManager::registerLogger("Modbus Adapter port finder")) {}
+          HaSLL::LoggerManager::registerLogger("Modbus Adapter port finder")),
+      executor_("port detection", config.max_concurrent_probes),
+      probe_schedule_(config),
+      assignments_(config.state_file),
+      direct_connect_(config.direct_connect),
+      watcher_(
+          [this](std::string const& path, bool present) {
+            nodeChanged(path, present);
+          },
+          config.watch_hotplug) {
+
+  logger_->info("Candidates back off for {} to {} ms, i.e., each of them is "
+                "tried at most {:.2f} times per second in the long run",
+      config.backoff_initial, config.backoff_max,
+      probe_schedule_.steadyStateAttemptRate(1));
+}
 
 void PortFinder::addBuses(Config::Buses const& new_buses) {
   logger_->info("Adding {} buses to the search", new_buses.size());
-  addCandidates(plan_->addBuses(new_buses));
+
+  auto plan = plan_;
+  auto candidates = plan->addBuses(new_buses);
+  for (auto const& bus : new_buses) {
+    addPatterns(*plan, bus, candidates);
+  }
+
+  PortFinderPlan::NewCandidates to_search;
+  for (auto& candidate : candidates) {
+    bool assumed = false;
+    if (candidate.stillFeasible()) {
+      auto const& bus = candidate.getBus();
+      auto const& port = candidate.getPort();
+      auto remembered_port = assignments_.lookup(*bus);
+      if (remembered_port.has_value() && (*remembered_port == port)) {
+        logger_->info("Assuming bus {} on port {} as in the previous run",
+            bus->id.c_str(), port.c_str());
+        assumed = assumeCandidate(candidate, Verification::Eager);
+      } else if (direct_connect_ && candidate.uncontested()) {
+        logger_->info("Connecting bus {} directly to its only port {}",
+            bus->id.c_str(), port.c_str());
+        assumed = assumeCandidate(candidate, Verification::Lazy);
+      }
+    }
+    if (!assumed) {
+      to_search.push_back(std::move(candidate));
+    }
+  }
+  /*
+    Some of `to_search` may have become infeasible by the assumptions. `Port`
+    sorts them out.
+  */
+  addCandidates(std::move(to_search));
+}
+
+void PortFinder::addPatterns(PortFinderPlan& plan,
+    Config::Bus::NonemptyPtr const& bus,
+    PortFinderPlan::NewCandidates& candidates) {
+
+  for (auto const& port_name : bus->possible_serial_ports) {
+    std::string pattern((std::string_view)port_name);
+    if (HotplugWatcher::isPattern(pattern)) {
+      // Register first, so that no appearing node is missed
+      patterns_.lock()->emplace_back(pattern, bus);
+      if (!watcher_.watchDirectoryOf(pattern)) {
+        logger_->warning(
+            "Cannot watch for {}. Only nodes present now will be considered",
+            pattern);
+      }
+      for (auto const& match : HotplugWatcher::expand(pattern)) {
+        logger_->debug("{} matches {}", pattern, match);
+        auto new_candidates =
+            plan.addPossiblePort(bus, Config::Portname(match));
+        candidates.insert(candidates.end(), new_candidates.begin(),
+            new_candidates.end());
+      }
+    }
+  }
+}
+
+void PortFinder::nodeChanged(std::string const& path, bool present) {
+  Config::Portname port(path);
+
+  if (present) {
+    std::vector<Config::Bus::NonemptyPtr> buses;
+    for (auto const& pattern : *patterns_.lock()) {
+      if (HotplugWatcher::matches(pattern.first, path)) {
+        buses.push_back(pattern.second);
+      }
+    }
+    if (!buses.empty()) {
+      std::optional<decltype(plan_)> plan;
+      {
+        auto ports_access = ports_.lock();
+        if (resetting_) {
+          return;
+        }
+        plan = plan_;
+      }
+      PortFinderPlan::NewCandidates candidates;
+      for (auto const& bus : buses) {
+        logger_->debug("{} matches a pattern of {}", path, bus->id.c_str());
+        auto new_candidates = plan.value()->addPossiblePort(bus, port);
+        candidates.insert(candidates.end(), new_candidates.begin(),
+            new_candidates.end());
+      }
+      addCandidates(std::move(candidates));
+    }
+  }
+
+  auto ports_access = ports_.lock();
+  if (resetting_) {
+    return;
+  }
+  auto port_iterator = ports_access->find(port);
+  if (port_iterator != ports_access->end()) {
+    if (present) {
+      port_iterator->second.nodeAppeared();
+    } else {
+      port_iterator->second.nodeDisappeared();
+    }
+  }
 }
 
 void PortFinder::unassign(Config::Portname const& port) {
   {
     auto ports_access = ports_.lock();
-    ports_access->find(port)->second.reset();
+    auto port_iterator = ports_access->find(port);
+    if (port_iterator == ports_access->end()) {
+      // We are being reset
+      return;
+    }
+    port_iterator->second.reset();
   }
   // Now we are already open for `addCandidates` from other threads.
   addCandidates(plan_->unassign(port));
 }
 
+void PortFinder::remember(
+    Config::Bus const& bus, Config::Portname const& port) noexcept {
+
+  assignments_.remember(bus, port);
+}
+
 void PortFinder::reset() {
   logger_->trace("Resetting");
-  ports_.lock()->clear();
-  plan_ = PortFinderPlan::make();
+  {
+    /*
+      `~Port` waits for success callbacks which may lock `ports_`. Hence we
+      destruct the `Port`s outside of the lock.
+    */
+    std::map<Config::Portname, Port> ports;
+    {
+      auto ports_access = ports_.lock();
+      resetting_ = true;
+      ports_access->swap(ports);
+    }
+  }
+  patterns_.lock()->clear();
+  {
+    // `nodeChanged` reads `plan_` under the lock
+    auto ports_access = ports_.lock();
+    plan_ = PortFinderPlan::make();
+    resetting_ = false;
+  }
 }
 
 void PortFinder::addCandidates(PortFinderPlan::NewCandidates&& candidates) {
   logger_->debug("Adding {} candidate(s)", candidates.size());
   for (auto const& candidate : candidates) {
-    auto const& portname = candidate.getPort();
     auto ports_access = ports_.lock();
-    auto port_emplace_result = ports_access->try_emplace( //
-        portname, // key for the map
-        context_factory_,
-        portname, // first argument to `Port` constructor
-        /*
-          Here, we pass `this` to a lambda. Hence, a word about lifetimes.
-          The lambda in question is only used in the search thread of some
-          `Port` in `ports_`. That thread ends with the lifetime of the `Port`,
-          which is included in the lifetime of `ports_` and thus of `*this`.
-        */
-        [this](PortFinderPlan::Candidate const& candidate) {
-          confirmCandidate(candidate);
-        });
-    auto& port = port_emplace_result.first->second;
-    port.addCandidate(candidate);
+    if (resetting_) {
+      return;
+    }
+    getPort(ports_access, candidate.getPort()).addCandidate(candidate);
+  }
+}
+
+bool PortFinder::assumeCandidate(
+    PortFinderPlan::Candidate const& candidate, Verification verification) {
+
+  {
+    auto ports_access = ports_.lock();
+    if (resetting_ || !getPort(ports_access, candidate.getPort()).assign()) {
+      return false;
+    }
   }
+  confirmCandidate(candidate, verification, nullptr);
+  return true;
 }
 
-void PortFinder::confirmCandidate(PortFinderPlan::Candidate const& candidate) {
+void PortFinder::confirmCandidate(PortFinderPlan::Candidate const& candidate,
+    Verification verification, ModbusContext::Ptr const& connection) {
+
   auto const& bus = candidate.getBus();
   auto const& port = candidate.getPort();
-  logger_->info("Found bus {} on port {}", bus->id.c_str(), port.c_str());
+  if (verification == Verification::None) {
+    logger_->info("Found bus {} on port {}", bus->id.c_str(), port.c_str());
+  }
   addCandidates(candidate.confirm());
   try {
-    owner_.addBus(bus, port);
+    owner_.addBus(bus, port, verification, connection);
   } catch (std::exception const& exception) {
     logger_->error("While adding bus {} on port {}: {}", bus->id.c_str(),
         port.c_str(), exception.what());
@@ -70,4 +220,27 @@ void PortFinder::confirmCandidate(PortFinderPlan::Candidate const& candidate) {
   }
 }
 
+Port& PortFinder::getPort(
+    Ports::ScopedAccessor& ports_access, Config::Portname const& portname) {
+
+  return ports_access
+      ->try_emplace( //
+          portname, // key for the map
+          context_factory_,
+          portname, // first argument to `Port` constructor
+          /*
+            Here, we pass `this` to a lambda. Hence, a word about lifetimes.
+            The lambda in question is only used as a task of some `Port` in
+            `ports_`. `~Port` waits for that task, and the lifetime of the
+            `Port` is included in the lifetime of `*this`.
+          */
+          [this](PortFinderPlan::Candidate const& candidate,
+              ModbusContext::Ptr const& connection) {
+            confirmCandidate(candidate, Verification::None, connection);
+          },
+          executor_, probe_schedule_,
+          watcher_.watchDirectoryOf(std::string((std::string_view)portname)))
+      .first->second;
+}
+
 } // namespace Technology_Adapter::Modbus
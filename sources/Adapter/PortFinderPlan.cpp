@@ -1,52 +1,224 @@
 #include "internal/PortFinderPlan.hpp"
 
 #include <algorithm>
+#include <map>
+
+#include "internal/HotplugWatcher.hpp"
 
 namespace Technology_Adapter::Modbus {
 
 namespace Internal_ {
 
 /*
-  `Device` comparison: registers are subsets
-  If `smaller <= larger`, then a check for `smaller` might have `larger` as a
-  false positive.
+  Whether no device can match both `a` and `b`.
+  Empty strings match anything, so only strings given on both sides count.
+  A Report Server ID reply matches by substring, so neither string may
+  contain the other. Even then, one server ID may contain both strings. Hence
+  `Port` accepts only Read Device Identification wherever identification is
+  all that tells buses apart (see `Probes::identification_required`).
 */
-bool operator<=(Config::Device const& smaller, Config::Device const& larger) {
+bool excludeEachOther(
+    Config::Identification const& a, Config::Identification const& b) {
+
+  auto differ = [](ConstString::ConstString const& x,
+                    ConstString::ConstString const& y) {
+    auto x_view = (std::string_view)x;
+    auto y_view = (std::string_view)y;
+    return !x_view.empty() && !y_view.empty() &&
+        (x_view.find(y_view) == std::string_view::npos) &&
+        (y_view.find(x_view) == std::string_view::npos);
+  };
+  return differ(a.vendor, b.vendor) || differ(a.product, b.product) ||
+      differ(a.revision, b.revision);
+}
+
+/*
+  `Device` comparison by registers only: registers are subsets
+  If `registersWithin(smaller, larger)`, then reading the registers of
+  `smaller` might have `larger` as a false positive.
+*/
+bool registersWithin(
+    Config::Device const& smaller, Config::Device const& larger) {
   return (smaller.slave_id == larger.slave_id) &&
       (smaller.holding_registers <= larger.holding_registers) &&
       (smaller.input_registers <= larger.input_registers);
 }
 
 /*
-  `Bus` comparison: all devices are subsets
+  `Device` comparison: registers are subsets and identifications may agree
+  If `smaller <= larger`, then a check for `smaller` might have `larger` as a
+  false positive. Identifications which exclude each other tell devices apart
+  regardless of registers, provided `Port` gets a Read Device Identification
+  reply.
+*/
+bool operator<=(Config::Device const& smaller, Config::Device const& larger) {
+  if (smaller.identification.has_value() &&
+      larger.identification.has_value() &&
+      excludeEachOther(
+          smaller.identification.value(), larger.identification.value())) {
+    return false;
+  }
+  return registersWithin(smaller, larger);
+}
+
+BusSignature::BusSignature(Config::Bus const& bus) {
+  std::map<int, Devices> grouped;
+  for (auto const& device : bus.devices) {
+    grouped[device->slave_id].push_back(device);
+  }
+  devices_by_slave_id.reserve(grouped.size());
+  for (auto& group : grouped) {
+    devices_by_slave_id.emplace_back(group.first, std::move(group.second));
+  }
+}
+
+/*
+  Whether every device of `smaller` is `within` some device of `larger`
+
+  Both sides are sorted by slave id, so a single pass over them suffices. Only
+  devices with equal slave ids are compared.
+*/
+template <class Within>
+bool busWithin(
+    BusSignature const& smaller, BusSignature const& larger, Within within) {
+  auto larger_group = larger.devices_by_slave_id.begin();
+  auto larger_end = larger.devices_by_slave_id.end();
+  for (auto const& smaller_group : smaller.devices_by_slave_id) {
+    while ((larger_group != larger_end) &&
+        (larger_group->first < smaller_group.first)) {
+      ++larger_group;
+    }
+    if ((larger_group == larger_end) ||
+        (larger_group->first != smaller_group.first)) {
+      return false;
+    }
+    auto const& larger_devices = larger_group->second;
+    for (auto const& smaller_device : smaller_group.second) {
+      if (std::none_of(larger_devices.begin(), larger_devices.end(),
+              [&smaller_device, &within](
+                  // NOLINTNEXTLINE(modernize-pass-by-value)
+                  Config::Device::NonemptyPtr const& larger_device) -> bool {
+                //
+                return within(*smaller_device, *larger_device);
+              })) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+
+/*
+  `Bus` comparison: all devices are subsets, in the sense of the `Device`
+  comparison above, so identifications apply here as well
   If `smaller <= larger`, then a search for `smaller` might have `larger` as a
   false positive. Hence we need to search for `larger` first.
 */
-bool operator<=(Config::Bus const& smaller, Config::Bus const& larger) {
-  return std::all_of(smaller.devices.begin(), smaller.devices.end(),
-      [&larger](Config::Device::NonemptyPtr const& smaller_device) -> bool {
-        return std::any_of(larger.devices.begin(), larger.devices.end(),
-            [&smaller_device](
-                // NOLINTNEXTLINE(modernize-pass-by-value)
-                Config::Device::NonemptyPtr const& larger_device) -> bool {
-              //
-              return *smaller_device <= *larger_device;
-            });
+bool operator<=(BusSignature const& smaller, BusSignature const& larger) {
+  return busWithin(smaller, larger,
+      [](Config::Device const& smaller_device,
+          Config::Device const& larger_device) -> bool {
+        return smaller_device <= larger_device;
+      });
+}
+
+// `Bus` comparison by registers only, in the sense of `registersWithin`
+bool registersWithin(BusSignature const& smaller, BusSignature const& larger) {
+  return busWithin(smaller, larger,
+      [](Config::Device const& smaller_device,
+          Config::Device const& larger_device) -> bool {
+        return registersWithin(smaller_device, larger_device);
       });
 }
 
+// The first register of `device`, if any
+std::optional<PortFinderPlan::Probe> livenessProbe(
+    Config::Device::NonemptyPtr const& device) {
+
+  auto const& holding = device->holding_registers;
+  if (holding.begin() != holding.end()) {
+    return PortFinderPlan::Probe{
+        device, LibModbus::ReadableRegisterType::HoldingRegister,
+        *holding.begin()};
+  }
+  auto const& input = device->input_registers;
+  if (input.begin() != input.end()) {
+    return PortFinderPlan::Probe{
+        device, LibModbus::ReadableRegisterType::InputRegister,
+        *input.begin()};
+  }
+  return std::nullopt;
+}
+
+// Whether `probe` fails if `bus` is the actual bus
+bool rejects(PortFinderPlan::Probe const& probe, Config::Bus const& bus) {
+  return std::none_of(bus.devices.begin(), bus.devices.end(),
+      [&probe](Config::Device::NonemptyPtr const& device) -> bool {
+        if (device->slave_id != probe.device->slave_id) {
+          return false;
+        }
+        auto const& registers =
+            probe.type == LibModbus::ReadableRegisterType::HoldingRegister
+            ? device->holding_registers
+            : device->input_registers;
+        return registers.contains(probe.register_index);
+      });
+}
+
+// A probe into `bus` which fails if `other` is the actual bus, if any
+std::optional<PortFinderPlan::Probe> distinguishingProbe(
+    Config::Bus const& bus, Config::Bus const& other) {
+
+  for (auto const& device : bus.devices) {
+    for (auto r : device->holding_registers) {
+      PortFinderPlan::Probe probe{
+          device, LibModbus::ReadableRegisterType::HoldingRegister, r};
+      if (rejects(probe, other)) {
+        return probe;
+      }
+    }
+    for (auto r : device->input_registers) {
+      PortFinderPlan::Probe probe{
+          device, LibModbus::ReadableRegisterType::InputRegister, r};
+      if (rejects(probe, other)) {
+        return probe;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
 } // namespace Internal_
 
 // `GlobalData`
 
 PortFinderPlan::GlobalData::GlobalData()
-    : bus_indexing(std::make_shared<Internal_::GlobalBusIndexing>()),
-      ambiguates(
-          [](Config::Bus::NonemptyPtr const& p1,
-              Config::Bus::NonemptyPtr const& p2) -> bool {
-            return (p1 != p2) && Internal_::operator<=(*p2, *p1);
-          },
-          bus_indexing, bus_indexing) {}
+    : bus_indexing(std::make_shared<Internal_::GlobalBusIndexing>()) {}
+
+Internal_::GlobalBusIndexing::Index PortFinderPlan::GlobalData::addBus(
+    Config::Bus::NonemptyPtr const& bus) {
+
+  auto index = bus_indexing->add(bus);
+  signatures.set(index, Internal_::BusSignature(*bus));
+  return index;
+}
+
+bool PortFinderPlan::GlobalData::ambiguates(
+    Internal_::GlobalBusIndexing::Index ambiguator,
+    Internal_::GlobalBusIndexing::Index bus) const {
+
+  return (ambiguator != bus) &&
+      Internal_::operator<=(signatures[bus], signatures[ambiguator]);
+}
+
+bool PortFinderPlan::GlobalData::ambiguatesByRegisters(
+    Internal_::GlobalBusIndexing::Index ambiguator,
+    Internal_::GlobalBusIndexing::Index bus) const {
+
+  return (ambiguator != bus) &&
+      Internal_::registersWithin(signatures[bus], signatures[ambiguator]);
+}
 
 // `Port`
 
@@ -66,48 +238,112 @@ PortFinderPlan::PortBusIndexing::Index PortFinderPlan::Port::addBus(
     Internal_::GlobalBusIndexing::Index global_index) {
 
   auto const& bus = global_data->bus_indexing->get(global_index);
+  auto const& signature = global_data->signatures[global_index];
+  auto const& slave_ids = signature.devices_by_slave_id;
   auto local_index = bus_indexing.add(bus);
   global_bus_index.set(local_index, global_index);
 
   available.add(local_index);
-
-  auto& ambiguated_by_bus = ambiguated[local_index];
-  auto& num_bus_ambiguators = num_ambiguators[local_index];
-  for (auto other_local_index : bus_indexing) {
-    if (other_local_index != local_index) {
-      auto other_global_index = globalBusIndex(other_local_index);
-      if (global_data->ambiguates(global_index, other_global_index)) {
-        ambiguated_by_bus.push_back(other_local_index);
-        ++num_ambiguators[other_local_index];
+  probes = PortBusMap<std::optional<PortFinderPlan::Probes>>();
+  num_ambiguators.set(local_index, 0);
+  feasibility.set(local_index, std::make_shared<Feasibility>(false));
+
+  /*
+    Buses which ambiguate the new one have all of its slave ids. Hence it
+    suffices to check the buses of its least frequent slave id. If the new bus
+    has no devices, every other bus ambiguates it.
+  */
+  if (slave_ids.empty()) {
+    for (auto other_local_index : bus_indexing) {
+      if (other_local_index != local_index) {
+        checkAmbiguation(other_local_index, local_index);
       }
-      if (global_data->ambiguates(other_global_index, global_index)) {
-        ambiguated[other_local_index].push_back(local_index);
-        if (available.contains(other_local_index)) {
-          ++num_bus_ambiguators;
-        }
+    }
+  } else {
+    std::vector<PortFinderPlan::PortBusIndexing::Index> const* ambiguators =
+        nullptr;
+    for (auto const& group : slave_ids) {
+      auto buses = buses_by_slave_id.find(group.first);
+      if (buses == buses_by_slave_id.end()) {
+        ambiguators = nullptr;
+        break;
+      }
+      if ((ambiguators == nullptr) ||
+          (buses->second.size() < ambiguators->size())) {
+        ambiguators = &buses->second;
+      }
+    }
+    if (ambiguators != nullptr) {
+      for (auto other_local_index : *ambiguators) {
+        checkAmbiguation(other_local_index, local_index);
+      }
+    }
+  }
+
+  /*
+    Buses which the new one ambiguates have only slave ids among its own. In
+    particular, their least slave id is among its own.
+  */
+  for (auto other_local_index : buses_without_devices) {
+    checkAmbiguation(local_index, other_local_index);
+  }
+  for (auto const& group : slave_ids) {
+    auto buses = buses_by_least_slave_id.find(group.first);
+    if (buses != buses_by_least_slave_id.end()) {
+      for (auto other_local_index : buses->second) {
+        checkAmbiguation(local_index, other_local_index);
       }
     }
   }
 
+  // Only now, so that the new bus is not compared to itself
+  for (auto const& group : slave_ids) {
+    buses_by_slave_id[group.first].push_back(local_index);
+  }
+  if (slave_ids.empty()) {
+    buses_without_devices.push_back(local_index);
+  } else {
+    buses_by_least_slave_id[slave_ids.front().first].push_back(local_index);
+  }
+
   return local_index;
 }
 
+bool PortFinderPlan::Port::feasible(PortBusIndexing::Index bus) const {
+  return (!assigned) && available.contains(bus) && (num_ambiguators[bus] == 0);
+}
+
+void PortFinderPlan::Port::publishFeasibility() {
+  for (auto bus : bus_indexing) {
+    feasibility[bus]->store(feasible(bus));
+  }
+  feasibility_outdated = false;
+}
+
+void PortFinderPlan::Port::checkAmbiguation(
+    PortBusIndexing::Index ambiguator, PortBusIndexing::Index bus) {
+
+  if (global_data->ambiguates(globalBusIndex(ambiguator), globalBusIndex(bus))) {
+    ambiguated[ambiguator].push_back(bus);
+    // `num_ambiguators` counts only available ambiguators
+    if (available.contains(ambiguator)) {
+      ++num_ambiguators[bus];
+    }
+  }
+}
+
 // `Candidate`:
 
 Config::Bus::NonemptyPtr const& PortFinderPlan::Candidate::getBus() const {
-  std::lock_guard lock(plan_->mutex_);
-  return plan_->global_data_->bus_indexing->get(
-      plan_->getPort(port_).globalBusIndex(bus_));
+  return bus_config_;
 }
 
 Config::Portname const& PortFinderPlan::Candidate::getPort() const {
-  std::lock_guard lock(plan_->mutex_);
-  return plan_->global_data_->port_indexing.get(port_);
+  return port_name_;
 }
 
 bool PortFinderPlan::Candidate::stillFeasible() const {
-  std::lock_guard lock(plan_->mutex_);
-  return plan_->feasible(bus_, port_);
+  return feasibility_->load();
 }
 
 PortFinderPlan::NewCandidates PortFinderPlan::Candidate::confirm() const {
@@ -115,6 +351,16 @@ PortFinderPlan::NewCandidates PortFinderPlan::Candidate::confirm() const {
   return plan_->assign(bus_, port_);
 }
 
+PortFinderPlan::Probes PortFinderPlan::Candidate::probes() const {
+  std::lock_guard lock(plan_->mutex_);
+  return plan_->probes(bus_, port_);
+}
+
+bool PortFinderPlan::Candidate::uncontested() const {
+  std::lock_guard lock(plan_->mutex_);
+  return plan_->uncontested(bus_, port_);
+}
+
 // `PortFinderPlan`:
 
 PortFinderPlan::PortFinderPlan(SecretConstructorArgument)
@@ -128,10 +374,14 @@ PortFinderPlan::NewCandidates PortFinderPlan::addBuses(
   std::vector<Internal_::GlobalBusIndexing::Index> new_global_indices;
 
   for (auto const& bus : new_buses) {
-    auto global_index = global_data_->bus_indexing->add(bus);
+    auto global_index = global_data_->addBus(bus);
     new_global_indices.push_back(global_index);
     auto& possible_ports = global_data_->possible_ports[global_index];
     for (auto const& port_name : bus->possible_serial_ports) {
+      if (HotplugWatcher::isPattern(std::string((std::string_view)port_name))) {
+        // Matching ports are added through `addPossiblePort`
+        continue;
+      }
       auto port_index = global_data_->port_indexing.index(port_name);
 
       // create/get the port
@@ -142,6 +392,7 @@ PortFinderPlan::NewCandidates PortFinderPlan::addBuses(
       auto& port = port_optional.value();
 
       auto local_index = port.addBus(global_index);
+      markOutdated(port_index);
       possible_ports.push_back(std::make_pair(port_index, local_index));
     }
   }
@@ -154,6 +405,54 @@ PortFinderPlan::NewCandidates PortFinderPlan::addBuses(
     }
   }
 
+  publishFeasibility();
+  return new_candidates;
+}
+
+PortFinderPlan::NewCandidates PortFinderPlan::addPossiblePort(
+    Config::Bus::NonemptyPtr const& bus, Config::Portname const& port_name) {
+
+  std::lock_guard lock(mutex_);
+
+  auto global_index = global_data_->bus_indexing->lookup(bus);
+  auto port_index = global_data_->port_indexing.index(port_name);
+  auto& possible_ports = global_data_->possible_ports[global_index];
+
+  bool bus_assigned = false;
+  for (auto const& incidence : possible_ports) {
+    if (incidence.first == port_index) {
+      // nothing new
+      return {};
+    }
+    auto const& other_port = getPort(incidence.first);
+    if (other_port.assigned.has_value() &&
+        (other_port.assigned.value() == incidence.second)) {
+      bus_assigned = true;
+    }
+  }
+
+  // create/get the port
+  auto& port_optional = ports_[port_index];
+  if (!port_optional.has_value()) {
+    port_optional.emplace(global_data_);
+  }
+  auto& port = port_optional.value();
+
+  auto local_index = port.addBus(global_index);
+  markOutdated(port_index);
+  possible_ports.push_back(std::make_pair(port_index, local_index));
+
+  NewCandidates new_candidates;
+  if (bus_assigned) {
+    // As in `assign`, the bus is neither available nor an ambiguator here
+    port.available.remove(local_index);
+    for (auto ambiguated_index : port.ambiguated[local_index]) {
+      --port.num_ambiguators[ambiguated_index];
+    }
+  } else {
+    addCandidateIfFeasible(new_candidates, local_index, port_index);
+  }
+  publishFeasibility();
   return new_candidates;
 }
 
@@ -172,6 +471,7 @@ PortFinderPlan::NewCandidates PortFinderPlan::unassign(
   auto assigned_bus_global_index = port.globalBusIndex(assigned_bus_index);
 
   port.assigned.reset();
+  markOutdated(port_index);
   NewCandidates new_candidates;
 
   // recall `assigned_bus` on other ports
@@ -183,6 +483,7 @@ PortFinderPlan::NewCandidates PortFinderPlan::unassign(
       auto assigned_bus_other_index = incidence.second;
       auto& other_port = getPort(other_port_index);
       other_port.available.add(assigned_bus_other_index);
+      markOutdated(other_port_index);
       addCandidateIfFeasible(
           new_candidates, assigned_bus_other_index, other_port_index);
     }
@@ -210,6 +511,7 @@ PortFinderPlan::NewCandidates PortFinderPlan::unassign(
     }
   }
 
+  publishFeasibility();
   return new_candidates;
 }
 
@@ -220,9 +522,30 @@ PortFinderPlan::NonemptyPtr PortFinderPlan::make() {
 bool PortFinderPlan::feasible(
     PortBusIndexing::Index bus_index, PortIndexing::Index port_index) const {
 
+  return getPort(port_index).feasible(bus_index);
+}
+
+bool PortFinderPlan::uncontested(
+    PortBusIndexing::Index bus_index, PortIndexing::Index port_index) const {
+
   auto const& port = getPort(port_index);
-  return (!port.assigned) && port.available.contains(bus_index) &&
-      (port.num_ambiguators[bus_index] == 0);
+  auto global_index = port.globalBusIndex(bus_index);
+  if (global_data_->possible_ports[global_index].size() != 1) {
+    return false;
+  }
+  // Patterns may match further ports at any time
+  for (auto const& port_name :
+      global_data_->bus_indexing->get(global_index)->possible_serial_ports) {
+    if (HotplugWatcher::isPattern(std::string((std::string_view)port_name))) {
+      return false;
+    }
+  }
+  for (auto other_bus_index : port.bus_indexing) {
+    if (other_bus_index != bus_index) {
+      return false;
+    }
+  }
+  return true;
 }
 
 PortFinderPlan::Port const& PortFinderPlan::getPort(
@@ -243,8 +566,12 @@ void PortFinderPlan::addCandidateIfFeasible(NewCandidates& new_candidates,
     PortBusIndexing::Index bus_index, PortIndexing::Index port_index) {
 
   if (feasible(bus_index, port_index)) {
+    auto const& port = getPort(port_index);
     new_candidates.emplace_back(SecretConstructorArgument(),
-        PortFinderPlan::NonemptyPtr(shared_from_this()), port_index, bus_index);
+        PortFinderPlan::NonemptyPtr(shared_from_this()), port_index, bus_index,
+        port.bus_indexing.get(bus_index),
+        global_data_->port_indexing.get(port_index),
+        port.feasibility[bus_index]);
   }
 }
 
@@ -261,9 +588,11 @@ PortFinderPlan::NewCandidates PortFinderPlan::assign(
     auto& port = getPort(other_port_index);
     if (other_port_index == actual_port_index) {
       port.assigned = bus_index;
+      markOutdated(other_port_index);
     } else {
       auto bus_other_index = incidence.second;
       port.available.remove(bus_other_index);
+      markOutdated(other_port_index);
 
       // Check if anything became unambiguous
       for (auto ambiguated_index : port.ambiguated[bus_other_index]) {
@@ -274,7 +603,77 @@ PortFinderPlan::NewCandidates PortFinderPlan::assign(
     }
   }
 
+  publishFeasibility();
   return new_candidates;
 }
 
+void PortFinderPlan::markOutdated(PortIndexing::Index port_index) {
+  auto& port = getPort(port_index);
+  if (!port.feasibility_outdated) {
+    port.feasibility_outdated = true;
+    outdated_ports_.push_back(port_index);
+  }
+}
+
+void PortFinderPlan::publishFeasibility() {
+  for (auto port_index : outdated_ports_) {
+    getPort(port_index).publishFeasibility();
+  }
+  outdated_ports_.clear();
+}
+
+PortFinderPlan::Probes const& PortFinderPlan::probes(
+    PortBusIndexing::Index bus_index, PortIndexing::Index port_index) {
+
+  auto& port = getPort(port_index);
+  auto& memoized = port.probes[bus_index];
+  if (memoized.has_value()) {
+    return memoized.value();
+  }
+
+  auto bus_global_index = port.globalBusIndex(bus_index);
+  auto const& bus = global_data_->bus_indexing->get(bus_global_index);
+  Probes result;
+  for (auto const& device : bus->devices) {
+    auto probe = Internal_::livenessProbe(device);
+    if (probe.has_value()) {
+      result.liveness.push_back(std::move(probe.value()));
+    }
+  }
+
+  // Greedily add probes until all other buses are rejected
+  auto rejected = [&result](Config::Bus const& other) -> bool {
+    auto rejects = [&other](Probe const& probe) -> bool {
+      return Internal_::rejects(probe, other);
+    };
+    return std::any_of(
+               result.liveness.begin(), result.liveness.end(), rejects) ||
+        std::any_of(result.distinguishing.begin(), result.distinguishing.end(),
+            rejects);
+  };
+  for (auto other_index : port.bus_indexing) {
+    auto other_global_index = port.globalBusIndex(other_index);
+    if ((other_index == bus_index) ||
+        global_data_->ambiguates(other_global_index, bus_global_index)) {
+      // indistinguishable
+      continue;
+    }
+    auto const& other = *global_data_->bus_indexing->get(other_global_index);
+    if (global_data_->ambiguatesByRegisters(
+            other_global_index, bus_global_index)) {
+      // no register tells `other` apart, only identification does
+      result.identification_required = true;
+      continue;
+    }
+    if (!rejected(other)) {
+      auto probe = Internal_::distinguishingProbe(*bus, other);
+      if (probe.has_value()) {
+        result.distinguishing.push_back(std::move(probe.value()));
+      }
+    }
+  }
+
+  return memoized.emplace(std::move(result));
+}
+
 } // namespace Technology_Adapter::Modbus
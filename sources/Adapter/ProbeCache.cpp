@@ -0,0 +1,84 @@
+#include "internal/ProbeCache.hpp"
+
+#include <stdexcept>
+
+namespace Technology_Adapter::Modbus {
+
+bool ProbeCache::Results::silent(int slave_id) const {
+  return silent_.count(slave_id) > 0;
+}
+
+ProbeCache::Result ProbeCache::Results::lookup(int slave_id,
+    LibModbus::ReadableRegisterType type, RegisterIndex register_index) const {
+
+  auto iterator = readable_.find(Key(slave_id, type, register_index));
+  if (iterator == readable_.end()) {
+    return Result::Unknown;
+  }
+  return iterator->second ? Result::Readable : Result::Unreadable;
+}
+
+ProbeCache::Result ProbeCache::Results::lookup(int slave_id,
+    LibModbus::ReadableRegisterType type, RegisterIndex start_register,
+    int num_registers) const {
+
+  Result result = Result::Readable;
+  for (RegisterIndex r = start_register; r < start_register + num_registers;
+      ++r) {
+    switch (lookup(slave_id, type, r)) {
+    case Result::Readable:
+      break;
+    case Result::Unreadable:
+      return Result::Unreadable;
+    case Result::Unknown:
+      result = Result::Unknown;
+      break;
+    default:
+      throw std::logic_error("Incomplete switch");
+    }
+  }
+  return result;
+}
+
+void ProbeCache::Results::recordSilent(int slave_id) {
+  silent_.insert(slave_id);
+}
+
+void ProbeCache::Results::recordReadable(int slave_id,
+    LibModbus::ReadableRegisterType type, RegisterIndex start_register,
+    int num_registers) {
+
+  for (RegisterIndex r = start_register; r < start_register + num_registers;
+      ++r) {
+    readable_.insert_or_assign(Key(slave_id, type, r), true);
+  }
+}
+
+void ProbeCache::Results::recordUnreadable(int slave_id,
+    LibModbus::ReadableRegisterType type, RegisterIndex register_index) {
+
+  readable_.insert_or_assign(Key(slave_id, type, register_index), false);
+}
+
+std::optional<LibModbus::DeviceIdentification> const*
+ProbeCache::Results::identity(int slave_id) const {
+  auto iterator = identities_.find(slave_id);
+  if (iterator == identities_.end()) {
+    return nullptr;
+  }
+  return &iterator->second;
+}
+
+void ProbeCache::Results::recordIdentity(
+    int slave_id, std::optional<LibModbus::DeviceIdentification> identity) {
+
+  identities_.insert_or_assign(slave_id, std::move(identity));
+}
+
+ProbeCache::Results& ProbeCache::forBus(Config::Bus const& bus) {
+  return results_[Config::serialSettings(bus)];
+}
+
+void ProbeCache::clear() { results_.clear(); }
+
+} // namespace Technology_Adapter::Modbus
@@ -0,0 +1,67 @@
+#include "internal/ProbeSchedule.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+namespace Technology_Adapter::Modbus {
+
+ProbeSchedule::ProbeSchedule(Config::PortDetection const& config)
+    : ProbeSchedule(Duration(config.backoff_initial),
+          Duration(config.backoff_max), config.backoff_jitter,
+          Duration(config.min_attempt_interval)) {}
+
+ProbeSchedule::ProbeSchedule(Duration backoff_initial, Duration backoff_max,
+    double jitter, Duration min_attempt_interval)
+    : backoff_initial_(backoff_initial), backoff_max_(backoff_max),
+      jitter_(jitter), min_attempt_interval_(min_attempt_interval) {}
+
+ProbeSchedule::Duration ProbeSchedule::backoff(size_t failures) const {
+  if (failures == 0) {
+    return Duration(0);
+  }
+  Duration result = backoff_initial_;
+  // Doubling stops at `backoff_max_`, which also prevents overflows
+  for (size_t i = 1; (i < failures) && (result < backoff_max_); ++i) {
+    result *= 2;
+  }
+  return std::min(result, backoff_max_);
+}
+
+ProbeSchedule::Duration ProbeSchedule::minBackoff(size_t failures) const {
+  return Duration((Duration::rep)((double)backoff(failures).count() *
+      (1 - jitter_)));
+}
+
+ProbeSchedule::Duration ProbeSchedule::randomBackoff(size_t failures) const {
+  auto max = backoff(failures);
+  auto min = minBackoff(failures);
+  if (min == max) {
+    return max;
+  }
+  thread_local std::minstd_rand random_engine(std::random_device{}());
+  std::uniform_int_distribution<Duration::rep> distribution(
+      min.count(), max.count());
+  return Duration(distribution(random_engine));
+}
+
+ProbeSchedule::Duration ProbeSchedule::minAttemptInterval() const {
+  return min_attempt_interval_;
+}
+
+double ProbeSchedule::steadyStateAttemptRate(size_t num_candidates) const {
+  constexpr double ms_per_second = 1000;
+  double result = std::numeric_limits<double>::infinity();
+
+  auto min_backoff = (double)backoff_max_.count() * (1 - jitter_);
+  if (min_backoff > 0) {
+    result = (double)num_candidates * ms_per_second / min_backoff;
+  }
+  if (min_attempt_interval_.count() > 0) {
+    result = std::min(
+        result, ms_per_second / (double)min_attempt_interval_.count());
+  }
+  return result;
+}
+
+} // namespace Technology_Adapter::Modbus
@@ -0,0 +1,11 @@
+#include "internal/ReadCache.hpp"
+
+namespace Technology_Adapter::Modbus {
+
+ReadCache::ReadCache(Config::CachePolicy const& policy) : policy_(policy) {}
+
+ReadCache::Counters ReadCache::counters() const {
+  return Counters{hits_, misses_};
+}
+
+} // namespace Technology_Adapter::Modbus
@@ -0,0 +1,187 @@
+#include "internal/WorkerPool.hpp"
+
+#include <algorithm>
+#include <memory>
+
+#include <HaSLL/LoggerManager.hpp>
+
+#include "internal/Logging.hpp"
+
+namespace Technology_Adapter::Modbus {
+
+WorkerPool::WorkerPool(ConstString::ConstString const& name, size_t num_threads)
+    : logger_(HaSLL::LoggerManager::registerLogger(
+          std::string((std::string_view)("Modbus Adapter " + name)))) {
+
+  threads_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads_.emplace_back([this] { work(); });
+  }
+}
+
+WorkerPool::~WorkerPool() noexcept {
+  {
+    std::lock_guard lock(mutex_);
+    terminating_ = true;
+  }
+  wakeup_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkerPool::post(Task task) {
+  {
+    std::lock_guard lock(mutex_);
+    queue_.push_back(std::move(task));
+  }
+  wakeup_.notify_one();
+}
+
+WorkerPool::Ticket WorkerPool::postAfter(
+    std::chrono::milliseconds delay, Task task) {
+
+  Ticket ticket;
+  {
+    std::lock_guard lock(mutex_);
+    ticket = next_ticket_++;
+    delayed_.emplace(
+        Clock::now() + delay, std::make_pair(ticket, std::move(task)));
+  }
+  // The woken thread may have to wait for an earlier deadline than before
+  wakeup_.notify_one();
+  return ticket;
+}
+
+bool WorkerPool::expedite(Ticket ticket) noexcept {
+  {
+    std::lock_guard lock(mutex_);
+    // `delayed_` is short in practice, so we do not index it by ticket
+    auto task = std::find_if(delayed_.begin(), delayed_.end(),
+        [ticket](auto const& entry) { return entry.second.first == ticket; });
+    if (task == delayed_.end()) {
+      return false;
+    }
+    // Moving the entry rather than its task cannot throw
+    auto node = delayed_.extract(task);
+    node.key() = Clock::time_point::min();
+    delayed_.insert(std::move(node));
+  }
+  wakeup_.notify_one();
+  return true;
+}
+
+void WorkerPool::runAll(std::vector<Task> tasks) {
+  if (tasks.empty()) {
+    return;
+  }
+
+  /*
+    The tasks are not queued individually. Instead, we queue "drainers" which
+    take tasks from `batch` until it is empty. The calling thread is one of
+    the drainers, which guarantees progress even if all worker threads are
+    busy (e.g., because one of them is the calling thread).
+  */
+  struct Batch {
+    std::mutex mutex; // protects everything below
+    std::condition_variable finished;
+    std::vector<Task> tasks;
+    size_t next = 0;
+    size_t num_unfinished;
+
+    // NOLINTNEXTLINE(readability-identifier-naming)
+    explicit Batch(std::vector<Task>&& tasks_)
+        : tasks(std::move(tasks_)), num_unfinished(tasks.size()) {}
+  };
+  auto batch = std::make_shared<Batch>(std::move(tasks));
+
+  auto drain = [this, batch]() {
+    while (true) {
+      Task const* task;
+      {
+        std::lock_guard lock(batch->mutex);
+        if (batch->next == batch->tasks.size()) {
+          return;
+        }
+        task = &batch->tasks[batch->next];
+        ++batch->next;
+      }
+      run(*task);
+      bool batch_finished;
+      {
+        std::lock_guard lock(batch->mutex);
+        --batch->num_unfinished;
+        batch_finished = batch->num_unfinished == 0;
+      }
+      if (batch_finished) {
+        batch->finished.notify_all();
+      }
+    }
+  };
+
+  size_t num_helpers = std::min(threads_.size(), batch->tasks.size() - 1);
+  for (size_t i = 0; i < num_helpers; ++i) {
+    post(drain);
+  }
+  drain();
+
+  std::unique_lock lock(batch->mutex);
+  batch->finished.wait(lock, [&batch]() { return batch->num_unfinished == 0; });
+}
+
+size_t WorkerPool::size() const { return threads_.size(); }
+
+size_t WorkerPool::defaultSize(size_t upper_bound) {
+  // `hardware_concurrency` may return 0 if it does not know better
+  size_t hardware = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  return std::max<size_t>(std::min(hardware, upper_bound), 1);
+}
+
+void WorkerPool::work() noexcept {
+  while (true) {
+    Task task;
+    {
+      std::unique_lock lock(mutex_);
+      while (true) {
+        // move due tasks from `delayed_` to `queue_`
+        auto now = Clock::now();
+        auto due_end = terminating_ ? delayed_.end() : delayed_.upper_bound(now);
+        for (auto due = delayed_.begin(); due != due_end; ++due) {
+          queue_.push_back(std::move(due->second.second));
+        }
+        delayed_.erase(delayed_.begin(), due_end);
+
+        if (!queue_.empty()) {
+          break;
+        }
+        if (terminating_) {
+          return;
+        }
+        if (delayed_.empty()) {
+          wakeup_.wait(lock);
+        } else {
+          wakeup_.wait_until(lock, delayed_.begin()->first);
+        }
+      }
+      task = std::move(queue_.front());
+      queue_.pop_front();
+      if (!queue_.empty()) {
+        // We may have moved more than one task from `delayed_`
+        wakeup_.notify_one();
+      }
+    }
+    run(task);
+  }
+}
+
+void WorkerPool::run(Task const& task) noexcept {
+  try {
+    task();
+  } catch (std::exception const& exception) {
+    Logging::error(logger_, "Task failed: {}", exception.what());
+  } catch (...) {
+    Logging::error(logger_, "Task failed with a non-standard exception");
+  }
+}
+
+} // namespace Technology_Adapter::Modbus
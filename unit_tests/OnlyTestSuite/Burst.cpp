@@ -2,6 +2,9 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <thread>
+
 namespace ModbusTechnologyAdapterTests::BurstTests {
 
 using TaskSpec = std::vector<Technology_Adapter::Modbus::RegisterIndex>;
@@ -247,6 +250,40 @@ TEST_F(BurstPlanTests, missingRegister) {
       100));
 }
 
+// Nested buffers and buffers of other threads are distinct
+TEST(BurstBufferTests, ownBuffers) {
+  using namespace Technology_Adapter::Modbus;
+  RegisterSet const registers({{0, 100}});
+  auto small = BurstPlan::allOf(
+      RegisterSet({{0, 2}}), LibModbus::ReadableRegisterType::InputRegister, 8);
+  auto large = BurstPlan::allOf(
+      registers, LibModbus::ReadableRegisterType::InputRegister, 8);
+
+  uint16_t* first = nullptr;
+  {
+    BurstBuffer outer(small.num_plan_registers);
+    first = outer.padded();
+    {
+      BurstBuffer inner(large.num_plan_registers);
+      EXPECT_NE(inner.padded(), outer.padded());
+      std::fill_n(inner.padded(), large.num_plan_registers, 7);
+      outer.padded()[0] = 1;
+      EXPECT_EQ(inner.padded()[0], 7);
+    }
+
+    uint16_t* other = nullptr;
+    std::thread([&]() {
+      BurstBuffer buffer(small.num_plan_registers);
+      other = buffer.padded();
+    }).join();
+    EXPECT_NE(other, outer.padded());
+  }
+
+  // Released buffers are reused
+  BurstBuffer again(small.num_plan_registers);
+  EXPECT_EQ(again.padded(), first);
+}
+
 // NOLINTEND(readability-magic-numbers)
 // NOLINTEND(cert-err58-cpp)
 
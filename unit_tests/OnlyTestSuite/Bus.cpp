@@ -1,5 +1,11 @@
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
 #include <Information_Model/mocks/DeviceMockBuilder.hpp>
 #include <Technology_Adapter_Interface/TechnologyAdapterInterface.hpp>
 #include <Technology_Adapter_Interface/mocks/ModelRepositoryInterface_MOCK.hpp>
@@ -10,6 +16,125 @@
 #include "VirtualAdapter.hpp"
 #include "VirtualContext.hpp"
 
+/*
+  Counts allocations of the current thread while `counting_allocations` is set.
+  All forms of the global allocation functions are replaced, so that neither
+  arrays nor over-aligned or `nothrow` allocations escape counting. This
+  affects the whole test binary, but does not change anything unless a test
+  sets `counting_allocations`.
+*/
+namespace {
+thread_local bool counting_allocations = false;
+thread_local size_t num_allocations = 0;
+
+// NOLINTBEGIN(cppcoreguidelines-no-malloc, hicpp-no-malloc)
+void* allocate(std::size_t size, std::size_t alignment) noexcept {
+  if (counting_allocations) {
+    ++num_allocations;
+  }
+  if (size == 0) {
+    size = 1;
+  }
+  if (alignment <= alignof(std::max_align_t)) {
+    return std::malloc(size);
+  }
+  // `aligned_alloc` wants a multiple of `alignment`
+  return std::aligned_alloc(
+      alignment, (size + alignment - 1) / alignment * alignment);
+}
+// NOLINTEND(cppcoreguidelines-no-malloc, hicpp-no-malloc)
+
+void* allocateOrThrow(std::size_t size, std::size_t alignment) {
+  void* result = allocate(size, alignment);
+  if (result == nullptr) {
+    throw std::bad_alloc();
+  }
+  return result;
+}
+} // namespace
+
+// NOLINTBEGIN(cppcoreguidelines-no-malloc, hicpp-no-malloc)
+void* operator new(std::size_t size) {
+  return allocateOrThrow(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size) {
+  return allocateOrThrow(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return allocateOrThrow(size, (std::size_t)alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return allocateOrThrow(size, (std::size_t)alignment);
+}
+
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept {
+  return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept {
+  return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment,
+    std::nothrow_t const&) noexcept {
+  return allocate(size, (std::size_t)alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment,
+    std::nothrow_t const&) noexcept {
+  return allocate(size, (std::size_t)alignment);
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::nothrow_t const&) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::nothrow_t const&) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(
+    void* pointer, std::align_val_t, std::nothrow_t const&) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](
+    void* pointer, std::align_val_t, std::nothrow_t const&) noexcept {
+  std::free(pointer);
+}
+// NOLINTEND(cppcoreguidelines-no-malloc, hicpp-no-malloc)
+
 namespace ModbusTechnologyAdapterTests::BusTests {
 
 using namespace Technology_Adapter::Modbus;
@@ -87,6 +212,7 @@ struct BusTests : public testing::Test {
   size_t registration_called = 0;
   size_t deregistration_called = 0;
   Information_Model::MetricPtr metric1;
+  std::string metric1_id;
   Information_Model::MetricPtr metric2;
 
   Technology_Adapter::testing::ModelRepositoryMock::RegistrationHandler
@@ -107,6 +233,7 @@ struct BusTests : public testing::Test {
 
     auto readable1 = elements.at(readable_index);
     EXPECT_EQ(readable1->getElementName(), "N1");
+    metric1_id = readable1->getElementId();
     metric1 =
         std::get<Information_Model::NonemptyMetricPtr>(readable1->functionality)
             .base();
@@ -161,8 +288,8 @@ struct BusTests : public testing::Test {
   }
 
   void initBus() {
-    auto bus = Bus::NonemptyPtr::make(
-        adapter, bus_config, context_control.factory(), port_name, registry);
+    auto bus = Bus::NonemptyPtr::make(adapter, bus_config,
+        context_control.factory(), port_name, registry, nullptr);
     bus->start(builder);
   }
 
@@ -175,8 +302,8 @@ struct BusTests : public testing::Test {
 };
 
 TEST_F(BusTests, buildModel) {
-  auto bus = Bus::NonemptyPtr::make(
-      adapter, bus_config, context_control.factory(), port_name, registry);
+  auto bus = Bus::NonemptyPtr::make(adapter, bus_config,
+      context_control.factory(), port_name, registry, nullptr);
 
   EXPECT_EQ(registration_called, 0);
 
@@ -205,6 +332,77 @@ TEST_F(BusTests, getMetricValue) {
   EXPECT_EQ(adapter.cancel_bus_called, 0);
 }
 
+TEST_F(BusTests, reusesHandedOverConnection) {
+  context_control.setDevice(port_name, device_name,
+      LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
+
+  auto connection = context_control.factory()(
+      port_name, *bus_config, ModbusContext::Purpose::PortAutoDetection);
+  connection->connect();
+  EXPECT_EQ(context_control.num_connects, 1);
+
+  auto bus = Bus::NonemptyPtr::make(adapter, bus_config,
+      context_control.factory(), port_name, registry, connection);
+  bus->start(builder);
+  EXPECT_NO_THROW(bus->verify());
+
+  // The port has not been opened again, and the context is reconfigured
+  EXPECT_EQ(context_control.num_connects, 1);
+  EXPECT_EQ(std::dynamic_pointer_cast<VirtualContext>(connection)->purpose(),
+      ModbusContext::Purpose::NormalOperation);
+}
+
+TEST_F(BusTests, verify) {
+  context_control.setDevice(port_name, device_name,
+      LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
+
+  auto bus = Bus::NonemptyPtr::make(adapter, bus_config,
+      context_control.factory(), port_name, registry, nullptr);
+  bus->start(builder);
+  EXPECT_NO_THROW(bus->verify());
+
+  EXPECT_EQ(deregistration_called, 0);
+  EXPECT_EQ(adapter.cancel_bus_called, 0);
+}
+
+TEST_F(BusTests, verifyFailsOnMissingDevice) {
+  auto bus = Bus::NonemptyPtr::make(adapter, bus_config,
+      context_control.factory(), port_name, registry, nullptr);
+  bus->start(builder);
+
+  EXPECT_THROW(bus->verify(), std::runtime_error);
+
+  EXPECT_EQ(registration_called, 1);
+  EXPECT_EQ(deregistration_called, 1);
+  EXPECT_EQ(adapter.cancel_bus_called, 1);
+}
+
+TEST_F(BusTests, verifyOnFirstRead) {
+  context_control.setDevice(port_name, device_name,
+      LibModbus::ReadableRegisterType::HoldingRegister, 1, Quality::PERFECT);
+
+  auto bus = Bus::NonemptyPtr::make(adapter, bus_config,
+      context_control.factory(), port_name, registry, nullptr);
+  bus->start(builder);
+  bus->verifyOnFirstRead();
+  EXPECT_EQ(std::get<double>(metric1->getMetricValue()), 3);
+
+  EXPECT_EQ(deregistration_called, 0);
+  EXPECT_EQ(adapter.cancel_bus_called, 0);
+}
+
+TEST_F(BusTests, firstReadFailsIfVerificationFails) {
+  auto bus = Bus::NonemptyPtr::make(adapter, bus_config,
+      context_control.factory(), port_name, registry, nullptr);
+  bus->start(builder);
+  bus->verifyOnFirstRead();
+
+  EXPECT_THROW(metric1->getMetricValue(), std::runtime_error);
+
+  EXPECT_EQ(deregistration_called, 1);
+  EXPECT_EQ(adapter.cancel_bus_called, 1);
+}
+
 TEST_F(BusTests, shutDownOnMissingPort) {
   context_control.serial_port_exists = false;
 
@@ -274,6 +472,142 @@ TEST_F(BusTests, shutDownOnNoisyDevice) {
   EXPECT_EQ(adapter.cancel_bus_called, 1);
 }
 
+TEST_F(BusTests, readsWithoutAllocating) {
+  auto bus = Bus::NonemptyPtr::make(adapter, bus_config,
+      context_control.factory(), port_name, registry, nullptr);
+  bus->start(builder);
+  context_control.setDevice(port_name, device_name,
+      LibModbus::ReadableRegisterType::HoldingRegister, 1, Quality::PERFECT);
+
+  /*
+    We call the callbacks directly, because the metric mocks allocate on their
+    own. The second readable gathers its registers from separate bursts.
+  */
+  auto read1 = bus->readCallback(0);
+  auto read2 = bus->readCallback(1);
+
+  // The bus has not deferred verification, so the first reads do not verify.
+  // They are a warm-up, after which reading must not allocate.
+  EXPECT_EQ(std::get<double>(read1()), 3);
+  EXPECT_EQ(std::get<double>(read2()), 3 * 65537 + 4);
+
+  double sum = 0;
+  num_allocations = 0;
+  counting_allocations = true;
+  for (int i = 0; i < 1000; ++i) {
+    sum += std::get<double>(read1());
+    sum += std::get<double>(read2());
+  }
+  counting_allocations = false;
+
+  EXPECT_EQ(num_allocations, 0);
+  EXPECT_EQ(sum, 1000 * (3 + 3 * 65537 + 4));
+  EXPECT_EQ(deregistration_called, 0);
+  EXPECT_EQ(adapter.cancel_bus_called, 0);
+}
+
+// Concurrent reads of the same metric each get the right value
+TEST_F(BusTests, concurrentReads) {
+  auto bus = Bus::NonemptyPtr::make(adapter, bus_config,
+      context_control.factory(), port_name, registry, nullptr);
+  bus->start(builder);
+  context_control.setDevice(port_name, device_name,
+      LibModbus::ReadableRegisterType::HoldingRegister, 1, Quality::PERFECT);
+
+  auto read = bus->readCallback(1); // N3
+
+  std::atomic<size_t> num_wrong = 0;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 200; ++i) {
+        if (std::get<double>(read()) != 3 * 65537 + 4) {
+          ++num_wrong;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(num_wrong, 0);
+  EXPECT_EQ(deregistration_called, 0);
+}
+
+TEST_F(BusTests, changeCount) {
+  auto bus = Bus::NonemptyPtr::make(adapter, bus_config,
+      context_control.factory(), port_name, registry, nullptr);
+  bus->start(builder);
+  auto metric_id = metric1_id;
+  EXPECT_EQ(bus->changeCount(metric_id), 0);
+  EXPECT_EQ(bus->changeCount("unknown"), 0);
+
+  context_control.setDevice(port_name, device_name,
+      LibModbus::ReadableRegisterType::HoldingRegister, 1, Quality::PERFECT);
+  EXPECT_EQ(std::get<double>(metric1->getMetricValue()), 3);
+  EXPECT_EQ(std::get<double>(metric1->getMetricValue()), 3);
+  EXPECT_EQ(bus->changeCount(metric_id), 1);
+
+  context_control.setDevice(port_name, device_name,
+      LibModbus::ReadableRegisterType::HoldingRegister, 2, Quality::PERFECT);
+  EXPECT_EQ(std::get<double>(metric1->getMetricValue()), 5);
+  EXPECT_EQ(bus->changeCount(metric_id), 2);
+}
+
+TEST_F(BusTests, cachePolicies) {
+  using Pointer = Config::json::json_pointer;
+  Config::json cached_json = bus_config_json;
+  cached_json[Pointer("/devices/0/elements/0/cache")] = "constant";
+  cached_json[Pointer("/devices/0/elements/1/elements/0/cache")] = {
+      {"ttl_ms", 100000}};
+  auto cached_config = Config::BusOfJson(cached_json);
+  context_control.setDevice(port_name, device_name,
+      LibModbus::ReadableRegisterType::HoldingRegister, 1, Quality::PERFECT);
+
+  auto bus = Bus::NonemptyPtr::make(adapter, cached_config,
+      context_control.factory(), port_name, registry, nullptr);
+  bus->start(builder);
+  auto num_reads = context_control.num_reads.load();
+
+  // The constant has been read during `start` and never is again
+  context_control.setDevice(port_name, device_name,
+      LibModbus::ReadableRegisterType::HoldingRegister, 2, Quality::PERFECT);
+  EXPECT_EQ(std::get<double>(metric1->getMetricValue()), 3);
+  EXPECT_EQ(std::get<double>(metric1->getMetricValue()), 3);
+  EXPECT_EQ(context_control.num_reads, num_reads);
+  EXPECT_EQ(bus->cacheCounters(metric1_id).misses, 1);
+  EXPECT_EQ(bus->cacheCounters(metric1_id).hits, 2);
+
+  // The TTL value is read once, then served from memory
+  EXPECT_EQ(std::get<double>(metric2->getMetricValue()), 6 * 65537 + 4);
+  num_reads = context_control.num_reads.load();
+  EXPECT_EQ(std::get<double>(metric2->getMetricValue()), 6 * 65537 + 4);
+  EXPECT_EQ(context_control.num_reads, num_reads);
+}
+
+TEST_F(BusTests, verifiesBeforeReadingConstants) {
+  Config::json json = bus_config_json;
+  json["devices"][0]["elements"][0]["cache"] = "constant";
+  // A second device, which is missing. Hence verification fails
+  Config::json missing_device = json["devices"][0];
+  missing_device["slave_id"] = 11;
+  missing_device["id"] = "Missing";
+  missing_device["elements"] = nlohmann::json::array();
+  json["devices"].push_back(missing_device);
+  auto config = Config::BusOfJson(json);
+  context_control.setDevice(port_name, device_name,
+      LibModbus::ReadableRegisterType::HoldingRegister, 1, Quality::PERFECT);
+
+  auto bus = Bus::NonemptyPtr::make(adapter, config, context_control.factory(),
+      port_name, registry, nullptr);
+  EXPECT_THROW(bus->start(builder, Verification::Lazy), std::runtime_error);
+
+  // The constant has not been taken from a bus that turned out to be wrong
+  EXPECT_EQ(registration_called, 0);
+  EXPECT_EQ(adapter.cancel_bus_called, 1);
+}
+
 // NOLINTEND(cert-err58-cpp, readability-magic-numbers))
 
 } // namespace ModbusTechnologyAdapterTests::BusTests
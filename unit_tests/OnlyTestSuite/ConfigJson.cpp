@@ -98,6 +98,83 @@ TEST_F(ConfigJsonTests, floatDecoder) {
       });
 }
 
+TEST_F(ConfigJsonTests, orderedLinearDecoder) {
+  checkDecoder(
+      {
+          {"type", "linear"},
+          {"signed", true},
+          {"word_order", "big_endian"},
+      },
+      {
+          {{1}, 1},
+          {{0, 1}, 1},
+          {{1, 0}, 65536},
+          {{65535, 65535}, -1},
+          {{65535, 0}, -65536},
+          {{1, 0, 0}, 4294967296},
+      });
+  checkDecoder(
+      {
+          {"type", "linear"},
+          {"byte_order", "little_endian"},
+      },
+      {
+          {{0x0100}, 1},
+          {{0x0001}, 256},
+          {{0x0200, 0x0100}, 65538},
+      });
+  checkDecoder(
+      {
+          {"type", "linear"},
+          {"byte_order", "little_endian"},
+          {"word_order", "big_endian"},
+      },
+      {
+          {{0x0100, 0x0200}, 65538},
+      });
+}
+
+TEST_F(ConfigJsonTests, orderedFloatDecoder) {
+  checkDecoder(
+      {
+          {"type", "float"},
+          {"byte_order", "big_endian"},
+          {"word_order", "big_endian"},
+      },
+      {
+          {{0x4228, 0}, 42},
+          {{0x4996, 0xb438}, 1234567},
+          {{0x4045, 0, 0, 0}, 42},
+          {{0xc206, 0xfee0, 0xe1f6, 0x0400}, -12345678910.751953125},
+      });
+  checkDecoder(
+      {
+          {"type", "float"},
+          {"byte_order", "little_endian"},
+      },
+      {
+          {{0, 0x2842}, 42},
+          {{0x38b4, 0x9649}, 1234567},
+      });
+  checkDecoder(
+      {
+          {"type", "float"},
+          {"byte_order", "little_endian"},
+          {"word_order", "big_endian"},
+      },
+      {
+          {{0x2842, 0}, 42},
+          {{0x4540, 0, 0, 0}, 42},
+      });
+}
+
+TEST_F(ConfigJsonTests, unknownOrder) {
+  EXPECT_THROW(DecoderOfJson({{"type", "float"}, {"byte_order", "middle"}}),
+      std::runtime_error);
+  EXPECT_THROW(DecoderOfJson({{"type", "linear"}, {"word_order", "pdp"}}),
+      std::runtime_error);
+}
+
 TEST_F(ConfigJsonTests, unsignedMantissaExponentDecoder) {
   checkDecoder(
       {
@@ -137,6 +214,224 @@ TEST_F(ConfigJsonTests, signedMantissaExponentDecoder) {
       });
 }
 
+TEST_F(ConfigJsonTests, portDetection) {
+  EXPECT_EQ(PortDetectionOfJson(json::object()).max_concurrent_probes, 4);
+  EXPECT_EQ(PortDetectionOfJson({{"max_concurrent_probes", 16}})
+                .max_concurrent_probes,
+      16);
+  EXPECT_THROW(PortDetectionOfJson({{"max_concurrent_probes", 0}}),
+      std::runtime_error);
+  EXPECT_EQ(PortDetectionOfJson(json::object()).state_file, "");
+  EXPECT_EQ(
+      PortDetectionOfJson({{"state_file", "/var/lib/modbus/ports.json"}})
+          .state_file,
+      "/var/lib/modbus/ports.json");
+  EXPECT_FALSE(PortDetectionOfJson(json::object()).direct_connect);
+  EXPECT_TRUE(PortDetectionOfJson({{"direct_connect", true}}).direct_connect);
+  EXPECT_TRUE(PortDetectionOfJson(json::object()).watch_hotplug);
+  EXPECT_FALSE(PortDetectionOfJson({{"watch_hotplug", false}}).watch_hotplug);
+
+  auto backoff = PortDetectionOfJson({{"backoff_initial", 50},
+      {"backoff_max", 500}, {"backoff_jitter", 0.5},
+      {"min_attempt_interval", 20}});
+  EXPECT_EQ(backoff.backoff_initial, 50);
+  EXPECT_EQ(backoff.backoff_max, 500);
+  EXPECT_EQ(backoff.backoff_jitter, 0.5);
+  EXPECT_EQ(backoff.min_attempt_interval, 20);
+  EXPECT_EQ(PortDetectionOfJson(json::object()).min_attempt_interval, 0);
+  EXPECT_THROW(PortDetectionOfJson({{"backoff_initial", 500}, //
+                   {"backoff_max", 50}}),
+      std::runtime_error);
+  EXPECT_THROW(
+      PortDetectionOfJson({{"backoff_jitter", 1.5}}), std::runtime_error);
+}
+
+TEST_F(ConfigJsonTests, adapterAsArray) {
+  auto adapter = AdapterOfJson(json::array());
+  EXPECT_TRUE(adapter.buses.empty());
+  EXPECT_EQ(adapter.port_detection.max_concurrent_probes, 4);
+}
+
+TEST_F(ConfigJsonTests, adapterAsObject) {
+  auto adapter = AdapterOfJson({
+      {"buses", json::array()},
+      {"port_detection", {{"max_concurrent_probes", 2}}},
+  });
+  EXPECT_TRUE(adapter.buses.empty());
+  EXPECT_EQ(adapter.port_detection.max_concurrent_probes, 2);
+}
+
+TEST_F(ConfigJsonTests, busTimeouts) {
+  json bus_json = {
+      {"possible_serial_ports", {"/dev/ttyUSB0"}},
+      {"baud", 9600},
+      {"parity", "None"},
+      {"data_bits", 8},
+      {"stop_bits", 1},
+      {"devices", json::array()},
+  };
+  auto bus = BusOfJson(bus_json);
+  EXPECT_EQ(bus->response_timeout_when_searching, 0);
+  EXPECT_EQ(bus->max_response_timeout_when_searching, 0);
+  EXPECT_EQ(bus->byte_timeout_when_searching, 0);
+
+  bus_json["response_timeout_when_searching"] = 50000;
+  bus_json["max_response_timeout_when_searching"] = 400000;
+  bus_json["byte_timeout_when_searching"] = 5000;
+  bus = BusOfJson(bus_json);
+  EXPECT_EQ(bus->response_timeout_when_searching, 50000);
+  EXPECT_EQ(bus->max_response_timeout_when_searching, 400000);
+  EXPECT_EQ(bus->byte_timeout_when_searching, 5000);
+}
+
+TEST_F(ConfigJsonTests, derivedReadable) {
+  json readable_json = {
+      {"element_type", "readable"},
+      {"description", ""},
+      {"registers", {0}},
+      {"decoder", {{"type", "linear"}}},
+  };
+  json value_json = readable_json;
+  value_json["name"] = "Value";
+  json decimals_json = readable_json;
+  decimals_json["name"] = "Decimals";
+  decimals_json["registers"] = {1};
+  json scaled_json = {
+      {"element_type", "readable"},
+      {"name", "Scaled"},
+      {"description", ""},
+      {"expression", "Value / 10^Decimals"},
+  };
+
+  json device_json = {
+      {"id", "ADC"},
+      {"name", ""},
+      {"description", ""},
+      {"slave_id", 1},
+      {"burst_size", 2},
+      {"holding_registers", json::array()},
+      {"input_registers", {{{"begin", 0}, {"end", 1}}}},
+      {"elements",
+          {
+              scaled_json,
+              {
+                  {"element_type", "group"},
+                  {"name", "Raw"},
+                  {"description", ""},
+                  {"elements", {value_json, decimals_json}},
+              },
+          }},
+  };
+
+  // The derived readable refers to readables of another group
+  auto device = DeviceOfJson(device_json);
+  auto const& scaled = device->readables.at(0);
+  EXPECT_EQ(scaled.type, Information_Model::DataType::Double);
+  EXPECT_EQ(scaled.registers, (std::vector<int>{0, 1}));
+  EXPECT_EQ(std::get<double>(scaled.decode({1234, 2})), 12.34);
+
+  // Names must be unique to be referred to
+  json ambiguous_json = device_json;
+  ambiguous_json["elements"].push_back(value_json);
+  EXPECT_THROW(DeviceOfJson(ambiguous_json), std::runtime_error);
+
+  // Derived readables have no registers or decoder of their own
+  scaled_json["registers"] = {0};
+  EXPECT_THROW(ReadableOfJson(scaled_json), std::runtime_error);
+}
+
+TEST_F(ConfigJsonTests, cachePolicy) {
+  using Kind = CachePolicy::Kind;
+  EXPECT_EQ(CachePolicyOfJson("none").kind, Kind::None);
+  EXPECT_EQ(CachePolicyOfJson("constant").kind, Kind::Constant);
+  auto ttl = CachePolicyOfJson({{"ttl_ms", 250}});
+  EXPECT_EQ(ttl.kind, Kind::Ttl);
+  EXPECT_EQ(ttl.ttl_ms, 250);
+  EXPECT_THROW(CachePolicyOfJson("forever"), std::runtime_error);
+  EXPECT_ANY_THROW(CachePolicyOfJson({{"ttl", 250}}));
+
+  json readable_json = {
+      {"element_type", "readable"},
+      {"name", "Serial number"},
+      {"description", ""},
+      {"registers", {0}},
+      {"decoder", {{"type", "linear"}}},
+  };
+  EXPECT_EQ(ReadableOfJson(readable_json).cache.kind, Kind::None);
+  readable_json["cache"] = "constant";
+  EXPECT_EQ(ReadableOfJson(readable_json).cache.kind, Kind::Constant);
+}
+
+// Parts of one configuration share equal strings
+TEST_F(ConfigJsonTests, sharedStrings) {
+  json readable_json = {
+      {"element_type", "readable"},
+      {"name", "Value"},
+      {"description", "Shared"},
+      {"registers", {0}},
+      {"decoder", {{"type", "mantissa/exponent"}, {"base", 10}}},
+  };
+  json group_json = {
+      {"element_type", "group"},
+      {"name", "Group"},
+      {"description", "Shared"},
+      {"elements", {readable_json}},
+  };
+  json device_json = {
+      {"id", "ADC"},
+      {"name", "Shared"},
+      {"description", "Shared"},
+      {"slave_id", 1},
+      {"burst_size", 2},
+      {"holding_registers", {{{"begin", 0}, {"end", 1}}}},
+      {"input_registers", json::array()},
+      {"elements", {readable_json, group_json, readable_json}},
+  };
+  json bus_json = {
+      {"possible_serial_ports", {"/dev/ttyUSB0"}},
+      {"baud", 9600},
+      {"parity", "None"},
+      {"data_bits", 8},
+      {"stop_bits", 1},
+      {"devices", {device_json, device_json}},
+  };
+
+  auto bus = BusOfJson(bus_json);
+  auto const& first = *bus->devices.at(0);
+  auto const& second = *bus->devices.at(1);
+  char const* shared = first.description.c_str();
+  EXPECT_EQ(first.name.c_str(), shared);
+  EXPECT_EQ(second.description.c_str(), shared);
+  EXPECT_EQ(first.readables.at(1).description.c_str(), shared);
+  EXPECT_EQ(second.subgroups.at(0).readables.at(0).description.c_str(), shared);
+  EXPECT_EQ(
+      first.readables.at(0).name.c_str(), second.readables.at(1).name.c_str());
+
+  // Child vectors have no spare room
+  EXPECT_EQ(first.readables.capacity(), 2);
+  EXPECT_EQ(first.subgroups.capacity(), 1);
+
+  EXPECT_EQ(std::get<double>(first.readables.at(0).decode({2, 3})), 300);
+  EXPECT_EQ(std::get<double>(second.readables.at(1).decode({2, 3})), 300);
+}
+
+TEST_F(ConfigJsonTests, identification) {
+  auto identification = IdentificationOfJson({{"vendor", "ACME"},
+      {"product", "Meter 3000"}});
+  EXPECT_EQ(identification.vendor, "ACME");
+  EXPECT_EQ(identification.product, "Meter 3000");
+  EXPECT_EQ(identification.revision, "");
+  EXPECT_THROW(IdentificationOfJson(json::object()), std::runtime_error);
+
+  // Read Device Identification must match exactly, except for empty strings
+  EXPECT_TRUE(identification.matches({"ACME", "Meter 3000", "v1.2", ""}));
+  EXPECT_FALSE(identification.matches({"ACME", "Meter 3001", "v1.2", ""}));
+
+  // Report Server ID must contain the expected strings
+  EXPECT_TRUE(identification.matches({"", "", "", "ACME Meter 3000 v1.2"}));
+  EXPECT_FALSE(identification.matches({"", "", "", "ACME Meter 2000"}));
+}
+
 // NOLINTEND(readability-magic-numbers)
 
 } // namespace ModbusTechnologyAdapterTests::ConfigJsonTests
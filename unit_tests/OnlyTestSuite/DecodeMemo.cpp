@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+
+#include <thread>
+
+#include "internal/DecodeMemo.hpp"
+
+namespace ModbusTechnologyAdapterTests::DecodeMemoTests {
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+using namespace Technology_Adapter::Modbus;
+
+TEST(DecodeMemoTests, decodesOnlyChanges) {
+  auto decoder = Config::Decoder::linear(false, 1, 0);
+  DecodeMemo memo(2);
+  EXPECT_EQ(memo.changeCount(), 0);
+  EXPECT_FALSE(memo.changed());
+
+  // The memo reads registers 3 and 1 of the buffer
+  std::vector<uint16_t> buffer{0, 1, 0, 2};
+  std::vector<size_t> indices{3, 1};
+  auto decode = [&]() {
+    return std::get<double>(
+        memo.decode(decoder, buffer.data(), indices.data()));
+  };
+  EXPECT_EQ(decode(), 65538);
+  EXPECT_TRUE(memo.changed());
+  EXPECT_EQ(memo.changeCount(), 1);
+
+  // Other registers do not matter
+  buffer[0] = 7;
+  buffer[2] = 7;
+  EXPECT_EQ(decode(), 65538);
+  EXPECT_FALSE(memo.changed());
+  EXPECT_EQ(memo.changeCount(), 1);
+
+  buffer[1] = 2;
+  EXPECT_EQ(decode(), 131074);
+  EXPECT_TRUE(memo.changed());
+  EXPECT_EQ(memo.changeCount(), 2);
+}
+
+// A decoder that throws does not leave a stale value behind
+TEST(DecodeMemoTests, retriesAfterThrow) {
+  auto decoder = Config::Decoder::ieee754();
+  DecodeMemo memo(3);
+  std::vector<uint16_t> buffer{0, 0, 0};
+  std::vector<size_t> indices{0, 1, 2};
+  EXPECT_THROW(memo.decode(decoder, buffer.data(), indices.data()),
+      std::runtime_error);
+  EXPECT_THROW(memo.decode(decoder, buffer.data(), indices.data()),
+      std::runtime_error);
+  EXPECT_EQ(memo.changeCount(), 0);
+}
+
+// Concurrent decodes of the same memo agree and count each change once
+TEST(DecodeMemoTests, concurrentDecodes) {
+  auto decoder = Config::Decoder::linear(false, 1, 0);
+  DecodeMemo memo(1);
+  std::vector<size_t> indices{0};
+  constexpr size_t num_threads = 4;
+  constexpr uint16_t num_values = 1000;
+
+  std::vector<std::thread> threads;
+  std::atomic<size_t> num_wrong = 0;
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&]() {
+      for (uint16_t value = 0; value < num_values; ++value) {
+        std::vector<uint16_t> buffer{(uint16_t)(value / 10)};
+        if (std::get<double>(memo.decode(
+                decoder, buffer.data(), indices.data())) != value / 10) {
+          ++num_wrong;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(num_wrong, 0);
+  EXPECT_GE(memo.changeCount(), num_values / 10);
+}
+
+// NOLINTEND(readability-magic-numbers)
+
+} // namespace ModbusTechnologyAdapterTests::DecodeMemoTests
@@ -0,0 +1,185 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <vector>
+
+#include "internal/Decoder.hpp"
+#include "internal/Expression.hpp"
+
+#include "LegacyDecoders.hpp"
+
+namespace ModbusTechnologyAdapterTests::DecoderTests {
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+using namespace Technology_Adapter::Modbus::Config;
+
+TEST(DecoderTests, kinds) {
+  EXPECT_EQ(Decoder::linear(false, 1, 0).kind(), Decoder::Kind::Linear);
+  EXPECT_EQ(Decoder::ieee754().kind(), Decoder::Kind::Float);
+  EXPECT_EQ(Decoder::mantissaExponent(false, 10).kind(),
+      Decoder::Kind::MantissaExponent);
+}
+
+// Decoding reads exactly the given registers from a larger buffer
+TEST(DecoderTests, decodesFromBuffer) {
+  std::vector<uint16_t> buffer{7, 0, 0x4228, 7};
+  EXPECT_EQ(Decoder::ieee754().decodeDouble(&buffer[1], 2), 42);
+  EXPECT_EQ(Decoder::linear(false, 1, 0).decodeDouble(&buffer[1], 1), 0);
+  EXPECT_EQ(Decoder::linear(false, 1, 0).decodeDouble(&buffer[3], 1), 7);
+  EXPECT_THROW(
+      Decoder::ieee754().decodeDouble(buffer.data(), 3), std::runtime_error);
+  EXPECT_THROW(Decoder::mantissaExponent(false, 10).decodeDouble(nullptr, 0),
+      std::runtime_error);
+}
+
+// The indexed overloads read the `i`th register at `indices[i]`
+TEST(DecoderTests, decodesGathered) {
+  std::vector<uint16_t> buffer{0x4228, 7, 0, 1};
+  std::vector<size_t> indices{2, 0};
+  EXPECT_EQ(Decoder::ieee754().decodeDouble(
+                buffer.data(), indices.data(), indices.size()),
+      42);
+  std::vector<size_t> linear_indices{3, 1};
+  EXPECT_EQ(Decoder::linear(false, 1, 0).decodeDouble(
+                buffer.data(), linear_indices.data(), linear_indices.size()),
+      7 * 65536 + 1);
+}
+
+// Powers are the same, whether tabulated or not
+TEST(DecoderTests, powers) {
+  auto decoder = Decoder::mantissaExponent(false, 1.5);
+  for (int exponent : {-1000, -65, -64, -1, 0, 1, 64, 65, 1000}) {
+    std::vector<uint16_t> registers{(uint16_t)(int16_t)exponent, 3};
+    EXPECT_EQ(decoder.decodeDouble(registers.data(), registers.size()),
+        3 * std::pow(1.5, exponent))
+        << exponent;
+  }
+}
+
+// A batch yields the same values as decoding each lane on its own
+TEST(DecoderTests, decodesBatch) {
+  using ByteOrder = Decoder::ByteOrder;
+  using WordOrder = Decoder::WordOrder;
+  auto no_readables = [](std::string const& name) -> Readable const& {
+    throw std::runtime_error("Unknown readable " + name);
+  };
+  std::vector<Decoder> decoders{
+      Decoder::linear(false, 0.5, 3),
+      Decoder::linear(true, 2, -1),
+      // rounds differently if only one side fuses multiplication and addition
+      Decoder::linear(true, 0.1, -0.3, ByteOrder::LittleEndian),
+      Decoder::linear(false, 0.7, -0.1),
+      Decoder::linear(
+          true, 1, 0, ByteOrder::LittleEndian, WordOrder::BigEndian),
+      Decoder::linear(
+          false, 3, 0.25, ByteOrder::BigEndian, WordOrder::BigEndian),
+      Decoder::ieee754(),
+      Decoder::ieee754(ByteOrder::LittleEndian, WordOrder::LittleEndian),
+      Decoder::ieee754(ByteOrder::BigEndian, WordOrder::BigEndian),
+      Decoder::ieee754(ByteOrder::LittleEndian, WordOrder::BigEndian),
+      Decoder::mantissaExponent(false, 10),
+      Decoder::mantissaExponent(true, 0.5),
+      // no SIMD kernel, hence decoded lane by lane
+      Decoder::expression(std::make_shared<Expression const>(
+          Expression::compile("#0 / 2 + #1", no_readables))),
+  };
+
+  constexpr size_t num_lanes = 23; // not a multiple of any vector width
+  for (size_t num_registers = 0; num_registers <= 5; ++num_registers) {
+    std::vector<uint16_t> block(num_registers * num_lanes);
+    for (size_t i = 0; i < block.size(); ++i) {
+      block[i] = (uint16_t)(i * 7919 + (i % 3 == 0 ? 65000 : 0));
+    }
+    // keep some exponents moderate
+    for (size_t lane = 0; (lane < num_lanes) && (num_registers > 0); ++lane) {
+      if (lane % 5 == 0) {
+        block[lane] = (uint16_t)(int16_t)((int)lane - 10);
+      }
+    }
+
+    for (size_t d = 0; d < decoders.size(); ++d) {
+      auto const& decoder = decoders[d];
+      std::vector<double> values(num_lanes);
+      auto decode_batch = [&]() {
+        decoder.decodeBatch(
+            {block.data(), num_lanes, num_registers}, values.data());
+      };
+
+      std::vector<uint16_t> lane_registers(num_registers);
+      bool suits = true;
+      std::vector<double> expected(num_lanes);
+      for (size_t lane = 0; lane < num_lanes; ++lane) {
+        for (size_t i = 0; i < num_registers; ++i) {
+          lane_registers[i] = block[i * num_lanes + lane];
+        }
+        try {
+          expected[lane] =
+              decoder.decodeDouble(lane_registers.data(), num_registers);
+        } catch (std::runtime_error const&) {
+          suits = false;
+        }
+      }
+
+      if (suits) {
+        decode_batch();
+        for (size_t lane = 0; lane < num_lanes; ++lane) {
+          if (std::isnan(expected[lane])) {
+            EXPECT_TRUE(std::isnan(values[lane]));
+          } else {
+            EXPECT_EQ(values[lane], expected[lane])
+                << "decoder " << d << ", " << num_registers
+                << " registers, lane " << lane;
+          }
+        }
+      } else {
+        EXPECT_THROW(decode_batch(), std::runtime_error) << "decoder " << d;
+      }
+    }
+  }
+}
+
+// Decoders agree with the functions they replaced
+TEST(DecoderTests, matchesLegacyDecoders) {
+  using Legacy = double (*)(LegacyDecoders::Registers const&);
+
+  constexpr size_t num_values = 1024;
+  auto check = [](char const* name, Legacy legacy, Decoder const& decoder,
+                   std::vector<LegacyDecoders::Registers> const& inputs) {
+    std::vector<double> values;
+    std::vector<double> expected;
+    for (auto const& registers : inputs) {
+      values.push_back(
+          decoder.decodeDouble(registers.data(), registers.size()));
+      expected.push_back(legacy(registers));
+    }
+    EXPECT_EQ(values, expected) << name;
+  };
+
+  std::vector<LegacyDecoders::Registers> inputs;
+  for (size_t i = 0; i < num_values; ++i) {
+    inputs.push_back({(uint16_t)(int16_t)((int)(i % 13) - 6),
+        (uint16_t)(i * 7919), (uint16_t)i});
+  }
+  check("linear", LegacyDecoders::linear, Decoder::linear(false, 0.1, 3),
+      inputs);
+  check("mantissa/exponent", LegacyDecoders::mantissaExponent,
+      Decoder::mantissaExponent(false, 10), inputs);
+
+  for (size_t i = 0; i < num_values; ++i) {
+    inputs[i] = {(uint16_t)(i * 7919), 0x4228};
+  }
+  check("float", LegacyDecoders::ieee754, Decoder::ieee754(), inputs);
+
+  for (size_t i = 0; i < num_values; ++i) {
+    inputs[i] = {0x2842, (uint16_t)(i * 7919)};
+  }
+  check("swapped float", LegacyDecoders::swappedIeee754,
+      Decoder::ieee754(
+          Decoder::ByteOrder::LittleEndian, Decoder::WordOrder::BigEndian),
+      inputs);
+}
+
+// NOLINTEND(readability-magic-numbers)
+
+} // namespace ModbusTechnologyAdapterTests::DecoderTests
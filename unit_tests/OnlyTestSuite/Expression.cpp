@@ -0,0 +1,136 @@
+#include "gtest/gtest.h"
+
+#include <map>
+
+#include "internal/Expression.hpp"
+
+namespace ModbusTechnologyAdapterTests::ExpressionTests {
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+using namespace Technology_Adapter::Modbus::Config;
+
+struct ExpressionTests : public testing::Test {
+  std::map<std::string, Readable> readables;
+
+  ExpressionTests() {
+    readables.emplace("Value",
+        Readable{"Value", "", Information_Model::DataType::Double, {4},
+            Decoder::linear(true, 1, 0)});
+    readables.emplace("Decimals",
+        Readable{"Decimals", "", Information_Model::DataType::Double, {5},
+            Decoder::linear(false, 1, 0)});
+    readables.emplace("Supply voltage",
+        Readable{"Supply voltage", "", Information_Model::DataType::Double,
+            {6, 7}, Decoder::ieee754()});
+  }
+
+  Expression compile(std::string const& source) {
+    return Expression::compile(
+        source, [this](std::string const& name) -> Readable const& {
+          auto readable = readables.find(name);
+          if (readable == readables.end()) {
+            throw std::runtime_error("Unknown readable " + name);
+          }
+          return readable->second;
+        });
+  }
+
+  /*
+    Evaluates `source` with register `i` having value `register_values[i]`,
+    for all registers the expression depends on
+  */
+  double evaluate(std::string const& source,
+      std::map<int, uint16_t> const& register_values) {
+
+    auto expression = compile(source);
+    std::vector<uint16_t> values;
+    for (int register_index : expression.registers()) {
+      values.push_back(register_values.at(register_index));
+    }
+    return expression.evaluate(values.data());
+  }
+};
+
+TEST_F(ExpressionTests, arithmetic) {
+  EXPECT_EQ(evaluate("1 + 2 * 3", {}), 7);
+  EXPECT_EQ(evaluate("(1 + 2) * 3", {}), 9);
+  EXPECT_EQ(evaluate("10 - 4 - 3", {}), 3);
+  EXPECT_EQ(evaluate("12 / 3 / 2", {}), 2);
+  EXPECT_EQ(evaluate("2 ^ 3 ^ 2", {}), 512);
+  EXPECT_EQ(evaluate("-2 ^ 2", {}), -4);
+  EXPECT_EQ(evaluate("2 ^ -1", {}), 0.5);
+  EXPECT_EQ(evaluate("--1.5e1", {}), 15);
+  EXPECT_EQ(evaluate("1. + .25 + 5E-1", {}), 1.75);
+}
+
+TEST_F(ExpressionTests, registersAndReadables) {
+  // `Value` is signed, `#4` is not
+  EXPECT_EQ(evaluate("Value", {{4, 65535}}), -1);
+  EXPECT_EQ(evaluate("#4", {{4, 65535}}), 65535);
+  EXPECT_EQ(evaluate("Value / 10^Decimals", {{4, 1234}, {5, 2}}), 12.34);
+  EXPECT_EQ(evaluate("'Supply voltage' * 2", {{6, 0}, {7, 0x4228}}), 84);
+
+  // Shared registers are read once
+  auto expression = compile("Value + #4 + #5 + Decimals");
+  EXPECT_EQ(expression.registers(), (std::vector<int>{4, 5}));
+}
+
+TEST_F(ExpressionTests, bit) {
+  EXPECT_EQ(evaluate("bit(#3, 0)", {{3, 0b1010}}), 0);
+  EXPECT_EQ(evaluate("bit(#3, 1)", {{3, 0b1010}}), 1);
+  EXPECT_EQ(evaluate("bit(#3, 3) + bit(#3, 15)", {{3, 0b1010}}), 1);
+  EXPECT_THROW(evaluate("bit(#3, 64)", {{3, 0}}), std::runtime_error);
+  EXPECT_THROW(evaluate("bit(#3, -1)", {{3, 0}}), std::runtime_error);
+  EXPECT_THROW(evaluate("bit(#3, 0 / 0)", {{3, 0}}), std::runtime_error);
+
+  // The operand must fit into an `int64_t`
+  EXPECT_EQ(evaluate("bit(-1, 63)", {}), 1);
+  EXPECT_EQ(evaluate("bit(2^62, 62)", {}), 1);
+  EXPECT_THROW(evaluate("bit(2^63, 0)", {}), std::runtime_error);
+  EXPECT_THROW(evaluate("bit(1e30, 0)", {}), std::runtime_error);
+  EXPECT_THROW(evaluate("bit(0 / 0, 0)", {}), std::runtime_error);
+  EXPECT_THROW(evaluate("bit(1 / 0, 0)", {}), std::runtime_error);
+}
+
+TEST_F(ExpressionTests, malformed) {
+  for (auto source : {"", "1 +", "(1", "1)", "#", "bit(1)", "'Value", "1 $",
+           "Unknown"}) {
+    EXPECT_THROW(compile(source), std::runtime_error) << source;
+  }
+
+  std::string deep = "1";
+  for (int i = 0; i < 40; ++i) {
+    deep = "1 + (" + deep + ")";
+  }
+  EXPECT_THROW(compile(deep), std::runtime_error);
+
+  // Nesting that keeps the stack small is still bounded
+  EXPECT_NO_THROW(compile(std::string(100, '(') + "1" + std::string(100, ')')));
+  EXPECT_THROW(compile(std::string(100000, '(') + "1" +
+                   std::string(100000, ')')),
+      std::runtime_error);
+  EXPECT_THROW(compile(std::string(100000, '-') + "1"), std::runtime_error);
+  EXPECT_THROW(compile(std::string(100000, '(')), std::runtime_error);
+
+  // Numbers are decimal, whatever the locale
+  for (auto source :
+      {"0x10", "0x1p4", "inf", "nan", "1e", "1e+", ".", "1e999"}) {
+    EXPECT_THROW(compile(source), std::runtime_error) << source;
+  }
+
+  // Register numbers are 16 bits
+  EXPECT_EQ(compile("#65535").registers(), std::vector<int>{65535});
+  EXPECT_THROW(compile("#65536"), std::runtime_error);
+  EXPECT_THROW(compile("#99999999999999999999"), std::runtime_error);
+
+  std::string wide = "#0";
+  for (size_t i = 1; i <= Expression::MAX_REGISTERS; ++i) {
+    wide += " + #" + std::to_string(i);
+  }
+  EXPECT_THROW(compile(wide), std::runtime_error);
+}
+
+// NOLINTEND(readability-magic-numbers)
+
+} // namespace ModbusTechnologyAdapterTests::ExpressionTests
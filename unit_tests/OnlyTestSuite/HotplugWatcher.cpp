@@ -0,0 +1,141 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "internal/HotplugWatcher.hpp"
+
+namespace ModbusTechnologyAdapterTests::HotplugWatcherTests {
+
+using namespace Technology_Adapter::Modbus;
+
+// NOLINTBEGIN(cert-err58-cpp, readability-magic-numbers)
+
+auto long_time = std::chrono::milliseconds(100);
+
+struct HotplugWatcherTests : public testing::Test {
+  std::string directory;
+
+  using Changes = std::vector<std::pair<std::string, bool>>;
+  std::mutex changes_mutex;
+  Changes changes;
+
+  HotplugWatcher::Callback callback = [this](
+                                          std::string const& path,
+                                          bool present) {
+    std::lock_guard lock(changes_mutex);
+    changes.emplace_back(path, present);
+  };
+
+  void SetUp() final {
+    char name[] = "/tmp/hotplug_test_XXXXXX";
+    ASSERT_NE(mkdtemp(name), nullptr);
+    directory = name;
+  }
+
+  void TearDown() final {
+    for (auto const& path : HotplugWatcher::expand(directory + "/*")) {
+      std::remove(path.c_str());
+    }
+    rmdir(directory.c_str());
+  }
+
+  void createNode(std::string const& name) {
+    std::ofstream output_stream(directory + "/" + name);
+  }
+
+  // Whether `changes` contains the given change
+  bool changed(std::string const& name, bool present) {
+    std::lock_guard lock(changes_mutex);
+    for (auto const& change : changes) {
+      if ((change.first == directory + "/" + name) &&
+          (change.second == present)) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+TEST_F(HotplugWatcherTests, patterns) {
+  EXPECT_TRUE(HotplugWatcher::isPattern("/dev/ttyUSB*"));
+  EXPECT_TRUE(HotplugWatcher::isPattern("/dev/ttyS[0-3]"));
+  EXPECT_FALSE(HotplugWatcher::isPattern("/dev/ttyUSB0"));
+
+  EXPECT_TRUE(HotplugWatcher::matches("/dev/ttyUSB*", "/dev/ttyUSB0"));
+  EXPECT_FALSE(HotplugWatcher::matches("/dev/ttyUSB*", "/dev/ttyACM0"));
+  EXPECT_FALSE(HotplugWatcher::matches("/dev/*", "/dev/serial/by-id/x"));
+}
+
+TEST_F(HotplugWatcherTests, expand) {
+  createNode("ttyUSB1");
+  createNode("ttyUSB0");
+  createNode("ttyACM0");
+
+  EXPECT_EQ(HotplugWatcher::expand(directory + "/ttyUSB*"),
+      (std::vector<std::string>{
+          directory + "/ttyUSB0", directory + "/ttyUSB1"}));
+  EXPECT_TRUE(HotplugWatcher::expand(directory + "/ttyS*").empty());
+}
+
+TEST_F(HotplugWatcherTests, reportsNodes) {
+  HotplugWatcher watcher(callback, true);
+  if (!watcher.watchDirectoryOf(directory + "/ttyUSB0")) {
+    GTEST_SKIP() << "inotify is unavailable";
+  }
+
+  createNode("ttyUSB0");
+  std::this_thread::sleep_for(long_time);
+  EXPECT_TRUE(changed("ttyUSB0", true));
+
+  std::remove((directory + "/ttyUSB0").c_str());
+  std::this_thread::sleep_for(long_time);
+  EXPECT_TRUE(changed("ttyUSB0", false));
+}
+
+TEST_F(HotplugWatcherTests, rescansAfterOverflow) {
+  size_t max_queued_events = 0;
+  std::ifstream("/proc/sys/fs/inotify/max_queued_events") >> max_queued_events;
+  if ((max_queued_events == 0) || (max_queued_events > 100000)) {
+    GTEST_SKIP() << "the inotify queue cannot be overflowed cheaply";
+  }
+
+  HotplugWatcher watcher(callback, true);
+  if (!watcher.watchDirectoryOf(directory + "/ttyUSB0")) {
+    GTEST_SKIP() << "inotify is unavailable";
+  }
+
+  {
+    // Blocks the watcher in its first callback while the queue fills up
+    std::unique_lock lock(changes_mutex);
+    createNode("first");
+    std::this_thread::sleep_for(long_time);
+    for (size_t i = 0; i <= max_queued_events; ++i) {
+      createNode(std::to_string(i));
+    }
+  }
+  std::this_thread::sleep_for(long_time);
+
+  // The last event did not fit into the queue
+  EXPECT_TRUE(changed(std::to_string(max_queued_events), true));
+}
+
+TEST_F(HotplugWatcherTests, disabled) {
+  HotplugWatcher watcher(callback, false);
+  EXPECT_FALSE(watcher.watchDirectoryOf(directory + "/ttyUSB0"));
+}
+
+TEST_F(HotplugWatcherTests, relativePathsAreNotWatched) {
+  HotplugWatcher watcher(callback, true);
+  EXPECT_FALSE(watcher.watchDirectoryOf("The port"));
+}
+
+// NOLINTEND(cert-err58-cpp, readability-magic-numbers)
+
+} // namespace ModbusTechnologyAdapterTests::HotplugWatcherTests
@@ -0,0 +1,77 @@
+#ifndef _MODBUS_TECHNOLOGY_ADAPTER_UNIT_TESTS_LEGACY_DECODERS_HPP
+#define _MODBUS_TECHNOLOGY_ADAPTER_UNIT_TESTS_LEGACY_DECODERS_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/*
+  Decoders as they were before `Config::Decoder`: functions over vectors which
+  compute powers on every call. References for tests and benchmarks of the
+  latter.
+*/
+namespace ModbusTechnologyAdapterTests::LegacyDecoders {
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+using Registers = std::vector<uint16_t>;
+
+// As `Decoder::linear(false, 0.1, 3)`
+inline double linear(Registers const& registers) {
+  uint64_t value = 0;
+  unsigned shift = 0;
+  for (auto register_value : registers) {
+    value |= ((uint64_t)register_value) << shift;
+    shift += 16;
+  }
+  return ((double)value) * 0.1 + 3;
+}
+
+// As `Decoder::mantissaExponent(false, 10)`
+inline double mantissaExponent(Registers const& registers) {
+  auto exponent = (int)(int16_t)registers.at(0);
+  Registers mantissa(registers.begin() + 1, registers.end());
+  uint64_t value = 0;
+  unsigned shift = 0;
+  for (auto register_value : mantissa) {
+    value |= ((uint64_t)register_value) << shift;
+    shift += 16;
+  }
+  return ((double)value) * std::pow(10.0, exponent);
+}
+
+// As `Decoder::ieee754()`
+inline double ieee754(Registers const& registers) {
+  std::vector<uint8_t> bytes;
+  bytes.reserve(2 * registers.size());
+  for (auto register_value : registers) {
+    bytes.push_back(register_value);
+    bytes.push_back(register_value >> 8);
+  }
+  uint32_t bits = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    bits |= ((uint32_t)bytes.at(i)) << (8 * i);
+  }
+  float value = 0;
+  std::memcpy(&value, &bits, sizeof(value));
+  return (double)value;
+}
+
+/*
+  As `Decoder::ieee754(ByteOrder::LittleEndian, WordOrder::BigEndian)`.
+  Before, a consumer reordered registers itself and then decoded.
+*/
+inline double swappedIeee754(Registers const& registers) {
+  Registers reordered(registers.rbegin(), registers.rend());
+  for (auto& value : reordered) {
+    value = (uint16_t)((value << 8) | (value >> 8));
+  }
+  return ieee754(reordered);
+}
+
+// NOLINTEND(readability-magic-numbers)
+
+} // namespace ModbusTechnologyAdapterTests::LegacyDecoders
+
+#endif // _MODBUS_TECHNOLOGY_ADAPTER_UNIT_TESTS_LEGACY_DECODERS_HPP
@@ -0,0 +1,163 @@
+#include "gtest/gtest.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "internal/LibmodbusAbstraction.hpp"
+
+namespace ModbusTechnologyAdapterTests::LibmodbusAbstractionTests {
+
+using namespace LibModbus;
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+using Bytes = std::vector<uint8_t>;
+
+constexpr uint8_t slave_id = 5;
+
+// Appends the Modbus RTU CRC
+Bytes withCrc(Bytes frame) {
+  uint16_t crc = 0xFFFF;
+  for (uint8_t byte : frame) {
+    crc ^= byte;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 1U) != 0 ? (uint16_t)((crc >> 1) ^ 0xA001U) : crc >> 1;
+    }
+  }
+  frame.push_back(crc & 0xFFU);
+  frame.push_back(crc >> 8);
+  return frame;
+}
+
+/*
+  A pseudo terminal pair. The context talks to the slave end, and the test
+  plays the device on the master end.
+*/
+struct LibmodbusAbstractionTests : public testing::Test {
+  int master = -1;
+  std::unique_ptr<ContextRTU> context;
+
+  Bytes requests; // as received by the device, in order
+  std::thread device;
+
+  void SetUp() final {
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_GE(master, 0);
+    ASSERT_EQ(grantpt(master), 0);
+    ASSERT_EQ(unlockpt(master), 0);
+
+    // NOLINTNEXTLINE(concurrency-mt-unsafe)
+    context = std::make_unique<ContextRTU>(ptsname(master), 9600,
+        Parity::None, 8, 1, 0);
+    context->selectDevice(slave_id);
+    context->setResponseTimeout(std::chrono::seconds(1));
+    context->connect();
+  }
+
+  void TearDown() final {
+    if (device.joinable()) {
+      device.join();
+    }
+    context.reset();
+    close(master);
+  }
+
+  /*
+    Lets the device receive a request of `request_length` bytes, including
+    CRC, for each of `responses` and answer with it
+  */
+  void serve(std::vector<std::pair<size_t, Bytes>> responses) {
+    device = std::thread([this, responses]() {
+      for (auto const& [request_length, response] : responses) {
+        uint8_t byte = 0;
+        for (size_t i = 0; i < request_length; ++i) {
+          if (read(master, &byte, 1) != 1) {
+            return;
+          }
+          requests.push_back(byte);
+        }
+        if (write(master, response.data(), response.size()) !=
+            (ssize_t)response.size()) {
+          return;
+        }
+      }
+    });
+  }
+};
+
+TEST_F(LibmodbusAbstractionTests, readsDeviceIdentification) {
+  // The objects come in two responses
+  serve({
+      {7, withCrc({slave_id, 0x2B, 0x0E, 0x01, 0x01, 0xFF, 0x02, 0x02, //
+              0x00, 4, 'A', 'c', 'm', 'e', //
+              0x01, 3, 'X', '4', '2'})},
+      {7, withCrc({slave_id, 0x2B, 0x0E, 0x01, 0x01, 0x00, 0x00, 0x01, //
+              0x02, 3, '1', '.', '0'})},
+  });
+
+  auto identification = context->readDeviceIdentification();
+  EXPECT_EQ(identification.vendor, "Acme");
+  EXPECT_EQ(identification.product, "X42");
+  EXPECT_EQ(identification.revision, "1.0");
+
+  device.join();
+  Bytes first_request = withCrc({slave_id, 0x2B, 0x0E, 0x01, 0x00});
+  Bytes second_request = withCrc({slave_id, 0x2B, 0x0E, 0x01, 0x02});
+  Bytes expected_requests = first_request;
+  expected_requests.insert(expected_requests.end(), second_request.begin(),
+      second_request.end());
+  EXPECT_EQ(requests, expected_requests);
+}
+
+TEST_F(LibmodbusAbstractionTests, reportsUnsupportedIdentification) {
+  serve({
+      {7, withCrc({slave_id, 0xAB, 0x01})}, // illegal function
+      {4, withCrc({slave_id, 0x11, 5, 0x2A, 0xFF, 'a', 'b', 'c'})},
+  });
+
+  try {
+    context->readDeviceIdentification();
+    ADD_FAILURE() << "identification did not fail";
+  } catch (ModbusError const& error) {
+    EXPECT_TRUE(error.unsupportedRequest());
+  }
+
+  EXPECT_EQ(context->reportServerId().server_id, "abc");
+}
+
+TEST_F(LibmodbusAbstractionTests, rejectsBadCrc) {
+  auto response = withCrc({slave_id, 0x11, 2, 0x2A, 0xFF});
+  response.back() ^= 1U;
+  serve({{4, response}});
+
+  try {
+    context->reportServerId();
+    ADD_FAILURE() << "a corrupted response was accepted";
+  } catch (ModbusError const& error) {
+    EXPECT_EQ(error.errno_, ModbusError::BADCRC);
+  }
+}
+
+TEST_F(LibmodbusAbstractionTests, timesOut) {
+  context->setResponseTimeout(std::chrono::milliseconds(10));
+
+  try {
+    context->reportServerId();
+    ADD_FAILURE() << "no response was received";
+  } catch (ModbusError const& error) {
+    EXPECT_EQ(error.errno_, ETIMEDOUT);
+  }
+}
+
+// NOLINTEND(readability-magic-numbers)
+
+} // namespace ModbusTechnologyAdapterTests::LibmodbusAbstractionTests
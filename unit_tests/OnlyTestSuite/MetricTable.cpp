@@ -0,0 +1,131 @@
+#include "../../sources/Adapter/MetricTable.hpp"
+
+#include "gtest/gtest.h"
+
+#include "internal/ConfigJson.hpp"
+
+namespace ModbusTechnologyAdapterTests::MetricTableTests {
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+using namespace Technology_Adapter::Modbus;
+
+// clang-format off
+Config::json bus_config_json{
+  {"possible_serial_ports", {"The port"}},
+  {"devices", {
+    {
+      {"slave_id", 10},
+      {"id", "First"},
+      {"name", ""},
+      {"description", ""},
+      {"holding_registers", {{{"begin", 2}, {"end", 5}}}},
+      {"input_registers", nlohmann::json::array()},
+      {"burst_size", 2},
+      {"elements", {
+        {
+          {"element_type", "group"},
+          {"name", "G"},
+          {"description", ""},
+          {"elements", {
+            {
+              {"element_type", "readable"},
+              {"name", "C"},
+              {"description", ""},
+              {"registers", {5, 2}},
+              {"decoder", {{"type", "linear"}}},
+            },
+          }},
+        },
+        {
+          {"element_type", "readable"},
+          {"name", "A"},
+          {"description", ""},
+          {"registers", {3}},
+          {"decoder", {{"type", "linear"}}},
+          {"cache", {{"ttl_ms", 10}}},
+        },
+      }},
+    },
+    {
+      {"slave_id", 11},
+      {"id", "Second"},
+      {"name", ""},
+      {"description", ""},
+      {"holding_registers", nlohmann::json::array()},
+      {"input_registers", {{{"begin", 0}, {"end", 0}}}},
+      {"burst_size", 2},
+      {"elements", {
+        {
+          {"element_type", "readable"},
+          {"name", "D"},
+          {"description", ""},
+          {"registers", {0}},
+          {"decoder", {{"type", "linear"}}},
+        },
+      }},
+    },
+  }},
+  {"baud", 1},
+  {"parity", "None"},
+  {"stop_bits", 2},
+  {"data_bits", 3},
+  {"rts_delay", 4},
+  {"inter_use_delay_when_searching", 5},
+  {"inter_use_delay_when_running", 6},
+  {"inter_device_delay_when_searching", 7},
+  {"inter_device_delay_when_running", 8},
+};
+// clang-format on
+
+// Rows are in the order of `Bus::buildModel`: readables before subgroups
+TEST(MetricTableTests, rows) {
+  auto bus = Config::BusOfJson(bus_config_json);
+  MetricTable table(*bus);
+  ASSERT_EQ(table.size(), 3);
+
+  EXPECT_EQ(table.readable(0).name, "A");
+  EXPECT_EQ(table.readable(1).name, "C");
+  EXPECT_EQ(table.readable(2).name, "D");
+  EXPECT_EQ(table.device(0).id, "First");
+  EXPECT_EQ(table.device(1).id, "First");
+  EXPECT_EQ(table.device(2).id, "Second");
+
+  EXPECT_NE(table.cache(0), nullptr);
+  EXPECT_EQ(table.cache(1), nullptr);
+
+  // "C" reads registers 2 and 5 separately and finds them in reverse order
+  ASSERT_EQ(table.burstsEnd(1) - table.burstsBegin(1), 2);
+  EXPECT_EQ(table.burstsBegin(1)[0].start_register, 2);
+  EXPECT_EQ(table.burstsBegin(1)[1].start_register, 5);
+  EXPECT_EQ(table.numPlanRegisters(1), 2);
+  EXPECT_EQ(table.taskToPlan(1)[0], 1);
+  EXPECT_EQ(table.taskToPlan(1)[1], 0);
+
+  EXPECT_EQ(table.burstsEnd(2) - table.burstsBegin(2), 1);
+  EXPECT_EQ(table.burstsBegin(2)->type,
+      LibModbus::ReadableRegisterType::InputRegister);
+  EXPECT_EQ(table.taskToPlan(2)[0], 0);
+}
+
+TEST(MetricTableTests, identify) {
+  auto bus = Config::BusOfJson(bus_config_json);
+  MetricTable table(*bus);
+  EXPECT_EQ(table.find("First:A"), std::nullopt);
+
+  table.identify(0, "First:A");
+  table.identify(2, "Second:D");
+  EXPECT_EQ(table.id(0), "First:A");
+  EXPECT_EQ(table.find("First:A"), 0);
+  EXPECT_EQ(table.find("Second:D"), 2);
+
+  // A restarted bus may get other ids
+  table.identify(0, "First:A, a rather long id which is not stored inline");
+  EXPECT_EQ(table.find("First:A"), std::nullopt);
+  EXPECT_EQ(
+      table.find("First:A, a rather long id which is not stored inline"), 0);
+}
+
+// NOLINTEND(readability-magic-numbers)
+
+} // namespace ModbusTechnologyAdapterTests::MetricTableTests
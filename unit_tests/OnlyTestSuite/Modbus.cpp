@@ -0,0 +1,47 @@
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "internal/Modbus.hpp"
+
+namespace ModbusTechnologyAdapterTests::ModbusTests {
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+using namespace Technology_Adapter::Modbus;
+using us = std::chrono::microseconds;
+
+TEST(ModbusTests, escalatedTimeout) {
+  EXPECT_EQ(ModbusRTUContext::escalatedTimeout(us(50), us(400), 0), us(50));
+  EXPECT_EQ(ModbusRTUContext::escalatedTimeout(us(50), us(400), 1), us(100));
+  EXPECT_EQ(ModbusRTUContext::escalatedTimeout(us(50), us(400), 3), us(400));
+  EXPECT_EQ(
+      ModbusRTUContext::escalatedTimeout(us(50), us(400), 1000), us(400));
+
+  // A max below the initial timeout disables escalation
+  EXPECT_EQ(ModbusRTUContext::escalatedTimeout(us(50), us(0), 3), us(50));
+}
+
+TEST(ModbusTests, cancellationInterruptsWaiting) {
+  LibModbus::Cancellation cancellation;
+  EXPECT_FALSE(cancellation.cancelled());
+  EXPECT_FALSE(cancellation.waitFor(us(1000)));
+
+  std::thread canceller([&cancellation]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    cancellation.cancel();
+  });
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(cancellation.waitFor(std::chrono::seconds(10)));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+  canceller.join();
+
+  // Cancellation lasts until reset
+  EXPECT_TRUE(cancellation.cancelled());
+  cancellation.reset();
+  EXPECT_FALSE(cancellation.cancelled());
+}
+
+// NOLINTEND(readability-magic-numbers)
+
+} // namespace ModbusTechnologyAdapterTests::ModbusTests
@@ -1,5 +1,7 @@
 #include "gtest/gtest.h"
 
+#include <atomic>
+
 #include "Information_Model/mocks/DeviceMockBuilder.hpp"
 #include "Technology_Adapter_Interface/mocks/ModelRepositoryInterface_MOCK.hpp"
 
@@ -130,6 +132,9 @@ struct Adapter : public ModbusTechnologyAdapterImplementation {
   size_t add_bus_called = 0;
   size_t cancel_bus_called = 0;
 
+  // Whether connections opened during detection reach the `Bus`
+  bool hand_over_connections = true;
+
   void start() final {
     ++start_called;
     start_callback();
@@ -143,11 +148,13 @@ struct Adapter : public ModbusTechnologyAdapterImplementation {
   }
 
   void addBus(Config::Bus::NonemptyPtr const& bus,
-      Config::Portname const& actual_port) final {
+      Config::Portname const& actual_port, Verification verification,
+      ModbusContext::Ptr const& connection) final {
 
     ++add_bus_called;
     add_bus_callback(bus, actual_port);
-    ModbusTechnologyAdapterImplementation::addBus(bus, actual_port);
+    ModbusTechnologyAdapterImplementation::addBus(bus, actual_port,
+        verification, hand_over_connections ? connection : nullptr);
   }
 
   void cancelBus(Config::Portname const& port) final {
@@ -766,6 +773,95 @@ TEST_F(
   EXPECT_EQ(deregistration_called, 1);
 }
 
+TEST_F(ModbusTechnologyAdapterImplementationTests, startFailsAfterAddBus) {
+  context_control.setDevice(port_name, device_id,
+      LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
+
+  // The port vanishes after detection, but before the bus connects. The bus
+  // has to connect itself, as a handed-over connection would still be open.
+  adapter.hand_over_connections = false;
+  adapter.add_bus_callback = //
+      [this](Config::Bus::NonemptyPtr const&, Config::Portname const&) {
+        if (adapter.add_bus_called == 1) {
+          context_control.serial_port_exists = false;
+        }
+      };
+
+  adapter.start();
+
+  std::this_thread::sleep_for(long_time);
+
+  // `addBus` has returned before the start failed. The bus never connected,
+  // so the port has been handed back without a `cancelBus`.
+  EXPECT_EQ(adapter.add_bus_called, 1);
+  EXPECT_EQ(adapter.cancel_bus_called, 0);
+  EXPECT_EQ(registration_called, 0);
+
+  // Once the port is back, the bus is found again
+  context_control.serial_port_exists = true;
+  std::this_thread::sleep_for(long_time);
+
+  EXPECT_EQ(adapter.add_bus_called, 2);
+  EXPECT_EQ(adapter.cancel_bus_called, 0);
+  EXPECT_EQ(registration_called, 1);
+
+  adapter.stop();
+
+  EXPECT_EQ(registration_called, 1);
+  EXPECT_EQ(deregistration_called, 1);
+}
+
+// Hands the bus to `adapter` directly, as `PortFinder` does after finding it
+struct ModbusTechnologyAdapterImplementationAddBusTests
+    : public ModbusTechnologyAdapterImplementationTests {
+
+  Config::Bus::NonemptyPtr bus = Config::BusesOfJson(buses_config_json).at(0);
+
+  ModbusTechnologyAdapterImplementationAddBusTests() {
+    context_control.setDevice(port_name, device_id,
+        LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
+  }
+
+  void addBus() { adapter.addBus(bus, port_name, Verification::None, nullptr); }
+};
+
+TEST_F(
+    ModbusTechnologyAdapterImplementationAddBusTests, stopWaitsForPendingStart) {
+
+  std::atomic<bool> registering = false;
+  std::atomic<bool> registered = false;
+  registration_callback = [&registering, &registered](ReadFunction const&) {
+    registering = true;
+    std::this_thread::sleep_for(long_time);
+    registered = true;
+  };
+
+  addBus();
+  for (size_t i = 0; (i < 1000) && !registering; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_TRUE(registering);
+
+  adapter.stop();
+
+  // `stop` has waited for the start and then stopped the started bus
+  EXPECT_TRUE(registered);
+  EXPECT_EQ(registration_called, 1);
+  EXPECT_EQ(deregistration_called, 1);
+}
+
+TEST_F(ModbusTechnologyAdapterImplementationAddBusTests, stopRacesPostedStart) {
+  for (size_t i = 1; i <= 20; ++i) {
+    addBus();
+    adapter.stop();
+
+    // The posted start has not been dropped, and its bus has been stopped
+    EXPECT_EQ(registration_called, i);
+    EXPECT_EQ(deregistration_called, i);
+  }
+  EXPECT_EQ(adapter.cancel_bus_called, 0);
+}
+
 struct ModbusTechnologyAdapterImplementationTestsWithUnknownRegister
     : public ModbusTechnologyAdapterImplementationTestsBase {
 
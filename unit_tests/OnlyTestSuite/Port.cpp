@@ -1,4 +1,7 @@
+#include <atomic>
+#include <cerrno>
 #include <chrono>
+#include <list>
 
 #include "gtest/gtest.h"
 
@@ -47,12 +50,14 @@ PortFinderPlan::Candidate candidate( //
 
 struct PortTests : public testing::Test {
   VirtualContextControl context_control;
+  WorkerPool executor{"port tests", 2};
 };
 
 TEST_F(PortTests, findsDevice) {
   auto found = Nonempty::Pointer<Threadsafe::SharedPtr<bool>>::make(false);
 
-  auto success_callback = [found](PortFinderPlan::Candidate const& candidate) {
+  auto success_callback = [found](PortFinderPlan::Candidate const& candidate,
+                              ModbusContext::Ptr const&) {
     *found = true;
     EXPECT_EQ(candidate.getBus()->id, device_id);
     EXPECT_EQ(candidate.getPort(), port_name);
@@ -61,7 +66,8 @@ TEST_F(PortTests, findsDevice) {
   context_control.setDevice(port_name, device_id,
       LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
 
-  Port port(context_control.factory(), port_name, success_callback);
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
   port.addCandidate(candidate( //
       std::vector<DeviceSpec>{{device_id, 10, {{2, 3}, {5, 5}}, {}}}, //
       device_id, port_name));
@@ -74,14 +80,16 @@ TEST_F(PortTests, findsDevice) {
 TEST_F(PortTests, rejectsWrongRegisterType) {
   auto found = Nonempty::Pointer<Threadsafe::SharedPtr<bool>>::make(false);
 
-  auto success_callback = [found](PortFinderPlan::Candidate const&) {
+  auto success_callback = [found](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) {
     *found = true;
   };
 
   context_control.setDevice(port_name, device_id,
       LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
 
-  Port port(context_control.factory(), port_name, success_callback);
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
   port.addCandidate(candidate( //
       std::vector<DeviceSpec>{{device_id, 10, {}, {{2, 3}, {5, 5}}}}, //
       device_id, port_name));
@@ -94,14 +102,16 @@ TEST_F(PortTests, rejectsWrongRegisterType) {
 TEST_F(PortTests, rejectsExtraRegisters) {
   auto found = Nonempty::Pointer<Threadsafe::SharedPtr<bool>>::make(false);
 
-  auto success_callback = [found](PortFinderPlan::Candidate const&) {
+  auto success_callback = [found](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) {
     *found = true;
   };
 
   context_control.setDevice(port_name, device_id,
       LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
 
-  Port port(context_control.factory(), port_name, success_callback);
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
   port.addCandidate(
       candidate({{device_id, 10, {{2, 5}}, {}}}, device_id, port_name));
 
@@ -110,12 +120,55 @@ TEST_F(PortTests, rejectsExtraRegisters) {
   EXPECT_FALSE(*found);
 }
 
+TEST_F(PortTests, findsDeviceWithBursts) {
+  auto found = Nonempty::Pointer<Threadsafe::SharedPtr<bool>>::make(false);
+
+  auto success_callback = [found](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) {
+    *found = true;
+  };
+
+  context_control.setDevice(port_name, device_id,
+      LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
+
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
+  port.addCandidate(candidate( //
+      {{device_id, 10, {{2, 3}, {5, 5}}, {}, 2}}, device_id, port_name));
+
+  std::this_thread::sleep_for(long_time);
+
+  EXPECT_TRUE(*found);
+}
+
+TEST_F(PortTests, rejectsExtraRegistersInBurst) {
+  auto found = Nonempty::Pointer<Threadsafe::SharedPtr<bool>>::make(false);
+
+  auto success_callback = [found](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) {
+    *found = true;
+  };
+
+  context_control.setDevice(port_name, device_id,
+      LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
+
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
+  port.addCandidate(
+      candidate({{device_id, 10, {{2, 5}}, {}, 4}}, device_id, port_name));
+
+  std::this_thread::sleep_for(long_time);
+
+  EXPECT_FALSE(*found);
+}
+
 TEST_F(PortTests, findsAmongFailing) {
   // We use all candidates from the previous tests
 
   auto found = Nonempty::Pointer<Threadsafe::SharedPtr<bool>>::make(false);
 
-  auto success_callback = [found](PortFinderPlan::Candidate const& candidate) {
+  auto success_callback = [found](PortFinderPlan::Candidate const& candidate,
+                              ModbusContext::Ptr const&) {
     *found = true;
     EXPECT_EQ(candidate.getBus()->id, device_id);
     EXPECT_EQ(candidate.getPort(), port_name);
@@ -124,7 +177,8 @@ TEST_F(PortTests, findsAmongFailing) {
   context_control.setDevice(port_name, device_id,
       LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
 
-  Port port(context_control.factory(), port_name, success_callback);
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
   port.addCandidate(candidate( //
       {{device_id, 10, {}, {{2, 3}, {5, 5}}}}, device_id, port_name));
   port.addCandidate(
@@ -141,7 +195,8 @@ TEST_F(PortTests, findsAmongFailing) {
 TEST_F(PortTests, findsUnreliableDeviceEventually) {
   auto found = Nonempty::Pointer<Threadsafe::SharedPtr<bool>>::make(false);
 
-  auto success_callback = [found](PortFinderPlan::Candidate const& candidate) {
+  auto success_callback = [found](PortFinderPlan::Candidate const& candidate,
+                              ModbusContext::Ptr const&) {
     *found = true;
     EXPECT_EQ(candidate.getBus()->id, device_id);
     EXPECT_EQ(candidate.getPort(), port_name);
@@ -150,7 +205,8 @@ TEST_F(PortTests, findsUnreliableDeviceEventually) {
   context_control.setDevice(port_name, device_id,
       LibModbus::ReadableRegisterType::InputRegister, 0, Quality::UNRELIABLE);
 
-  Port port(context_control.factory(), port_name, success_callback);
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
   port.addCandidate(
       candidate({{device_id, 10, {}, {{2, 3}, {5, 5}}}}, device_id, port_name));
 
@@ -162,7 +218,8 @@ TEST_F(PortTests, findsUnreliableDeviceEventually) {
 TEST_F(PortTests, findsNoisyDeviceEventually) {
   auto found = Nonempty::Pointer<Threadsafe::SharedPtr<bool>>::make(false);
 
-  auto success_callback = [found](PortFinderPlan::Candidate const& candidate) {
+  auto success_callback = [found](PortFinderPlan::Candidate const& candidate,
+                              ModbusContext::Ptr const&) {
     *found = true;
     EXPECT_EQ(candidate.getBus()->id, device_id);
     EXPECT_EQ(candidate.getPort(), port_name);
@@ -171,7 +228,8 @@ TEST_F(PortTests, findsNoisyDeviceEventually) {
   context_control.setDevice(port_name, device_id,
       LibModbus::ReadableRegisterType::InputRegister, 0, Quality::NOISY);
 
-  Port port(context_control.factory(), port_name, success_callback);
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
   port.addCandidate(
       candidate({{device_id, 10, {}, {{2, 3}, {5, 5}}}}, device_id, port_name));
 
@@ -183,7 +241,8 @@ TEST_F(PortTests, findsNoisyDeviceEventually) {
 TEST_F(PortTests, findsRepeatedly) {
   auto found = Nonempty::Pointer<Threadsafe::SharedPtr<size_t>>::make(0);
 
-  auto success_callback = [found](PortFinderPlan::Candidate const& candidate) {
+  auto success_callback = [found](PortFinderPlan::Candidate const& candidate,
+                              ModbusContext::Ptr const&) {
     ++*found;
     EXPECT_EQ(candidate.getBus()->id, device_id);
     EXPECT_EQ(candidate.getPort(), port_name);
@@ -192,7 +251,8 @@ TEST_F(PortTests, findsRepeatedly) {
   context_control.setDevice(port_name, device_id,
       LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
 
-  Port port(context_control.factory(), port_name, success_callback);
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
 
   for (size_t i = 1; i < 5; ++i) {
     port.addCandidate(candidate(
@@ -205,6 +265,395 @@ TEST_F(PortTests, findsRepeatedly) {
   }
 }
 
+TEST_F(PortTests, waitsForNodeIfWatched) {
+  auto found = Nonempty::Pointer<Threadsafe::SharedPtr<bool>>::make(false);
+
+  auto success_callback = [found](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) {
+    *found = true;
+  };
+
+  context_control.serial_port_exists = false;
+  context_control.setDevice(port_name, device_id,
+      LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
+
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), true);
+  port.addCandidate(candidate( //
+      {{device_id, 10, {{2, 3}, {5, 5}}, {}}}, device_id, port_name));
+
+  std::this_thread::sleep_for(long_time);
+  context_control.serial_port_exists = true;
+
+  // Without notification, the port is not tried again
+  std::this_thread::sleep_for(long_time * 2);
+  EXPECT_FALSE(*found);
+
+  port.nodeAppeared();
+  std::this_thread::sleep_for(long_time);
+  EXPECT_TRUE(*found);
+}
+
+TEST_F(PortTests, retriesUnavailablePortIfWatched) {
+  auto found = Nonempty::Pointer<Threadsafe::SharedPtr<bool>>::make(false);
+
+  auto success_callback = [found](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) {
+    *found = true;
+  };
+
+  // The node exists, but is busy. No notification will come when it is freed
+  context_control.connect_error = EBUSY;
+  context_control.setDevice(port_name, device_id,
+      LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
+
+  ProbeSchedule schedule(std::chrono::milliseconds(20),
+      std::chrono::milliseconds(20), 0, std::chrono::milliseconds(0));
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      schedule, true);
+  port.addCandidate(candidate( //
+      {{device_id, 10, {{2, 3}, {5, 5}}, {}}}, device_id, port_name));
+
+  std::this_thread::sleep_for(long_time);
+  EXPECT_FALSE(*found);
+  context_control.connect_error = 0;
+
+  std::this_thread::sleep_for(long_time);
+  EXPECT_TRUE(*found);
+}
+
+TEST_F(PortTests, pollsForNodeIfNotWatched) {
+  auto found = Nonempty::Pointer<Threadsafe::SharedPtr<bool>>::make(false);
+
+  auto success_callback = [found](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) {
+    *found = true;
+  };
+
+  context_control.serial_port_exists = false;
+  context_control.setDevice(port_name, device_id,
+      LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
+
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
+  port.addCandidate(candidate( //
+      {{device_id, 10, {{2, 3}, {5, 5}}, {}}}, device_id, port_name));
+
+  std::this_thread::sleep_for(long_time);
+  context_control.serial_port_exists = true;
+
+  std::this_thread::sleep_for(long_time * 2);
+  EXPECT_TRUE(*found);
+}
+
+TEST_F(PortTests, backsOffUnsuccessfulCandidates) {
+  auto success_callback = [](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) {};
+
+  // The device has only input registers, hence the candidate fails
+  context_control.setDevice(port_name, device_id,
+      LibModbus::ReadableRegisterType::InputRegister, 0, Quality::PERFECT);
+
+  ProbeSchedule schedule(std::chrono::seconds(10), std::chrono::seconds(10),
+      0.5, std::chrono::milliseconds(0));
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      schedule, true);
+  port.addCandidate(candidate( //
+      {{device_id, 10, {{2, 3}, {5, 5}}, {}}}, device_id, port_name));
+
+  std::this_thread::sleep_for(long_time);
+
+  auto scheduled = port.schedule();
+  ASSERT_EQ(scheduled.size(), 1);
+  EXPECT_EQ(scheduled.at(0).failures, 1);
+  auto next_attempt = scheduled.at(0).next_attempt;
+  EXPECT_GE(next_attempt, Port::Clock::now() + std::chrono::seconds(4));
+
+  // Hot-plugging resets the back-off, and the candidate is tried right away
+  port.nodeAppeared();
+  std::this_thread::sleep_for(long_time);
+
+  scheduled = port.schedule();
+  ASSERT_EQ(scheduled.size(), 1);
+  EXPECT_EQ(scheduled.at(0).failures, 1);
+  // The back-off is random, but it is a new one
+  EXPECT_NE(scheduled.at(0).next_attempt, next_attempt);
+}
+
+TEST_F(PortTests, capsAttemptRate) {
+  auto success_callback = [](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) {};
+
+  context_control.setDevice(port_name, device_id,
+      LibModbus::ReadableRegisterType::InputRegister, 0, Quality::PERFECT);
+
+  ProbeSchedule schedule(std::chrono::milliseconds(0),
+      std::chrono::milliseconds(0), 0, long_time / 4);
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      schedule, true);
+  port.addCandidate(candidate( //
+      {{device_id, 10, {{2, 3}, {5, 5}}, {}}}, device_id, port_name));
+
+  std::this_thread::sleep_for(long_time);
+
+  auto scheduled = port.schedule();
+  ASSERT_EQ(scheduled.size(), 1);
+  EXPECT_GE(scheduled.at(0).failures, 1);
+  EXPECT_LE(scheduled.at(0).failures, 5);
+}
+
+TEST_F(PortTests, passesDetectionRounds) {
+  auto success_callback = [](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) {};
+
+  context_control.setDevice(port_name, device_id,
+      LibModbus::ReadableRegisterType::InputRegister, 0, Quality::PERFECT);
+
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), true);
+  port.addCandidate(candidate( //
+      {{device_id, 10, {{2, 3}, {5, 5}}, {}}}, device_id, port_name));
+
+  std::this_thread::sleep_for(long_time);
+
+  // Each round of unsuccessful attempts counts
+  EXPECT_GT(context_control.max_detection_round, 1);
+}
+
+TEST_F(PortTests, keepsPortOpenAcrossCandidates) {
+  auto connection = Nonempty::Pointer<
+      Threadsafe::SharedPtr<ModbusContext::Ptr>>::make(nullptr);
+
+  auto success_callback = [connection](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const& connection_) {
+    *connection = connection_;
+  };
+
+  context_control.setDevice(port_name, device_id,
+      LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
+
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
+
+  // Both candidates have the same serial settings
+  port.addCandidate(candidate( //
+      {{"Another device", 11, {{2, 3}, {5, 5}}, {}}}, "Another device",
+      port_name));
+  port.addCandidate(candidate( //
+      {{device_id, 10, {{2, 3}, {5, 5}}, {}}}, device_id, port_name));
+
+  std::this_thread::sleep_for(long_time);
+
+  // The successful context is passed on rather than closed
+  ASSERT_NE(*connection, nullptr);
+  EXPECT_EQ(context_control.num_connects, 1);
+}
+
+TEST_F(PortTests, identifiesDevice) {
+  auto found = Nonempty::Pointer<Threadsafe::SharedPtr<bool>>::make(false);
+  auto success_callback = [found](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) { *found = true; };
+
+  // The registers would not match, but identification spares reading them
+  context_control.setDevice(port_name, device_id,
+      LibModbus::ReadableRegisterType::InputRegister, 0, Quality::PERFECT);
+  context_control.setIdentification(
+      port_name, device_id, {"ACME", "Meter 3000", "v1.2", ""});
+
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
+  port.addCandidate(candidate( //
+      {{device_id, 10, {{2, 3}, {5, 5}}, {}, 1,
+          Config::Identification{"ACME", "Meter 3000", ""}}},
+      device_id, port_name));
+
+  std::this_thread::sleep_for(long_time);
+
+  EXPECT_TRUE(*found);
+  EXPECT_EQ(context_control.num_reads, 0);
+}
+
+TEST_F(PortTests, rejectsWrongIdentification) {
+  auto found = Nonempty::Pointer<Threadsafe::SharedPtr<bool>>::make(false);
+  auto success_callback = [found](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) { *found = true; };
+
+  // The registers would match, but the device is a different one
+  context_control.setDevice(port_name, device_id,
+      LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
+  context_control.setIdentification(
+      port_name, device_id, {"ACME", "Meter 2000", "v1.2", ""});
+
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
+  port.addCandidate(candidate( //
+      {{device_id, 10, {{2, 3}, {5, 5}}, {}, 1,
+          Config::Identification{"ACME", "Meter 3000", ""}}},
+      device_id, port_name));
+
+  std::this_thread::sleep_for(long_time);
+
+  EXPECT_FALSE(*found);
+  EXPECT_EQ(context_control.num_reads, 0);
+}
+
+TEST_F(PortTests, fallsBackToRegistersWithoutIdentification) {
+  auto found = Nonempty::Pointer<Threadsafe::SharedPtr<bool>>::make(false);
+  auto success_callback = [found](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) { *found = true; };
+
+  // The device does not support identification
+  context_control.setDevice(port_name, device_id,
+      LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
+
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
+  port.addCandidate(candidate( //
+      {{device_id, 10, {{2, 3}, {5, 5}}, {}, 1,
+          Config::Identification{"ACME", "Meter 3000", ""}}},
+      device_id, port_name));
+
+  std::this_thread::sleep_for(long_time);
+
+  EXPECT_TRUE(*found);
+  EXPECT_GT(context_control.num_reads, 0);
+}
+
+/*
+  Candidates for two buses on `port_name` which have the same registers and
+  are told apart only by identification
+*/
+PortFinderPlan::NewCandidates identifiedOnly() {
+  auto plan = PortFinderPlan::make();
+  auto candidates = plan->addBuses({
+      specToConfig(BusSpec({port_name},
+          {{device_id, 10, {{2, 3}, {5, 5}}, {}, 1,
+              Config::Identification{"ACME", "Meter 3000", ""}}})),
+      specToConfig(BusSpec({port_name},
+          {{"Another device", 10, {{2, 3}, {5, 5}}, {}, 1,
+              Config::Identification{"ACME", "Sensor 100", ""}}})),
+  });
+  EXPECT_EQ(candidates.size(), 2);
+  return candidates;
+}
+
+TEST_F(PortTests, requiresIdentificationWhereRegistersAreAmbiguous) {
+  auto found = Nonempty::Pointer<Threadsafe::SharedPtr<bool>>::make(false);
+  auto success_callback = [found](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) { *found = true; };
+
+  // The registers would match either bus
+  context_control.setDevice(port_name, device_id,
+      LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
+
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
+  for (auto const& candidate : identifiedOnly()) {
+    port.addCandidate(candidate);
+  }
+
+  std::this_thread::sleep_for(long_time);
+
+  EXPECT_FALSE(*found);
+  EXPECT_EQ(context_control.num_reads, 0);
+}
+
+TEST_F(PortTests, requiresReadDeviceIdentificationWhereRegistersAreAmbiguous) {
+  auto found = Nonempty::Pointer<Threadsafe::SharedPtr<bool>>::make(false);
+  auto success_callback = [found](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) { *found = true; };
+
+  // The server ID would match either bus
+  context_control.setDevice(port_name, device_id,
+      LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
+  context_control.setIdentification(
+      port_name, device_id, {"", "", "", "ACME Meter 3000 / Sensor 100"});
+
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
+  for (auto const& candidate : identifiedOnly()) {
+    port.addCandidate(candidate);
+  }
+
+  std::this_thread::sleep_for(long_time);
+
+  EXPECT_FALSE(*found);
+  EXPECT_EQ(context_control.num_reads, 0);
+}
+
+TEST_F(PortTests, stopsDuringPendingRead) {
+  auto success_callback = [](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) {};
+
+  // No device is set, so reads block until they time out
+  context_control.response_timeout = std::chrono::seconds(10);
+
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      ProbeSchedule(), false);
+  port.addCandidate(candidate( //
+      {{device_id, 10, {{2, 3}, {5, 5}}, {}}}, device_id, port_name));
+
+  std::this_thread::sleep_for(long_time / 2);
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(port.assign());
+  EXPECT_LT(std::chrono::steady_clock::now() - start, long_time);
+}
+
+TEST_F(PortTests, stopsDuringDelay) {
+  auto success_callback = [](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) {};
+
+  context_control.setDevice(port_name, device_id,
+      LibModbus::ReadableRegisterType::InputRegister, 0, Quality::PERFECT);
+
+  // After the first attempt, the next step is delayed by the rate cap
+  ProbeSchedule schedule(std::chrono::milliseconds(0),
+      std::chrono::milliseconds(0), 0, std::chrono::seconds(10));
+  Port port(context_control.factory(), port_name, success_callback, executor,
+      schedule, false);
+  port.addCandidate(candidate( //
+      {{device_id, 10, {{2, 3}, {5, 5}}, {}}}, device_id, port_name));
+
+  std::this_thread::sleep_for(long_time / 2);
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(port.assign());
+  EXPECT_LT(std::chrono::steady_clock::now() - start, long_time);
+}
+
+TEST_F(PortTests, manyPortsShareOneThread) {
+  constexpr size_t num_ports = 20;
+  auto found =
+      Nonempty::Pointer<Threadsafe::SharedPtr<std::atomic<size_t>>>::make(0);
+
+  auto success_callback = [found](PortFinderPlan::Candidate const&,
+                              ModbusContext::Ptr const&) {
+    ++*found;
+  };
+
+  WorkerPool single_thread("single thread", 1);
+  std::vector<std::string> port_names;
+  for (size_t i = 0; i < num_ports; ++i) {
+    port_names.push_back("Port " + std::to_string(i));
+    context_control.setDevice(port_names.back().c_str(), device_id,
+        LibModbus::ReadableRegisterType::HoldingRegister, 0, Quality::PERFECT);
+  }
+
+  std::list<Port> ports;
+  for (auto const& name : port_names) {
+    ConstString::ConstString port(name);
+    ports.emplace_back(
+        context_control.factory(), port, success_callback, single_thread, ProbeSchedule(), false);
+    ports.back().addCandidate(candidate(
+        {{device_id, 10, {{2, 3}, {5, 5}}, {}}}, device_id, port));
+  }
+
+  std::this_thread::sleep_for(long_time);
+
+  EXPECT_EQ(*found, num_ports);
+}
+
 // NOLINTEND(cert-err58-cpp, readability-magic-numbers))
 
 } // namespace ModbusTechnologyAdapterTests::PortTests
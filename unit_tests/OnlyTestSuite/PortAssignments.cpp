@@ -0,0 +1,70 @@
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include "internal/PortAssignments.hpp"
+
+#include "Specs.hpp"
+
+namespace ModbusTechnologyAdapterTests::PortAssignmentsTests {
+
+using namespace Technology_Adapter::Modbus;
+using namespace SpecsForTests;
+
+// NOLINTBEGIN(cert-err58-cpp)
+
+std::string const state_file = "port_assignments_test.json";
+
+struct PortAssignmentsTests : public testing::Test {
+  Config::Bus::NonemptyPtr bus1 =
+      specToConfig(BusSpec({"port1", "port2"}, {{"device1", 1, {}, {}}}));
+  Config::Bus::NonemptyPtr bus2 =
+      specToConfig(BusSpec({"port1", "port2"}, {{"device2", 2, {}, {}}}));
+
+  void SetUp() final { std::remove(state_file.c_str()); }
+  void TearDown() final { std::remove(state_file.c_str()); }
+};
+
+TEST_F(PortAssignmentsTests, startsEmpty) {
+  PortAssignments assignments(state_file);
+  EXPECT_FALSE(assignments.lookup(*bus1).has_value());
+}
+
+TEST_F(PortAssignmentsTests, persists) {
+  {
+    PortAssignments assignments(state_file);
+    assignments.remember(*bus1, "port2");
+    assignments.remember(*bus2, "port2");
+    assignments.remember(*bus2, "port1");
+    EXPECT_EQ(assignments.lookup(*bus1), Config::Portname("port2"));
+  }
+
+  PortAssignments assignments(state_file);
+  EXPECT_EQ(assignments.lookup(*bus1), Config::Portname("port2"));
+  EXPECT_EQ(assignments.lookup(*bus2), Config::Portname("port1"));
+}
+
+TEST_F(PortAssignmentsTests, ignoresMalformedFile) {
+  {
+    std::ofstream output_stream(state_file);
+    output_stream << "not json";
+  }
+
+  PortAssignments assignments(state_file);
+  EXPECT_FALSE(assignments.lookup(*bus1).has_value());
+
+  assignments.remember(*bus1, "port1");
+  EXPECT_EQ(
+      PortAssignments(state_file).lookup(*bus1), Config::Portname("port1"));
+}
+
+TEST_F(PortAssignmentsTests, disabled) {
+  PortAssignments assignments("");
+  assignments.remember(*bus1, "port1");
+  EXPECT_FALSE(assignments.lookup(*bus1).has_value());
+}
+
+// NOLINTEND(cert-err58-cpp)
+
+} // namespace ModbusTechnologyAdapterTests::PortAssignmentsTests
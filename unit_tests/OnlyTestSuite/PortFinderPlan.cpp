@@ -5,6 +5,10 @@
 #include "Specs.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
 
 namespace ModbusTechnologyAdapterTests::PortFinderPlanTests {
 
@@ -343,6 +347,109 @@ TEST_F(PortFinderPlanTests, twoBusesSubType) {
   checkFeasibility(candidates_2, {false, false});
 }
 
+/*
+  Equal registers, but identifications which no device can match both. Hence
+  neither bus ambiguates the other.
+*/
+TEST_F(PortFinderPlanTests, twoBusesUniqueIdentification) {
+  auto candidates = addBuses(
+      {
+          {
+              {port1, port2},
+              {{device1, 1, {{1, 1}}, {}, 1,
+                  Config::Identification{"Acme", "Meter", ""}}},
+          },
+          {
+              {port1, port2},
+              {{device2, 1, {{1, 1}}, {}, 1,
+                  Config::Identification{"Acme", "Sensor", ""}}},
+          },
+      },
+      {
+          {device1, port1},
+          {device1, port2},
+
+          {device2, port1},
+          {device2, port2},
+      });
+
+  confirm(candidates.at(3), {});
+  checkFeasibility(candidates, {true, false, false, false});
+
+  confirm(candidates.at(0), {});
+  checkFeasibility(candidates, {false, false, false, false});
+}
+
+// Empty strings match anything, so identifications must differ where both given
+TEST_F(PortFinderPlanTests, twoBusesCompatibleIdentification) {
+  addBuses(
+      {
+          {
+              {port1, port2},
+              {{device1, 1, {{1, 1}}, {}, 1,
+                  Config::Identification{"Acme", "Meter", ""}}},
+          },
+          {
+              {port1, port2},
+              {{device2, 1, {{1, 1}}, {}, 1,
+                  Config::Identification{"Acme", "", "2"}}},
+          },
+      },
+      {});
+}
+
+/*
+  A Report Server ID matches by substring, so a device reporting
+  "Acme Meter 3000" matches both identifications
+*/
+TEST_F(PortFinderPlanTests, twoBusesSubstringIdentification) {
+  addBuses(
+      {
+          {
+              {port1, port2},
+              {{device1, 1, {{1, 1}}, {}, 1,
+                  Config::Identification{"Acme", "Meter", ""}}},
+          },
+          {
+              {port1, port2},
+              {{device2, 1, {{1, 1}}, {}, 1,
+                  Config::Identification{"Acme", "Meter 3000", ""}}},
+          },
+      },
+      {});
+}
+
+// Only where registers cannot tell buses apart is identification required
+TEST_F(PortFinderPlanTests, identificationRequiredWithoutDistinguishingProbes) {
+  auto candidates = addBuses(
+      {
+          {
+              {port1},
+              {{device1, 1, {{1, 1}}, {}, 1,
+                  Config::Identification{"Acme", "Meter", ""}}},
+          },
+          {
+              {port1},
+              {{device2, 1, {{1, 1}}, {}, 1,
+                  Config::Identification{"Acme", "Sensor", ""}}},
+          },
+          {
+              {port1},
+              {{device3, 2, {{1, 1}}, {}, 1,
+                  Config::Identification{"Acme", "Meter", ""}}},
+          },
+      },
+      {
+          {device1, port1},
+          {device2, port1},
+          {device3, port1},
+      });
+
+  EXPECT_TRUE(candidates.at(0).probes().identification_required);
+  EXPECT_TRUE(candidates.at(1).probes().identification_required);
+  EXPECT_FALSE(candidates.at(2).probes().identification_required);
+}
+
 TEST_F(PortFinderPlanTests, mutuallyDistinguishableBuses) {
   auto candidates = addBuses(
       {
@@ -886,6 +993,202 @@ TEST_F(PortFinderPlanTests, unassignMultipleDevicesPerBus) {
   checkFeasibility(candidates_3, {false, false});
 }
 
+TEST_F(PortFinderPlanTests, probes) {
+  auto candidates = addBuses(
+      {
+          {
+              {port1},
+              {{device1, 1, {{1, 1}, {3, 3}}, {}}},
+          },
+          {
+              {port1},
+              {{device2, 1, {{1, 2}}, {}}},
+          },
+          {
+              {port1},
+              {{device3, 2, {}, {{5, 6}}}},
+          },
+      },
+      {{device1, port1}, {device2, port1}, {device3, port1}});
+
+  // `device1` is distinguished from `device2` by register 3
+  auto probes1 = candidates.at(0).probes();
+  ASSERT_EQ(probes1.liveness.size(), 1);
+  EXPECT_EQ(probes1.liveness.at(0).device->id, device1);
+  EXPECT_EQ(probes1.liveness.at(0).type,
+      LibModbus::ReadableRegisterType::HoldingRegister);
+  EXPECT_EQ(probes1.liveness.at(0).register_index, 1);
+  ASSERT_EQ(probes1.distinguishing.size(), 1);
+  EXPECT_EQ(probes1.distinguishing.at(0).register_index, 3);
+
+  // `device2` is distinguished from `device1` by register 2
+  auto probes2 = candidates.at(1).probes();
+  ASSERT_EQ(probes2.liveness.size(), 1);
+  ASSERT_EQ(probes2.distinguishing.size(), 1);
+  EXPECT_EQ(probes2.distinguishing.at(0).register_index, 2);
+
+  // `device3` has a slave id of its own
+  auto probes3 = candidates.at(2).probes();
+  ASSERT_EQ(probes3.liveness.size(), 1);
+  EXPECT_EQ(probes3.liveness.at(0).type,
+      LibModbus::ReadableRegisterType::InputRegister);
+  EXPECT_EQ(probes3.liveness.at(0).register_index, 5);
+  EXPECT_TRUE(probes3.distinguishing.empty());
+}
+
+TEST_F(PortFinderPlanTests, uncontested) {
+  auto candidates = addBuses(
+      {
+          {
+              {port1},
+              {{device1, 1, {{1, 1}}, {}}},
+          },
+          {
+              {port2, port3},
+              {{device2, 2, {{1, 1}}, {}}},
+          },
+          {
+              {port3},
+              {{device3, 3, {{1, 1}}, {}}},
+          },
+      },
+      {{device1, port1}, {device2, port2}, {device2, port3},
+          {device3, port3}});
+
+  EXPECT_TRUE(candidates.at(0).uncontested());
+
+  // `device2` has several possible ports
+  EXPECT_FALSE(candidates.at(1).uncontested());
+  EXPECT_FALSE(candidates.at(2).uncontested());
+
+  // `port3` is also possible for `device2`
+  EXPECT_FALSE(candidates.at(3).uncontested());
+}
+
+TEST_F(PortFinderPlanTests, patternsAndPossiblePorts) {
+  Config::Buses buses{
+      SpecsForTests::specToConfig(SpecsForTests::BusSpec({"/dev/ttyUSB*"}, {{device1, 1, {{1, 1}}, {}}})),
+  };
+
+  // Patterns are not ports
+  EXPECT_TRUE(plan->addBuses(buses).empty());
+
+  auto candidates = plan->addPossiblePort(buses.at(0), port1);
+  ASSERT_EQ(candidates.size(), 1);
+  EXPECT_EQ(candidates.at(0).getPort(), port1);
+  EXPECT_FALSE(candidates.at(0).uncontested());
+
+  // Adding the same port again has no effect
+  EXPECT_TRUE(plan->addPossiblePort(buses.at(0), port1).empty());
+
+  // Once the bus is assigned, further ports are no candidates
+  EXPECT_TRUE(candidates.at(0).confirm().empty());
+  EXPECT_TRUE(plan->addPossiblePort(buses.at(0), port2).empty());
+
+  // ... until it is unassigned
+  auto new_candidates = plan->unassign(port1);
+  EXPECT_EQ(new_candidates.size(), 2);
+}
+
+/*
+  `stillFeasible` is read concurrently with changes of the plan. Adding a port
+  to an assigned bus briefly counts it as an ambiguator before discounting it
+  again. Readers must not observe that.
+*/
+TEST_F(PortFinderPlanTests, concurrentFeasibility) {
+  constexpr size_t num_ports = 200;
+
+  auto portname = [](size_t port) -> Config::Portname {
+    return Config::Portname("port " + std::to_string(port));
+  };
+
+  Config::Buses buses{SpecsForTests::specToConfig(
+      SpecsForTests::BusSpec({portname(0)}, {{device1, 1, {{1, 2}}, {}}}))};
+  for (size_t i = 1; i <= num_ports; ++i) {
+    auto id = "device on " + std::to_string(i);
+    buses.push_back(SpecsForTests::specToConfig(SpecsForTests::BusSpec(
+        {portname(i)}, {{ConstString::ConstString(id), 1, {{1, 1}}, {}}})));
+  }
+  auto candidates = plan->addBuses(buses);
+  ASSERT_EQ(candidates.size(), num_ports + 1);
+  auto assigned = std::find_if(candidates.begin(), candidates.end(),
+      [&](auto const& candidate) { return candidate.getBus() == buses[0]; });
+  ASSERT_NE(assigned, candidates.end());
+  EXPECT_TRUE(assigned->confirm().empty());
+  candidates.erase(assigned);
+
+  std::atomic<bool> done = false;
+  std::atomic<size_t> num_infeasible = 0;
+  std::thread reader([&]() {
+    while (!done) {
+      for (auto const& candidate : candidates) {
+        if (!candidate.stillFeasible()) {
+          ++num_infeasible;
+        }
+      }
+    }
+  });
+  for (size_t i = 1; i <= num_ports; ++i) {
+    EXPECT_TRUE(plan->addPossiblePort(buses[0], portname(i)).empty());
+  }
+  done = true;
+  reader.join();
+  EXPECT_EQ(num_infeasible, 0);
+
+  // Once unassigned, `device1` ambiguates all others
+  plan->unassign(portname(0));
+  for (auto const& candidate : candidates) {
+    EXPECT_FALSE(candidate.stillFeasible());
+  }
+}
+
+/*
+  Many buses with overlapping slave ids spread over many ports, each bus
+  having several possible ports.
+
+  The candidates are checked against a naive computation of ambiguity.
+*/
+TEST_F(PortFinderPlanTests, matchesNaiveAmbiguity) {
+  constexpr size_t num_buses = 5000;
+  constexpr size_t num_ports = 200;
+
+  auto buses = SpecsForTests::manyBuses(num_buses, num_ports);
+  auto candidates = plan->addBuses(buses);
+
+  // naive `Bus` comparison, as in `PortFinderPlan` before indexing slave ids
+  auto ambiguates = [](Config::Bus const& larger, Config::Bus const& smaller) {
+    return std::all_of(smaller.devices.begin(), smaller.devices.end(),
+        [&larger](Config::Device::NonemptyPtr const& smaller_device) {
+          return std::any_of(larger.devices.begin(), larger.devices.end(),
+              [&smaller_device](Config::Device::NonemptyPtr const& device) {
+                return (device->slave_id == smaller_device->slave_id) &&
+                    (smaller_device->holding_registers <=
+                        device->holding_registers) &&
+                    (smaller_device->input_registers <=
+                        device->input_registers);
+              });
+        });
+  };
+
+  std::map<std::string, std::vector<size_t>> buses_by_port;
+  for (size_t i = 0; i < num_buses; ++i) {
+    for (auto const& port : buses[i]->possible_serial_ports) {
+      buses_by_port[std::string((std::string_view)port)].push_back(i);
+    }
+  }
+  size_t num_expected = 0;
+  for (auto const& [port, port_buses] : buses_by_port) {
+    for (auto bus : port_buses) {
+      num_expected += std::none_of(port_buses.begin(), port_buses.end(),
+          [&](size_t other) {
+            return (other != bus) && ambiguates(*buses[other], *buses[bus]);
+          });
+    }
+  }
+  EXPECT_EQ(candidates.size(), num_expected);
+  EXPECT_GT(num_expected, 0);
+}
+
 // NOLINTEND(cert-err58-cpp)
 // NOLINTEND(readability-magic-numbers)
 
@@ -0,0 +1,78 @@
+#include "gtest/gtest.h"
+
+#include "internal/ProbeCache.hpp"
+
+#include "Specs.hpp"
+
+namespace ModbusTechnologyAdapterTests::ProbeCacheTests {
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+using namespace Technology_Adapter::Modbus;
+using Result = ProbeCache::Result;
+
+constexpr auto holding = LibModbus::ReadableRegisterType::HoldingRegister;
+constexpr auto input = LibModbus::ReadableRegisterType::InputRegister;
+
+TEST(ProbeCacheTests, singleRegisters) {
+  ProbeCache cache;
+  auto& results = cache.forBus(
+      *SpecsForTests::specToConfig(SpecsForTests::BusSpec({"port"}, {})));
+
+  EXPECT_EQ(results.lookup(1, holding, 5), Result::Unknown);
+
+  results.recordReadable(1, holding, 5, 1);
+  results.recordUnreadable(1, holding, 6);
+  EXPECT_EQ(results.lookup(1, holding, 5), Result::Readable);
+  EXPECT_EQ(results.lookup(1, holding, 6), Result::Unreadable);
+
+  // other slaves, register types, and registers are unaffected
+  EXPECT_EQ(results.lookup(2, holding, 5), Result::Unknown);
+  EXPECT_EQ(results.lookup(1, input, 5), Result::Unknown);
+  EXPECT_EQ(results.lookup(1, holding, 7), Result::Unknown);
+}
+
+TEST(ProbeCacheTests, ranges) {
+  ProbeCache cache;
+  auto& results = cache.forBus(
+      *SpecsForTests::specToConfig(SpecsForTests::BusSpec({"port"}, {})));
+
+  results.recordReadable(1, input, 10, 3);
+  EXPECT_EQ(results.lookup(1, input, 10, 3), Result::Readable);
+  EXPECT_EQ(results.lookup(1, input, 11, 2), Result::Readable);
+  EXPECT_EQ(results.lookup(1, input, 12), Result::Readable);
+  EXPECT_EQ(results.lookup(1, input, 10, 4), Result::Unknown);
+
+  results.recordUnreadable(1, input, 13);
+  EXPECT_EQ(results.lookup(1, input, 10, 4), Result::Unreadable);
+  EXPECT_EQ(results.lookup(1, input, 9, 5), Result::Unreadable);
+}
+
+TEST(ProbeCacheTests, silentSlaves) {
+  ProbeCache cache;
+  auto& results = cache.forBus(
+      *SpecsForTests::specToConfig(SpecsForTests::BusSpec({"port"}, {})));
+
+  EXPECT_FALSE(results.silent(1));
+  results.recordSilent(1);
+  EXPECT_TRUE(results.silent(1));
+  EXPECT_FALSE(results.silent(2));
+}
+
+TEST(ProbeCacheTests, clear) {
+  ProbeCache cache;
+  auto const bus =
+      SpecsForTests::specToConfig(SpecsForTests::BusSpec({"port"}, {}));
+
+  cache.forBus(*bus).recordReadable(1, holding, 5, 1);
+  cache.forBus(*bus).recordSilent(2);
+  EXPECT_EQ(cache.forBus(*bus).lookup(1, holding, 5), Result::Readable);
+
+  cache.clear();
+  EXPECT_EQ(cache.forBus(*bus).lookup(1, holding, 5), Result::Unknown);
+  EXPECT_FALSE(cache.forBus(*bus).silent(2));
+}
+
+// NOLINTEND(readability-magic-numbers)
+
+} // namespace ModbusTechnologyAdapterTests::ProbeCacheTests
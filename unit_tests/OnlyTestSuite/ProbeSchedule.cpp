@@ -0,0 +1,67 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+#include "internal/ProbeSchedule.hpp"
+
+namespace ModbusTechnologyAdapterTests::ProbeScheduleTests {
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+using namespace Technology_Adapter::Modbus;
+using ms = std::chrono::milliseconds;
+
+TEST(ProbeScheduleTests, exponentialBackoff) {
+  ProbeSchedule schedule(ms(100), ms(1000), 0, ms(0));
+
+  EXPECT_EQ(schedule.backoff(0), ms(0));
+  EXPECT_EQ(schedule.backoff(1), ms(100));
+  EXPECT_EQ(schedule.backoff(2), ms(200));
+  EXPECT_EQ(schedule.backoff(4), ms(800));
+  EXPECT_EQ(schedule.backoff(5), ms(1000));
+  EXPECT_EQ(schedule.backoff(1000), ms(1000));
+
+  // Without jitter, back-offs are exact
+  EXPECT_EQ(schedule.randomBackoff(3), ms(400));
+}
+
+TEST(ProbeScheduleTests, jitter) {
+  ProbeSchedule schedule(ms(100), ms(1000), 0.5, ms(0));
+
+  EXPECT_EQ(schedule.minBackoff(2), ms(100));
+  for (int i = 0; i < 100; ++i) {
+    auto backoff = schedule.randomBackoff(2);
+    EXPECT_GE(backoff, ms(100));
+    EXPECT_LE(backoff, ms(200));
+  }
+}
+
+TEST(ProbeScheduleTests, steadyStateAttemptRate) {
+  EXPECT_TRUE(std::isinf(ProbeSchedule().steadyStateAttemptRate(1)));
+
+  ProbeSchedule backoff_only(ms(100), ms(1000), 0.5, ms(0));
+  EXPECT_DOUBLE_EQ(backoff_only.steadyStateAttemptRate(1), 2);
+  EXPECT_DOUBLE_EQ(backoff_only.steadyStateAttemptRate(10), 20);
+
+  // The cap applies to many candidates
+  ProbeSchedule capped(ms(100), ms(1000), 0.5, ms(200));
+  EXPECT_DOUBLE_EQ(capped.steadyStateAttemptRate(1), 2);
+  EXPECT_DOUBLE_EQ(capped.steadyStateAttemptRate(10), 5);
+}
+
+TEST(ProbeScheduleTests, fromConfig) {
+  Config::PortDetection config;
+  config.backoff_initial = 50;
+  config.backoff_max = 400;
+  config.backoff_jitter = 0;
+  config.min_attempt_interval = 20;
+  ProbeSchedule schedule(config);
+
+  EXPECT_EQ(schedule.backoff(1), ms(50));
+  EXPECT_EQ(schedule.backoff(10), ms(400));
+  EXPECT_EQ(schedule.minAttemptInterval(), ms(20));
+}
+
+// NOLINTEND(readability-magic-numbers)
+
+} // namespace ModbusTechnologyAdapterTests::ProbeScheduleTests
@@ -0,0 +1,69 @@
+#include "gtest/gtest.h"
+
+#include <thread>
+
+#include "internal/ReadCache.hpp"
+
+namespace ModbusTechnologyAdapterTests::ReadCacheTests {
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+using namespace Technology_Adapter::Modbus;
+using Kind = Config::CachePolicy::Kind;
+
+struct ReadCacheTests : public testing::Test {
+  size_t num_reads = 0;
+
+  // Reads the number of reads so far
+  Information_Model::DataVariant read() {
+    return (intmax_t)num_reads++;
+  }
+
+  intmax_t get(ReadCache& cache) {
+    return std::get<intmax_t>(cache.get([this]() { return read(); }));
+  }
+};
+
+TEST_F(ReadCacheTests, none) {
+  ReadCache cache({Kind::None, 0});
+  EXPECT_EQ(get(cache), 0);
+  EXPECT_EQ(get(cache), 1);
+  EXPECT_EQ(cache.counters().hits, 0);
+  EXPECT_EQ(cache.counters().misses, 2);
+}
+
+TEST_F(ReadCacheTests, constant) {
+  ReadCache cache({Kind::Constant, 0});
+  EXPECT_EQ(get(cache), 0);
+  EXPECT_EQ(get(cache), 0);
+  EXPECT_EQ(get(cache), 0);
+  EXPECT_EQ(num_reads, 1);
+  EXPECT_EQ(cache.counters().hits, 2);
+  EXPECT_EQ(cache.counters().misses, 1);
+}
+
+TEST_F(ReadCacheTests, ttl) {
+  ReadCache cache({Kind::Ttl, 20});
+  EXPECT_EQ(get(cache), 0);
+  EXPECT_EQ(get(cache), 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  EXPECT_EQ(get(cache), 1);
+  EXPECT_EQ(cache.counters().hits, 1);
+  EXPECT_EQ(cache.counters().misses, 2);
+}
+
+// A failed read leaves nothing behind to be served
+TEST_F(ReadCacheTests, throwingRead) {
+  ReadCache cache({Kind::Constant, 0});
+  auto failing = []() -> Information_Model::DataVariant {
+    throw std::runtime_error("unreachable");
+  };
+  EXPECT_THROW(cache.get(failing), std::runtime_error);
+  EXPECT_EQ(get(cache), 0);
+  EXPECT_EQ(get(cache), 0);
+  EXPECT_EQ(cache.counters().misses, 2);
+}
+
+// NOLINTEND(readability-magic-numbers)
+
+} // namespace ModbusTechnologyAdapterTests::ReadCacheTests
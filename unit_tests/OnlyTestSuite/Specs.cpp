@@ -1,5 +1,7 @@
 #include "Specs.hpp"
 
+#include <string>
+
 namespace ModbusTechnologyAdapterTests::SpecsForTests {
 
 using namespace Technology_Adapter::Modbus;
@@ -10,11 +12,11 @@ Config::Device::NonemptyPtr specToConfig(DeviceSpec&& device) {
   return Config::Device::NonemptyPtr::make( //
       device.id, device.id /* as `name` */, device.id /* as `description` */,
       std::vector<Config::Readable>(), std::vector<Config::Group>(),
-      device.slave_id, //
-      1 /* as `burst_size` */, //
+      device.slave_id, device.burst_size, //
       0 /* as max_retries */, //
       0 /* as retry_delay */, //
-      std::move(device.holding_registers), std::move(device.input_registers));
+      std::move(device.holding_registers), std::move(device.input_registers),
+      std::move(device.identification));
 }
 
 Config::Bus::NonemptyPtr specToConfig(BusSpec&& bus) {
@@ -24,7 +26,36 @@ Config::Bus::NonemptyPtr specToConfig(BusSpec&& bus) {
   }
   return Config::Bus::NonemptyPtr::make( //
       bus.possible_ports, 9600, LibModbus::Parity::None, 8, 2, //
-      0, 0, 0, 0, 0, devices);
+      0, 0, 0, 0, 0, 0, 0, 0, devices);
+}
+
+Config::Buses manyBuses(size_t num_buses, size_t num_ports) {
+  auto portname = [](size_t port) -> Config::Portname {
+    return Config::Portname("port " + std::to_string(port));
+  };
+
+  Config::Buses buses;
+  buses.reserve(num_buses);
+  for (size_t i = 0; i < num_buses; ++i) {
+    BusSpec::Devices devices;
+    for (size_t j = 0; j <= i % 3; ++j) {
+      auto id = "bus " + std::to_string(i) + " device " + std::to_string(j);
+      auto slave_id = (int)(1 + (i * 7 + j * 31) % 247);
+      auto last_register = (RegisterIndex)((i / 247 + j) % 10);
+      DeviceSpec::Registers input_registers;
+      if (j == 1) {
+        input_registers.emplace_back(0, (RegisterIndex)(i % 5));
+      }
+      devices.emplace_back(ConstString::ConstString(id), slave_id,
+          DeviceSpec::Registers{{0, last_register}},
+          std::move(input_registers));
+    }
+    buses.push_back(specToConfig(BusSpec(
+        {portname(i % num_ports), portname((i + 67) % num_ports),
+            portname((i + 133) % num_ports)},
+        std::move(devices))));
+  }
+  return buses;
 }
 
 // NOLINTEND(readability-magic-numbers)
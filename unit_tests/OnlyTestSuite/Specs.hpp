@@ -16,14 +16,19 @@ struct DeviceSpec {
   int slave_id;
   Registers holding_registers;
   Registers input_registers;
+  size_t burst_size;
+  std::optional<Config::Identification> identification;
 
   DeviceSpec() = delete;
   // NOLINTBEGIN(readability-identifier-naming)
   DeviceSpec(ConstString::ConstString id_, int slave_id_, //
-      Registers holding_registers_, Registers input_registers_)
+      Registers holding_registers_, Registers input_registers_,
+      size_t burst_size_ = 1,
+      std::optional<Config::Identification> identification_ = std::nullopt)
       : id(std::move(id_)), slave_id(slave_id_),
         holding_registers(std::move(holding_registers_)),
-        input_registers(std::move(input_registers_)) {}
+        input_registers(std::move(input_registers_)), burst_size(burst_size_),
+        identification(std::move(identification_)) {}
   // NOLINTEND(readability-identifier-naming)
 };
 
@@ -45,6 +50,12 @@ struct BusSpec {
 
 Config::Bus::NonemptyPtr specToConfig(BusSpec&&);
 
+/*
+  Many buses with overlapping slave ids spread over many ports, each bus
+  having three possible ports. For tests and benchmarks of `PortFinderPlan`.
+*/
+Config::Buses manyBuses(size_t num_buses, size_t num_ports);
+
 } // namespace ModbusTechnologyAdapterTests::SpecsForTests
 
 #endif // _MODBUS_TECHNOLOGY_ADAPTER_UNIT_TESTS_SPECS_HPP
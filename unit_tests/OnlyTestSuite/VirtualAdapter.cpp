@@ -7,7 +7,9 @@ void VirtualAdapter::stop() { ++stop_called; }
 
 void VirtualAdapter::addBus(
     Technology_Adapter::Modbus::Config::Bus::NonemptyPtr const&,
-    Technology_Adapter::Modbus::Config::Portname const&) {
+    Technology_Adapter::Modbus::Config::Portname const&,
+    Technology_Adapter::Modbus::Verification,
+    Technology_Adapter::Modbus::ModbusContext::Ptr const&) {
 
   ++add_bus_called;
 }
@@ -18,7 +18,9 @@ public:
   void stop() final;
 
   void addBus(Technology_Adapter::Modbus::Config::Bus::NonemptyPtr const&,
-      Technology_Adapter::Modbus::Config::Portname const& actual_port) final;
+      Technology_Adapter::Modbus::Config::Portname const& actual_port,
+      Technology_Adapter::Modbus::Verification,
+      Technology_Adapter::Modbus::ModbusContext::Ptr const&) final;
   void cancelBus(Technology_Adapter::Modbus::Config::Portname const&) final;
 };
 
@@ -1,6 +1,8 @@
 #include "VirtualContext.hpp"
 
+#include <optional>
 #include <random>
+#include <thread>
 
 namespace ModbusTechnologyAdapterTests::Virtual_Context {
 
@@ -15,14 +17,18 @@ std::uniform_int_distribution<> noise{0, 1}; // NOLINT(cert-err58-cpp)
 VirtualContext::VirtualContext(
     // NOLINTNEXTLINE(modernize-pass-by-value)
     Technology_Adapter::Modbus::Config::Portname const& port,
+    Technology_Adapter::Modbus::ModbusContext::Purpose purpose,
     VirtualContextControl* control)
-    : port_(port), control_(control) {}
+    : port_(port), purpose_(purpose), control_(control) {}
 
 void VirtualContext::connect() {
-  if (control_->serial_port_exists) {
-    connected_ = true;
-  } else {
+  if (!control_->serial_port_exists) {
     throwModbus(ENOENT);
+  } else if (control_->connect_error != 0) {
+    throwModbus(control_->connect_error);
+  } else {
+    connected_ = true;
+    ++control_->num_connects;
   }
 }
 
@@ -34,21 +40,90 @@ void VirtualContext::selectDevice(
   selected_device_ = device.id;
 }
 
+void VirtualContext::configure(
+    Technology_Adapter::Modbus::Config::Bus const&,
+    Technology_Adapter::Modbus::ModbusContext::Purpose purpose) {
+
+  purpose_ = purpose;
+}
+
+void VirtualContext::setCancellation(
+    LibModbus::Cancellation::Ptr cancellation) noexcept {
+
+  cancellation_ = std::move(cancellation);
+}
+
+Technology_Adapter::Modbus::ModbusContext::Purpose
+VirtualContext::purpose() const {
+  return purpose_;
+}
+
+void VirtualContext::setDetectionRound(size_t round) {
+  size_t previous = control_->max_detection_round;
+  while ((previous < round) &&
+      !control_->max_detection_round.compare_exchange_weak(previous, round)) {
+  }
+}
+
+void VirtualContext::timeOut() {
+  auto timeout = control_->response_timeout;
+  if (cancellation_ == nullptr) {
+    std::this_thread::sleep_for(timeout);
+  } else if (cancellation_->waitFor(timeout)) {
+    throwModbus(ECANCELED);
+  }
+  throwModbus(ETIMEDOUT);
+}
+
+LibModbus::DeviceIdentification VirtualContext::identify() {
+  if ((cancellation_ != nullptr) && cancellation_->cancelled()) {
+    throwModbus(ECANCELED);
+  }
+
+  std::optional<VirtualContextControl::Behaviour> behaviour;
+  {
+    auto devices_access = control_->devices_.lock();
+    auto device = devices_access->find(std::make_pair(port_, selected_device_));
+    if (device != devices_access->end()) {
+      behaviour = device->second;
+    }
+  }
+  if (!behaviour.has_value()) {
+    timeOut();
+  }
+  if (!behaviour->identification.has_value()) {
+    throwModbus(LibModbus::ModbusError::XILFUN);
+  }
+  return *behaviour->identification;
+}
+
 int VirtualContext::readRegisters(
     int addr, LibModbus::ReadableRegisterType type, int nb, uint16_t* buffer) {
 
-  auto devices_access = control_->devices_.lock();
-  auto device = devices_access->find(std::make_pair(port_, selected_device_));
-  if (device == devices_access->end()) {
+  ++control_->num_reads;
+
+  if ((cancellation_ != nullptr) && cancellation_->cancelled()) {
+    throwModbus(ECANCELED);
+  }
+
+  std::optional<VirtualContextControl::Behaviour> behaviour;
+  {
+    auto devices_access = control_->devices_.lock();
+    auto device = devices_access->find(std::make_pair(port_, selected_device_));
+    if (device != devices_access->end()) {
+      behaviour = device->second;
+    }
+  }
+  if (!behaviour.has_value()) {
     // The selected device does not exist, so will not respond
-    throwModbus(ETIMEDOUT);
+    timeOut();
   }
 
-  if (type != device->second.register_type) {
+  if (type != behaviour->register_type) {
     throwModbus(LibModbus::ModbusError::XILADD);
   }
 
-  switch (device->second.quality) {
+  switch (behaviour->quality) {
   case Quality::PERFECT:
     break;
   case Quality::UNRELIABLE:
@@ -82,7 +157,7 @@ int VirtualContext::readRegisters(
   // NOLINTEND(readability-magic-numbers)
 
   for (int i = 0; i < nb; ++i) {
-    buffer[i] = device->second.registers_value;
+    buffer[i] = behaviour->registers_value;
   }
   return nb;
 }
@@ -92,9 +167,9 @@ VirtualContextControl::factory() {
   return //
       [this](ConstString::ConstString const& port,
           Technology_Adapter::Modbus::Config::Bus const&,
-          Technology_Adapter::Modbus::ModbusContext::Purpose) {
+          Technology_Adapter::Modbus::ModbusContext::Purpose purpose) {
         //
-        return std::make_shared<VirtualContext>(port, this);
+        return std::make_shared<VirtualContext>(port, purpose, this);
       };
 }
 
@@ -105,11 +180,22 @@ void VirtualContextControl::setDevice( //
     Quality quality) {
 
   devices_.lock()->insert_or_assign(std::make_pair(port, device_id), //
-      Behaviour{register_type, registers_value, quality});
+      Behaviour{register_type, registers_value, quality, std::nullopt});
+}
+
+void VirtualContextControl::setIdentification( //
+    Technology_Adapter::Modbus::Config::Portname const& port,
+    ConstString::ConstString const& device_id,
+    LibModbus::DeviceIdentification identification) {
+
+  auto devices_access = devices_.lock();
+  devices_access->at(std::make_pair(port, device_id)).identification =
+      std::move(identification);
 }
 
 void VirtualContextControl::reset() {
   serial_port_exists = true;
+  response_timeout = std::chrono::milliseconds(0);
   devices_.lock()->clear();
 }
 
@@ -1,7 +1,10 @@
 #ifndef _MODBUS_TECHNOLOGY_ADAPTER_UNIT_TESTS_VIRTUAL_CONTEXT_HPP
 #define _MODBUS_TECHNOLOGY_ADAPTER_UNIT_TESTS_VIRTUAL_CONTEXT_HPP
 
+#include <atomic>
+#include <chrono>
 #include <map>
+#include <optional>
 
 #include "Threadsafe_Containers/PrivateResource.hpp"
 
@@ -26,6 +29,7 @@ public:
   VirtualContext() = delete;
   VirtualContext( //
       Technology_Adapter::Modbus::Config::Portname const&,
+      Technology_Adapter::Modbus::ModbusContext::Purpose,
       VirtualContextControl* control);
 
   void connect() final;
@@ -33,18 +37,45 @@ public:
   void selectDevice(Technology_Adapter::Modbus::Config::Device const&) final;
   int readRegisters(
       int addr, LibModbus::ReadableRegisterType, int nb, uint16_t*) final;
+  LibModbus::DeviceIdentification identify() final;
+  void setDetectionRound(size_t round) final;
+  void configure(Technology_Adapter::Modbus::Config::Bus const&,
+      Technology_Adapter::Modbus::ModbusContext::Purpose) final;
+  void setCancellation(LibModbus::Cancellation::Ptr) noexcept final;
+
+  Technology_Adapter::Modbus::ModbusContext::Purpose purpose() const;
 
 private:
+  // Throws like a device that does not respond
+  [[noreturn]] void timeOut();
+
   Technology_Adapter::Modbus::Config::Portname port_;
   bool connected_ = false;
   ConstString::ConstString selected_device_;
+  Technology_Adapter::Modbus::ModbusContext::Purpose purpose_;
   VirtualContextControl* control_;
+  LibModbus::Cancellation::Ptr cancellation_;
 };
 
 class VirtualContextControl {
 public:
   bool serial_port_exists = true;
 
+  // If not `0`, `connect` fails with this code although the port exists
+  std::atomic<int> connect_error = 0;
+
+  // How long reads from missing devices block before they time out
+  std::chrono::milliseconds response_timeout{0};
+
+  // The highest round passed to `setDetectionRound` so far
+  std::atomic<size_t> max_detection_round = 0;
+
+  // The number of successful `connect`s so far
+  std::atomic<size_t> num_connects = 0;
+
+  // The number of `readRegisters` calls so far
+  std::atomic<size_t> num_reads = 0;
+
   Technology_Adapter::Modbus::ModbusContext::Factory factory();
 
   // Adds or replaces the specs for a device.
@@ -55,6 +86,13 @@ public:
       ConstString::ConstString const& device_id,
       LibModbus::ReadableRegisterType, uint16_t registers_value, Quality);
 
+  // Lets a device set by `setDevice` identify itself as `identification`.
+  // Otherwise, it does not support identification.
+  void setIdentification( //
+      Technology_Adapter::Modbus::Config::Portname const&,
+      ConstString::ConstString const& device_id,
+      LibModbus::DeviceIdentification identification);
+
   void reset(); // Removes all device specs
 
 private:
@@ -62,6 +100,7 @@ private:
     LibModbus::ReadableRegisterType register_type;
     uint16_t registers_value;
     Quality quality;
+    std::optional<LibModbus::DeviceIdentification> identification;
   };
 
   // indexed by device id
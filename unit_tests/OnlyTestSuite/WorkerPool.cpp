@@ -0,0 +1,105 @@
+#include "internal/WorkerPool.hpp"
+
+#include <atomic>
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+namespace ModbusTechnologyAdapterTests::WorkerPoolTests {
+
+using namespace Technology_Adapter::Modbus;
+
+// NOLINTBEGIN(readability-magic-numbers)
+
+auto short_time = std::chrono::milliseconds(50);
+
+TEST(WorkerPoolTests, postedTasksRunBeforeDestruction) {
+  std::atomic<size_t> counter = 0;
+  {
+    WorkerPool pool("test pool", 2);
+    for (size_t i = 0; i < 20; ++i) {
+      pool.post([&counter]() { ++counter; });
+    }
+  }
+  EXPECT_EQ(counter, 20);
+}
+
+TEST(WorkerPoolTests, runAllWaitsForAllTasks) {
+  WorkerPool pool("test pool", 3);
+  std::atomic<size_t> counter = 0;
+  std::vector<WorkerPool::Task> tasks;
+  for (size_t i = 0; i < 10; ++i) {
+    tasks.emplace_back([&counter]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      ++counter;
+    });
+  }
+  pool.runAll(std::move(tasks));
+  EXPECT_EQ(counter, 10);
+}
+
+TEST(WorkerPoolTests, runAllIsConcurrent) {
+  WorkerPool pool("test pool", 3);
+  std::vector<WorkerPool::Task> tasks;
+  for (size_t i = 0; i < 4; ++i) {
+    tasks.emplace_back([]() { std::this_thread::sleep_for(short_time); });
+  }
+  auto start = std::chrono::steady_clock::now();
+  pool.runAll(std::move(tasks));
+  // 3 workers plus the caller
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 3 * short_time);
+}
+
+TEST(WorkerPoolTests, runAllFromWithinTask) {
+  WorkerPool pool("test pool", 1);
+  std::atomic<size_t> counter = 0;
+  std::atomic<bool> done = false;
+  pool.post([&pool, &counter, &done]() {
+    std::vector<WorkerPool::Task> tasks;
+    for (size_t i = 0; i < 5; ++i) {
+      tasks.emplace_back([&counter]() { ++counter; });
+    }
+    pool.runAll(std::move(tasks));
+    done = true;
+  });
+  auto deadline = std::chrono::steady_clock::now() + 20 * short_time;
+  while (!done && (std::chrono::steady_clock::now() < deadline)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(done);
+  EXPECT_EQ(counter, 5);
+}
+
+TEST(WorkerPoolTests, failingTaskDoesNotStopPool) {
+  WorkerPool pool("test pool", 1);
+  std::atomic<size_t> counter = 0;
+  std::vector<WorkerPool::Task> tasks;
+  tasks.emplace_back([]() { throw std::runtime_error("failing task"); });
+  tasks.emplace_back([&counter]() { ++counter; });
+  EXPECT_NO_THROW(pool.runAll(std::move(tasks)));
+  EXPECT_EQ(counter, 1);
+}
+
+TEST(WorkerPoolTests, expediteEndsDelay) {
+  WorkerPool pool("test pool", 1);
+  std::atomic<bool> done = false;
+  auto ticket = pool.postAfter(
+      std::chrono::seconds(10), [&done]() { done = true; });
+
+  EXPECT_TRUE(pool.expedite(ticket));
+  std::this_thread::sleep_for(short_time);
+  EXPECT_TRUE(done);
+
+  // The task is no longer delayed
+  EXPECT_FALSE(pool.expedite(ticket));
+}
+
+TEST(WorkerPoolTests, defaultSizeIsBounded) {
+  EXPECT_GE(WorkerPool::defaultSize(4), 1);
+  EXPECT_LE(WorkerPool::defaultSize(4), 4);
+  EXPECT_EQ(WorkerPool::defaultSize(1), 1);
+}
+
+// NOLINTEND(readability-magic-numbers)
+
+} // namespace ModbusTechnologyAdapterTests::WorkerPoolTests